@@ -188,6 +188,24 @@ check_cxx_source_compiles("
   }
 " HAVE_ISO_STRDUP)
 
+# Determine whether io_uring can be used by FilePrefetcher.
+
+if(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+  check_cxx_source_compiles("
+    #include <linux/io_uring.h>
+    #include <sys/syscall.h>
+    int main() {
+      return __NR_io_uring_setup + __NR_io_uring_enter + IORING_OP_READ;
+    }
+  " HAVE_LINUX_IO_URING)
+endif()
+
+# FilePrefetcher reads with POSIX file I/O.
+
+if(UNIX)
+  set(TAGLIB_WITH_PREFETCH 1)
+endif()
+
 # Determine whether zlib is installed.
 
 if(NOT ZLIB_SOURCE)
@@ -199,6 +217,10 @@ if(NOT ZLIB_SOURCE)
   endif()
 endif()
 
+# Find the thread library, which BatchScanner needs.
+
+find_package(Threads REQUIRED)
+
 # Determine whether CppUnit is installed.
 
 if(BUILD_TESTS AND NOT BUILD_SHARED_LIBS)
@@ -0,0 +1,151 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Scans all the files below the given directories with BatchScanner and
+// reports the throughput and the distribution of the time spent per file.
+// Run it with different thread and open file counts to find the best
+// settings for a given storage device.
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <tstringlist.h>
+#include <batchscanner.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  void addFiles(const std::string &path, StringList &files)
+  {
+    struct stat st;
+    if(::stat(path.c_str(), &st) != 0)
+      return;
+
+    if(!S_ISDIR(st.st_mode)) {
+      files.append(String(path, String::UTF8));
+      return;
+    }
+
+    DIR *dir = ::opendir(path.c_str());
+    if(!dir)
+      return;
+
+    std::vector<std::string> entries;
+    while(const dirent *entry = ::readdir(dir)) {
+      if(std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0)
+        entries.push_back(path + "/" + entry->d_name);
+    }
+    ::closedir(dir);
+
+    std::sort(entries.begin(), entries.end());
+    for(std::vector<std::string>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+      addFiles(*it, files);
+  }
+
+  class LatencyListener : public BatchScanner::Listener
+  {
+  public:
+    LatencyListener() :
+      failed(0) {}
+
+    virtual void fileScanned(const BatchScanner::Result &result)
+    {
+      times.push_back(result.scanTimeInMicroseconds());
+      if(!result.isValid())
+        ++failed;
+    }
+
+    std::vector<int> times;
+    unsigned long failed;
+  };
+
+  int percentile(const std::vector<int> &sorted, double p)
+  {
+    if(sorted.empty())
+      return 0;
+    return sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1))];
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int threads = 0;
+  unsigned int maxOpen = 0;
+  unsigned long count = 1;
+  bool audioProperties = true;
+  StringList files;
+
+  for(int i = 1; i < argc; ++i) {
+    if(std::strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+      threads = static_cast<unsigned int>(std::strtoul(argv[++i], 0, 10));
+    else if(std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      maxOpen = static_cast<unsigned int>(std::strtoul(argv[++i], 0, 10));
+    else if(std::strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      count = std::strtoul(argv[++i], 0, 10);
+    else if(std::strcmp(argv[i], "-t") == 0)
+      audioProperties = false;
+    else
+      addFiles(argv[i], files);
+  }
+
+  if(files.isEmpty() || count == 0) {
+    std::printf("usage: %s [-j threads] [-o max open files] [-n count] [-t] path...\n", argv[0]);
+    std::printf("  -t  read the tags only, not the audio properties\n");
+    return 1;
+  }
+
+  BatchScanner scanner;
+  scanner.setThreadCount(threads);
+  scanner.setMaxOpenFiles(maxOpen);
+  scanner.setReadAudioProperties(audioProperties);
+
+  LatencyListener listener;
+  Timer timer;
+
+  for(unsigned long i = 0; i < count; ++i)
+    scanner.scan(files, &listener);
+
+  const double seconds = timer.seconds();
+
+  std::sort(listener.times.begin(), listener.times.end());
+
+  std::printf("%u threads, %u open files, %lu files, %lu not read\n",
+              scanner.threadCount(), scanner.maxOpenFiles(),
+              static_cast<unsigned long>(listener.times.size()), listener.failed);
+  printResult("scan", seconds, static_cast<double>(listener.times.size()), "files");
+  std::printf("per file: p50 %d us, p90 %d us, p99 %d us, max %d us\n",
+              percentile(listener.times, 0.5), percentile(listener.times, 0.9),
+              percentile(listener.times, 0.99), percentile(listener.times, 1.0));
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Creates the frames of synthetic ID3v2.4 and ID3v2.2 tags with hundreds of
+// frames through ID3v2::FrameFactory, which picks the frame class and, for
+// ID3v2.2, converts the frame ID by the ID of each frame.  The frames are
+// small so that the dispatch, rather than the parsing of the fields, shows.
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <tbytevector.h>
+#include <id3v2header.h>
+#include <id3v2frame.h>
+#include <id3v2framefactory.h>
+#include <id3v2synchdata.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  const char *const frameIDs4[] = {
+    "TIT2", "TPE1", "TALB", "TCON", "TXXX", "COMM", "WXXX", "WOAR",
+    "PRIV", "UFID", "POPM", "TRCK", "TSOP", "XYZW", "USLT", "PCST"
+  };
+
+  const char *const frameIDs2[] = {
+    "TT2", "TP1", "TAL", "TCO", "TXX", "COM", "WXX", "WAR",
+    "UFI", "POP", "TRK", "TYE", "TSP", "XYZ", "ULT", "PCS"
+  };
+
+  ByteVector frameData(const char *id, unsigned int version)
+  {
+    const ByteVector fields("\0eng\0A field of a frame\0", 24);
+
+    ByteVector data(id);
+    if(version == 2)
+      data.append(ByteVector::fromUInt(fields.size()).mid(1));
+    else if(version == 3)
+      data.append(ByteVector::fromUInt(fields.size()));
+    else
+      data.append(ID3v2::SynchData::fromUInt(fields.size()));
+
+    if(version > 2)
+      data.append(ByteVector(2, '\0'));
+
+    data.append(fields);
+    return data;
+  }
+
+  void run(const char *name, const char *const *ids, unsigned int version,
+           unsigned long passes)
+  {
+    const unsigned int frameCount = 400;
+
+    std::vector<ByteVector> frames;
+    for(unsigned int i = 0; i < frameCount; ++i)
+      frames.push_back(frameData(ids[i % 16], version));
+
+    ID3v2::Header tagHeader;
+    tagHeader.setMajorVersion(version);
+    ID3v2::FrameFactory *factory = ID3v2::FrameFactory::instance();
+
+    Timer timer;
+    for(unsigned long p = 0; p < passes; ++p) {
+      for(std::vector<ByteVector>::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+        ID3v2::Frame *frame = factory->createFrame(*it, &tagHeader);
+        consume(frame ? frame->size() : 0);
+        delete frame;
+      }
+    }
+    printResult(name, timer.seconds(), static_cast<double>(passes) * frameCount, "frames");
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned long passes = 2000;
+  if(argc > 2 && std::strcmp(argv[1], "-n") == 0)
+    passes = std::strtoul(argv[2], 0, 10);
+
+  run("ID3v2.4, 400 frames", frameIDs4, 4, passes);
+  run("ID3v2.3, 400 frames", frameIDs4, 3, passes);
+  run("ID3v2.2, 400 frames", frameIDs2, 2, passes);
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Reads the audio properties of an MPEG stream without a VBR header with
+// the Accurate read style, which counts all of its frames, and reports the
+// throughput.  Without arguments a 64 MiB stream of frames alternating
+// between two bitrates is made up in memory; otherwise the given files are
+// read, which shows the throughput on files in the page cache.
+
+#include <cstring>
+
+#include <tbytevector.h>
+#include <tbytevectorstream.h>
+#include <tfilestream.h>
+#include <mpegfile.h>
+#include <mpegproperties.h>
+#include <id3v2framefactory.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  ByteVector makeStream(unsigned int size)
+  {
+    ByteVector data;
+    data.resize(size);
+
+    unsigned int offset = 0;
+    for(unsigned int i = 0; offset + 1044 <= size; ++i) {
+      data[offset] = '\xFF';
+      data[offset + 1] = '\xFB';
+      data[offset + 2] = i % 2 ? '\xE0' : '\x90';
+      data[offset + 3] = '\xC0';
+      offset += i % 2 ? 1044 : 417;
+    }
+    data.resize(offset);
+    return data;
+  }
+
+  void readProperties(IOStream *stream, AudioProperties::ReadStyle style, const char *name)
+  {
+    const long long size = stream->length();
+
+    Timer timer;
+    MPEG::File file(stream, ID3v2::FrameFactory::instance(), true, style);
+    const double seconds = timer.seconds();
+
+    if(!file.audioProperties())
+      return;
+
+    consume(file.audioProperties()->lengthInMilliseconds());
+    std::printf("%-24s %10.3f ms %10.1f MB/s %10d ms %5d kbps\n",
+                name, seconds * 1000.0, size / seconds / 1000000.0,
+                file.audioProperties()->lengthInMilliseconds(),
+                file.audioProperties()->bitrate());
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    const ByteVector data = makeStream(64 * 1024 * 1024);
+    ByteVectorStream stream(data);
+    readProperties(&stream, AudioProperties::Average, "in memory, Average");
+    readProperties(&stream, AudioProperties::Accurate, "in memory, Accurate");
+    return 0;
+  }
+
+  for(int i = 1; i < argc; ++i) {
+    std::printf("%s:\n", argv[i]);
+    FileStream stream(argv[i], true);
+    if(!stream.isOpen())
+      continue;
+
+    // Once to get the file into the page cache.
+    readProperties(&stream, AudioProperties::Accurate, "  Accurate (cold)");
+    readProperties(&stream, AudioProperties::Average, "  Average");
+    readProperties(&stream, AudioProperties::Accurate, "  Accurate");
+  }
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Adds a large picture to the ID3v2 tag of a copy of the given MP3 file and
+// reports how long rendering the tag and saving the file take, and the peak
+// resident set size of the process, which shows the copies of the tag made
+// while rendering it.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include <sys/resource.h>
+
+#include <mpegfile.h>
+#include <id3v2tag.h>
+#include <attachedpictureframe.h>
+#include <textidentificationframe.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  bool copyFile(const char *from, const std::string &to)
+  {
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out(to.c_str(), std::ios::binary);
+    out << in.rdbuf();
+    return in && out;
+  }
+
+  long peakResidentKiB()
+  {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    std::printf("usage: %s file.mp3 [picture MiB]\n", argv[0]);
+    return 1;
+  }
+
+  const unsigned int pictureSize = (argc > 2 ? std::atoi(argv[2]) : 20) * 1024 * 1024;
+  const int iterations = 10;
+
+  const std::string copy = std::string(argv[1]) + ".bench-id3v2render.mp3";
+  if(!copyFile(argv[1], copy)) {
+    std::printf("could not copy %s\n", argv[1]);
+    return 1;
+  }
+
+  {
+    MPEG::File f(copy.c_str(), false);
+    ID3v2::Tag *tag = f.ID3v2Tag(true);
+    tag->setTitle("Title");
+    tag->setArtist("Artist");
+
+    ID3v2::AttachedPictureFrame *picture = new ID3v2::AttachedPictureFrame();
+    picture->setMimeType("image/jpeg");
+    picture->setPicture(ByteVector(pictureSize, 'x'));
+    tag->addFrame(picture);
+
+    const long residentBefore = peakResidentKiB();
+
+    Timer timer;
+    for(int i = 0; i < iterations; ++i)
+      consume(tag->render().size());
+    printResult("ID3v2::Tag::render()", timer.seconds(), iterations, "tags");
+
+    std::printf("%-32s %10ld KiB over the picture\n", "peak RSS while rendering",
+                peakResidentKiB() - residentBefore);
+
+    timer.restart();
+    f.save();
+    printResult("MPEG::File::save(), new tag", timer.seconds(), 1, "saves");
+  }
+
+  Timer timer;
+  for(int i = 0; i < iterations; ++i) {
+    MPEG::File f(copy.c_str(), false);
+    f.ID3v2Tag()->setTitle(i % 2 ? "Title" : "Another title");
+    f.save();
+  }
+  printResult("MPEG::File::save(), same size", timer.seconds(), iterations, "saves");
+
+  std::printf("%-32s %10ld KiB\n", "peak RSS", peakResidentKiB());
+
+  std::remove(copy.c_str());
+  return 0;
+}
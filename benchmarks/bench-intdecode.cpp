@@ -0,0 +1,109 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Decodes the integers of a synthetic stream of box headers in several ways:
+// through the ByteVector conversion functions, through mid() temporaries as
+// much of the older parsing code does, and through the internal ByteReader
+// cursor.  EBML variable length integers are decoded the same way.
+
+#include <cstdlib>
+#include <cstring>
+
+#include <tbytevector.h>
+#include <tbytereader.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+int main(int argc, char *argv[])
+{
+  unsigned long passes = 2000;
+  if(argc > 2 && std::strcmp(argv[1], "-n") == 0)
+    passes = std::strtoul(argv[2], 0, 10);
+
+  const unsigned int size = 64 * 1024;
+  ByteVector data(size);
+  for(unsigned int i = 0; i < size; ++i)
+    data[i] = static_cast<char>((i * 2654435761U) >> 24);
+
+  // Every fourth byte starts a VINT of one to four bytes.
+  ByteVector vints(size);
+  for(unsigned int i = 0; i < size; i += 4) {
+    vints[i] = static_cast<char>(0x80 >> (i / 4 % 4));
+    vints[i + 1] = vints[i + 2] = vints[i + 3] = '\x5a';
+  }
+
+  const unsigned int count = size / 8;
+  const double values = static_cast<double>(passes) * count;
+  Timer timer;
+
+  unsigned long long sum = 0;
+  for(unsigned long p = 0; p < passes; ++p) {
+    for(unsigned int offset = 0; offset < size; offset += 8)
+      sum += data.toUInt(offset);
+  }
+  printResult("ByteVector::toUInt(offset)", timer.seconds(), values, "ints");
+  consume(static_cast<size_t>(sum));
+
+  timer.restart();
+  for(unsigned long p = 0; p < passes; ++p) {
+    for(unsigned int offset = 0; offset < size; offset += 8)
+      sum += data.toUInt(offset, 3U);
+  }
+  printResult("ByteVector::toUInt(offset, 3)", timer.seconds(), values, "ints");
+  consume(static_cast<size_t>(sum));
+
+  timer.restart();
+  for(unsigned long p = 0; p < passes / 10; ++p) {
+    for(unsigned int offset = 0; offset < size; offset += 8)
+      sum += data.mid(offset, 4).toUInt() + data.mid(offset + 4, 4).toUInt();
+  }
+  printResult("mid().toUInt()", timer.seconds(), values / 10 * 2, "ints");
+  consume(static_cast<size_t>(sum));
+
+  timer.restart();
+  for(unsigned long p = 0; p < passes; ++p) {
+    Utils::ByteReader reader(data);
+    unsigned int value;
+    while(reader.readUInt(value))
+      sum += value;
+  }
+  printResult("ByteReader::readUInt()", timer.seconds(), values * 2, "ints");
+  consume(static_cast<size_t>(sum));
+
+  timer.restart();
+  for(unsigned long p = 0; p < passes; ++p) {
+    Utils::ByteReader reader(vints);
+    unsigned long long value;
+    unsigned int length;
+    while(reader.readVInt(value, length) && reader.skip(4 - length))
+      sum += value;
+  }
+  printResult("ByteReader::readVInt()", timer.seconds(), values * 2, "vints");
+  consume(static_cast<size_t>(sum));
+
+  return 0;
+}
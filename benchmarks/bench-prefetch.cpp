@@ -0,0 +1,99 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Reads the tags and audio properties of the given files through FileStream,
+// one file after another, and through the streams of FilePrefetcher with each
+// of its backends.  Run it with a cold page cache (drop_caches) to see the
+// overlapped I/O; with a warm cache it mostly measures the parsing.
+
+#include <tfile.h>
+#include <tfilestream.h>
+#include <tprefetchedfilestream.h>
+#include <fileref.h>
+#include <audioproperties.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  void parse(IOStream *stream)
+  {
+    const FileRef file(stream, File::ReadTags | File::ReadAudioProperties);
+    if(!file.isNull() && file.audioProperties())
+      consume(file.audioProperties()->lengthInMilliseconds());
+  }
+
+  void benchPrefetcher(const char *name, const StringList &paths,
+                       FilePrefetcher::Backend backend)
+  {
+    FilePrefetcher prefetcher;
+    prefetcher.setBackend(backend);
+
+    Timer timer;
+    List<PrefetchedFileStream *> streams = prefetcher.open(paths);
+    streams.setAutoDelete(true);
+    const double prefetchSeconds = timer.seconds();
+
+    unsigned long long missed = 0;
+    for(List<PrefetchedFileStream *>::ConstIterator it = streams.begin(); it != streams.end(); ++it) {
+      parse(*it);
+      missed += (*it)->missedReads();
+    }
+
+    printResult(name, timer.seconds(), paths.size(), "files");
+    std::printf("  %.3f ms prefetching, %llu reads missed the prefetched data\n",
+                prefetchSeconds * 1000.0, missed);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    std::printf("usage: %s file...\n", argv[0]);
+    return 1;
+  }
+
+  StringList paths;
+  for(int i = 1; i < argc; ++i)
+    paths.append(String(argv[i]));
+
+  Timer timer;
+  for(int i = 1; i < argc; ++i) {
+    FileStream stream(argv[i], true);
+    if(stream.isOpen())
+      parse(&stream);
+  }
+  printResult("FileStream", timer.seconds(), paths.size(), "files");
+
+  benchPrefetcher("FilePrefetcher (threads)", paths, FilePrefetcher::ThreadPool);
+
+  if(FilePrefetcher::isIOUringAvailable())
+    benchPrefetcher("FilePrefetcher (io_uring)", paths, FilePrefetcher::IOUring);
+  else
+    std::printf("io_uring is not available\n");
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Opens the given files over and over until the requested number of files
+// has been processed (100,000 by default, the size of a typical library) and
+// exports their properties as UTF-8, the way a JSON exporter or the C
+// bindings would.  Opening and exporting are timed separately.
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fileref.h>
+#include <tfile.h>
+#include <tpropertymap.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  void appendQuoted(std::string &out, const char *s)
+  {
+    out += '"';
+    out += s;
+    out += '"';
+  }
+
+  // Every value is read twice, as in a program which both stores the value
+  // and builds an index from it.
+
+  size_t exportProperties(const PropertyMap &properties, std::string &out)
+  {
+    out.clear();
+    out += '{';
+
+    for(PropertyMap::ConstIterator it = properties.begin(); it != properties.end(); ++it) {
+      appendQuoted(out, it->first.toCString(true));
+      out += ":[";
+      for(StringList::ConstIterator value = it->second.begin(); value != it->second.end(); ++value) {
+        appendQuoted(out, value->toCString(true));
+        out += ',';
+        consume(value->data(String::UTF8).size());
+      }
+      out += "],";
+    }
+
+    out += '}';
+    return out.size();
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned long count = 100000;
+  std::vector<const char *> files;
+
+  for(int i = 1; i < argc; ++i) {
+    if(std::strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      count = std::strtoul(argv[++i], 0, 10);
+    else
+      files.push_back(argv[i]);
+  }
+
+  if(files.empty() || count == 0) {
+    std::printf("usage: %s [-n count] file...\n", argv[0]);
+    return 1;
+  }
+
+  std::string json;
+  double openTime = 0.0;
+  double exportTime = 0.0;
+  unsigned long long bytes = 0;
+
+  for(unsigned long i = 0; i < count; ++i) {
+    Timer timer;
+
+    FileRef f(files[i % files.size()], false);
+    if(f.isNull())
+      continue;
+
+    const PropertyMap properties = f.file()->properties();
+    openTime += timer.seconds();
+
+    timer.restart();
+    bytes += exportProperties(properties, json);
+    exportTime += timer.seconds();
+  }
+
+  printResult("open and read properties", openTime, static_cast<double>(count), "files");
+  printResult("export as UTF-8", exportTime, static_cast<double>(count), "files");
+  std::printf("%llu bytes exported\n", bytes);
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Opens the given files with each of a few read option presets and reports,
+// per file extension, how many bytes and reads each of them costs and how
+// long it takes.  The counts are those of the stream, so they show how much
+// of the files the formats manage to skip.
+
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <tfile.h>
+#include <fileref.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  struct Preset
+  {
+    const char *name;
+    int options;
+  };
+
+  const Preset presets[] = {
+    { "everything", File::ReadEverything },
+    { "tags", File::ReadTags | File::ReadAudioProperties },
+    { "tags and picture handles", File::ReadTags | File::ReadPictureHandles },
+    { "basic tags", File::ReadBasicTags },
+    { "properties", File::ReadAudioProperties },
+    { "nothing", File::ReadNothing }
+  };
+
+  struct Counts
+  {
+    Counts() :
+      files(0),
+      bytesRead(0),
+      reads(0),
+      seconds(0.0) {}
+
+    unsigned long files;
+    unsigned long long bytesRead;
+    unsigned long long reads;
+    double seconds;
+  };
+
+  std::string extensionOf(const char *fileName)
+  {
+    const char *dot = std::strrchr(fileName, '.');
+    return dot ? std::string(dot + 1) : std::string("(none)");
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    std::printf("usage: %s file...\n", argv[0]);
+    return 1;
+  }
+
+  const size_t presetCount = sizeof(presets) / sizeof(presets[0]);
+
+  for(size_t p = 0; p < presetCount; ++p) {
+    std::map<std::string, Counts> counts;
+
+    for(int i = 1; i < argc; ++i) {
+      Timer timer;
+      CountingStream stream(argv[i]);
+      if(!stream.isOpen())
+        continue;
+
+      const FileRef file(&stream, presets[p].options, AudioProperties::Average);
+      if(file.isNull())
+        continue;
+
+      Counts &c = counts[extensionOf(argv[i])];
+      ++c.files;
+      c.bytesRead += stream.bytesRead;
+      c.reads += stream.reads;
+      c.seconds += timer.seconds();
+    }
+
+    std::printf("%s:\n", presets[p].name);
+    for(std::map<std::string, Counts>::const_iterator it = counts.begin(); it != counts.end(); ++it) {
+      const Counts &c = it->second;
+      std::printf("  %-8s %6lu files %14llu bytes %8llu reads %10.3f ms\n",
+                  it->first.c_str(), c.files, c.bytesRead, c.reads, c.seconds * 1000.0);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Reads the audio properties of the given files with each ReadStyle and
+// reports, per file extension, how many bytes and reads each style costs,
+// how long it takes and the total length it finds.  The lengths show what
+// the extra reading of the slower styles buys.
+
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <tfile.h>
+#include <fileref.h>
+#include <audioproperties.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  struct Style
+  {
+    const char *name;
+    AudioProperties::ReadStyle style;
+  };
+
+  const Style styles[] = {
+    { "Fast", AudioProperties::Fast },
+    { "Average", AudioProperties::Average },
+    { "Accurate", AudioProperties::Accurate }
+  };
+
+  struct Counts
+  {
+    Counts() :
+      files(0),
+      bytesRead(0),
+      reads(0),
+      seconds(0.0),
+      length(0) {}
+
+    unsigned long files;
+    unsigned long long bytesRead;
+    unsigned long long reads;
+    double seconds;
+    long long length;
+  };
+
+  std::string extensionOf(const char *fileName)
+  {
+    const char *dot = std::strrchr(fileName, '.');
+    return dot ? std::string(dot + 1) : std::string("(none)");
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    std::printf("usage: %s file...\n", argv[0]);
+    return 1;
+  }
+
+  const size_t styleCount = sizeof(styles) / sizeof(styles[0]);
+
+  for(size_t s = 0; s < styleCount; ++s) {
+    std::map<std::string, Counts> counts;
+
+    for(int i = 1; i < argc; ++i) {
+      Timer timer;
+      CountingStream stream(argv[i]);
+      if(!stream.isOpen())
+        continue;
+
+      const FileRef file(&stream, File::ReadAudioProperties, styles[s].style);
+      if(file.isNull() || !file.audioProperties())
+        continue;
+
+      Counts &c = counts[extensionOf(argv[i])];
+      ++c.files;
+      c.bytesRead += stream.bytesRead;
+      c.reads += stream.reads;
+      c.seconds += timer.seconds();
+      c.length += file.audioProperties()->lengthInMilliseconds();
+    }
+
+    std::printf("%s:\n", styles[s].name);
+    for(std::map<std::string, Counts>::const_iterator it = counts.begin(); it != counts.end(); ++it) {
+      const Counts &c = it->second;
+      std::printf("  %-8s %6lu files %14llu bytes %8llu reads %10.3f ms %12lld ms of audio\n",
+                  it->first.c_str(), c.files, c.bytesRead, c.reads, c.seconds * 1000.0, c.length);
+    }
+  }
+
+  return 0;
+}
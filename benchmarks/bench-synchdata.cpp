@@ -0,0 +1,115 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// Decodes unsynchronised data with ID3v2::SynchData::decode() and with the
+// byte by byte loop it replaced: a picture unsynchronised as an encoder
+// would do it, with a 0x00 after every 0xFF, the same with a 0xFF in every
+// few bytes as in unsynch.id3, and text without any 0xFF.
+
+#include <cstdlib>
+#include <cstring>
+
+#include <tbytevector.h>
+#include <id3v2synchdata.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  ByteVector scalarDecode(const ByteVector &data)
+  {
+    ByteVector result(data.size());
+
+    ByteVector::ConstIterator src = data.begin();
+    ByteVector::Iterator dst = result.begin();
+
+    while(src < data.end() - 1) {
+      *dst++ = *src++;
+
+      if(*(src - 1) == '\xff' && *src == '\x00')
+        src++;
+    }
+
+    if(src < data.end())
+      *dst++ = *src++;
+
+    result.resize(static_cast<unsigned int>(dst - result.begin()));
+
+    return result;
+  }
+
+  // Unsynchronises \a size bytes which have a 0xFF about once in \a spacing.
+
+  ByteVector unsynchronised(unsigned int size, unsigned int spacing)
+  {
+    ByteVector data;
+    for(unsigned int i = 0; data.size() < size; ++i) {
+      const unsigned int value = (i * 2654435761U) >> 16;
+      if(value % spacing == 0) {
+        data.append('\xff');
+        data.append('\x00');
+      }
+      else {
+        data.append(static_cast<char>(value & 0x7F));
+      }
+    }
+    return data;
+  }
+
+  void run(const char *name, const ByteVector &data, unsigned long passes)
+  {
+    const double bytes = static_cast<double>(passes) * data.size();
+    std::printf("%s:\n", name);
+
+    Timer timer;
+    for(unsigned long p = 0; p < passes; ++p)
+      consume(scalarDecode(data).size());
+    printResult("  byte by byte", timer.seconds(), bytes / 1e6, "MB");
+
+    timer.restart();
+    for(unsigned long p = 0; p < passes; ++p)
+      consume(ID3v2::SynchData::decode(data).size());
+    printResult("  SynchData::decode()", timer.seconds(), bytes / 1e6, "MB");
+
+    if(scalarDecode(data) != ID3v2::SynchData::decode(data))
+      std::printf("  results differ\n");
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned long passes = 20;
+  if(argc > 2 && std::strcmp(argv[1], "-n") == 0)
+    passes = std::strtoul(argv[2], 0, 10);
+
+  const unsigned int size = 16 * 1024 * 1024;
+
+  run("picture, 0xFF in 256 bytes", unsynchronised(size, 256), passes);
+  run("dense, 0xFF in 4 bytes", unsynchronised(size, 4), passes);
+  run("text, no 0xFF", unsynchronised(size, size), passes);
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+// Parses the tags of the given files repeatedly and then looks up a handful
+// of common fields in each of them, so that changes to the containers used
+// by the tag readers can be measured in isolation from audio properties.
+
+#include <cstring>
+#include <vector>
+
+#include <tfile.h>
+#include <tpropertymap.h>
+#include <mpegfile.h>
+#include <id3v2tag.h>
+#include <mp4file.h>
+#include <mp4tag.h>
+#include <fileref.h>
+
+#include "benchutils.h"
+
+using namespace TagLib;
+
+namespace
+{
+  const char *const frameIds[] = { "TIT2", "TPE1", "TALB", "TRCK", "APIC" };
+  const char *const itemNames[] = { "\251nam", "\251ART", "\251alb", "trkn", "covr" };
+  const char *const propertyKeys[] = { "TITLE", "ARTIST", "ALBUM", "TRACKNUMBER", "GENRE" };
+
+  const int lookupsPerFile = 1000;
+
+  size_t lookup(File *file)
+  {
+    size_t found = 0;
+
+    if(MPEG::File *mpeg = dynamic_cast<MPEG::File *>(file)) {
+      if(ID3v2::Tag *tag = mpeg->ID3v2Tag()) {
+        for(int i = 0; i < lookupsPerFile; ++i)
+          found += tag->frameList(frameIds[i % 5]).size();
+      }
+    }
+    else if(MP4::File *mp4 = dynamic_cast<MP4::File *>(file)) {
+      if(MP4::Tag *tag = mp4->tag()) {
+        for(int i = 0; i < lookupsPerFile; ++i)
+          found += tag->contains(itemNames[i % 5]) ? 1 : 0;
+      }
+    }
+
+    const PropertyMap properties = file->properties();
+    for(int i = 0; i < lookupsPerFile; ++i)
+      found += properties.contains(propertyKeys[i % 5]) ? 1 : 0;
+
+    return found;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned long count = 10000;
+  std::vector<const char *> files;
+
+  for(int i = 1; i < argc; ++i) {
+    if(std::strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      count = std::strtoul(argv[++i], 0, 10);
+    else
+      files.push_back(argv[i]);
+  }
+
+  if(files.empty() || count == 0) {
+    std::printf("usage: %s [-n count] file...\n", argv[0]);
+    return 1;
+  }
+
+  double parseTime = 0.0;
+  double lookupTime = 0.0;
+
+  for(unsigned long i = 0; i < count; ++i) {
+    Timer timer;
+
+    FileRef f(files[i % files.size()], false);
+    if(f.isNull())
+      continue;
+
+    parseTime += timer.seconds();
+
+    timer.restart();
+    consume(lookup(f.file()));
+    lookupTime += timer.seconds();
+  }
+
+  printResult("parse tags", parseTime, static_cast<double>(count), "files");
+  printResult("look up fields", lookupTime, static_cast<double>(count) * lookupsPerFile, "lookups");
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_BENCHUTILS_H
+#define TAGLIB_BENCHUTILS_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <tfilestream.h>
+
+namespace
+{
+  //! Measures wall clock time since construction or the last restart().
+
+  class Timer
+  {
+  public:
+    Timer() :
+      start(std::chrono::steady_clock::now()) {}
+
+    void restart()
+    {
+      start = std::chrono::steady_clock::now();
+    }
+
+    double seconds() const
+    {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+  private:
+    std::chrono::steady_clock::time_point start;
+  };
+
+  // Keeps the optimizer from discarding the results of benchmarked code.
+
+  volatile unsigned long long benchSink = 0;
+
+  template <class T>
+  inline void consume(const T &value)
+  {
+    benchSink = benchSink + static_cast<unsigned long long>(value);
+  }
+
+  //! A FileStream which counts the bytes read and the reads made from it.
+
+  class CountingStream : public TagLib::FileStream
+  {
+  public:
+    CountingStream(TagLib::FileName fileName) :
+      TagLib::FileStream(fileName, true),
+      bytesRead(0),
+      reads(0) {}
+
+    virtual TagLib::ByteVector readBlock(unsigned long length)
+    {
+      const TagLib::ByteVector data = TagLib::FileStream::readBlock(length);
+      bytesRead += data.size();
+      ++reads;
+      return data;
+    }
+
+    unsigned long long bytesRead;
+    unsigned long long reads;
+  };
+
+  inline void printResult(const char *name, double seconds, double operations, const char *unit)
+  {
+    std::printf("%-32s %10.3f ms %14.1f %s/s\n",
+                name, seconds * 1000.0, operations / seconds, unit);
+  }
+}
+
+#endif
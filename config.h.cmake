@@ -24,6 +24,12 @@
 /* Defined if your compiler supports ISO _strdup */
 #cmakedefine   HAVE_ISO_STRDUP 1
 
+/* Defined if io_uring can be used */
+#cmakedefine   HAVE_LINUX_IO_URING 1
+
+/* Defined if FilePrefetcher is built */
+#cmakedefine   TAGLIB_WITH_PREFETCH 1
+
 /* Defined if zlib is installed */
 #cmakedefine   HAVE_ZLIB 1
 
@@ -29,7 +29,7 @@ while test $# -gt 0
 do
   case $1 in
     --libs)
-	  flags="$flags -L$libdir -ltag"
+	  flags="$flags -L$libdir -ltag ${CMAKE_THREAD_LIBS_INIT}"
 	  ;;
     --cflags)
 	  flags="$flags -I$includedir/taglib"
@@ -8,4 +8,5 @@ Description: Audio meta-data library
 Requires: 
 Version: @TAGLIB_LIB_VERSION_STRING@
 Libs: -L${libdir} -ltag
+Libs.private: @CMAKE_THREAD_LIBS_INIT@
 Cflags: -I${includedir}/taglib
@@ -115,6 +115,15 @@ APE::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
     read(readProperties);
 }
 
+APE::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 APE::File::~File()
 {
   delete d;
@@ -70,6 +70,28 @@ namespace
 
     return true;
   }
+
+  const int itemReadOptions = File::ReadTags | File::ReadPictures;
+
+  // Returns whether an item with the key \a keyData is one of the parts of
+  // the file given by the read options.
+
+  bool isItemWanted(const ByteVector &keyData, int options)
+  {
+    if((options & itemReadOptions) == itemReadOptions)
+      return true;
+
+    const String key = String(keyData, String::UTF8).upper();
+
+    if(key.startsWith("COVER ART"))
+      return (options & File::ReadPictures) != 0;
+
+    if(key == "TITLE" || key == "ARTIST" || key == "ALBUM" || key == "COMMENT" ||
+       key == "GENRE" || key == "YEAR" || key == "TRACK")
+      return (options & File::ReadBasicTags) != 0;
+
+    return (options & File::ReadExtendedTags) != 0;
+  }
 }
 
 class APE::Tag::TagPrivate
@@ -377,6 +399,11 @@ void APE::Tag::read()
        d->footer.tagSize() > static_cast<unsigned long>(d->file->length()))
       return;
 
+    // The footer is all that is needed to know where the tag is.
+
+    if(!(d->file->readOptions() & itemReadOptions))
+      return;
+
     d->file->seek(d->footerLocation + Footer::size() - d->footer.tagSize());
     parse(d->file->readBlock(d->footer.tagSize() - Footer::size()));
   }
@@ -406,6 +433,8 @@ void APE::Tag::parse(const ByteVector &data)
   if(data.size() < 11)
     return;
 
+  const int options = d->file ? d->file->readOptions() : static_cast<int>(File::ReadEverything);
+
   unsigned int pos = 0;
 
   for(unsigned int i = 0; i < d->footer.itemCount() && pos <= data.size() - 11; i++) {
@@ -423,10 +452,12 @@ void APE::Tag::parse(const ByteVector &data)
       && keyLength <= MaxKeyLength
       && isKeyValid(data.mid(pos + 8, keyLength)))
     {
-      APE::Item item;
-      item.parse(data.mid(pos));
+      if(isItemWanted(data.mid(pos + 8, keyLength), options)) {
+        APE::Item item;
+        item.parse(data.mid(pos));
 
-      d->itemListMap.insert(item.key().upper(), item);
+        d->itemListMap.insert(item.key().upper(), item);
+      }
     }
     else {
       debug("APE::Tag::parse() - Skipped an item due to an invalid key.");
@@ -206,6 +206,14 @@ String ASF::Attribute::parse(ASF::File &f, int kind)
     debug("ASF::Attribute::parse() -- Value larger than 64kB");
   }
 
+  // Values which are not wanted by the read options are not read.  The caller
+  // checks the name as well, and drops the attribute.
+
+  if(!isAttributeWanted(name, f.readOptions())) {
+    f.seek(size, File::Current);
+    return name;
+  }
+
   switch(d->type) {
   case WordType:
     d->numericValue = readWORD(&f);
@@ -266,9 +266,13 @@ void ASF::File::FilePrivate::ContentDescriptionObject::parse(ASF::File *file, un
   const int ratingLength    = readWORD(file);
   file->d->tag->setTitle(readString(file,titleLength));
   file->d->tag->setArtist(readString(file,artistLength));
-  file->d->tag->setCopyright(readString(file,copyrightLength));
+  const String copyright = readString(file,copyrightLength);
   file->d->tag->setComment(readString(file,commentLength));
-  file->d->tag->setRating(readString(file,ratingLength));
+  const String rating = readString(file,ratingLength);
+  if(file->readOptions() & File::ReadExtendedTags) {
+    file->d->tag->setCopyright(copyright);
+    file->d->tag->setRating(rating);
+  }
 }
 
 ByteVector ASF::File::FilePrivate::ContentDescriptionObject::render(ASF::File *file)
@@ -303,7 +307,8 @@ void ASF::File::FilePrivate::ExtendedContentDescriptionObject::parse(ASF::File *
   while(count--) {
     ASF::Attribute attribute;
     String name = attribute.parse(*file);
-    file->d->tag->addAttribute(name, attribute);
+    if(isAttributeWanted(name, file->readOptions()))
+      file->d->tag->addAttribute(name, attribute);
   }
 }
 
@@ -326,7 +331,8 @@ void ASF::File::FilePrivate::MetadataObject::parse(ASF::File *file, unsigned int
   while(count--) {
     ASF::Attribute attribute;
     String name = attribute.parse(*file, 1);
-    file->d->tag->addAttribute(name, attribute);
+    if(isAttributeWanted(name, file->readOptions()))
+      file->d->tag->addAttribute(name, attribute);
   }
 }
 
@@ -349,7 +355,8 @@ void ASF::File::FilePrivate::MetadataLibraryObject::parse(ASF::File *file, unsig
   while(count--) {
     ASF::Attribute attribute;
     String name = attribute.parse(*file, 2);
-    file->d->tag->addAttribute(name, attribute);
+    if(isAttributeWanted(name, file->readOptions()))
+      file->d->tag->addAttribute(name, attribute);
   }
 }
 
@@ -503,6 +510,15 @@ ASF::File::File(IOStream *stream, bool, Properties::ReadStyle) :
     read();
 }
 
+ASF::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read();
+}
+
 ASF::File::~File()
 {
   delete d;
@@ -648,6 +664,13 @@ void ASF::File::read()
   }
   seek(2, Current);
 
+  // The objects which only hold metadata that is not wanted are seeked over.
+  // The file and stream properties objects are needed to validate the file,
+  // so they are always read.
+
+  const bool readAttributes = (readOptions() & (ReadTags | ReadPictures)) != 0;
+  const bool readCodecList = (readOptions() & ReadAudioProperties) != 0;
+
   FilePrivate::FilePropertiesObject   *filePropertiesObject   = 0;
   FilePrivate::StreamPropertiesObject *streamPropertiesObject = 0;
   for(int i = 0; i < numObjects; i++) {
@@ -661,6 +684,13 @@ void ASF::File::read()
       setValid(false);
       break;
     }
+    if((!readAttributes && (guid == contentDescriptionGuid ||
+                            guid == extendedContentDescriptionGuid ||
+                            guid == headerExtensionGuid)) ||
+       (!readCodecList && guid == codecListGuid)) {
+      seek(size - 24, Current);
+      continue;
+    }
     FilePrivate::BaseObject *obj;
     if(guid == filePropertiesGuid) {
       filePropertiesObject = new FilePrivate::FilePropertiesObject();
@@ -70,6 +70,19 @@ namespace TagLib {
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an ASF file from \a stream, reading only the parts of it
+       * given by \a readOptions, a combination of TagLib::File::ReadOptions.
+       *
+       * \note In the current implementation, \a propertiesStyle is ignored.
+       * The audio properties are always read, as they are needed to validate
+       * the file, but the codec list is only read with ReadAudioProperties.
+       *
+       * \note TagLib will *not* take ownership of the stream, the caller is
+       * responsible for deleting it after the File object.
+       */
+      File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle propertiesStyle);
+
       /*!
        * Destroys this instance of the File.
        */
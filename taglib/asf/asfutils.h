@@ -95,6 +95,25 @@ namespace TagLib
         return data;
       }
 
+      // Returns whether an attribute named \a name is one of the parts of the
+      // file given by the read options.
+
+      inline bool isAttributeWanted(const String &name, int options)
+      {
+        const int attributeReadOptions = File::ReadTags | File::ReadPictures;
+        if((options & attributeReadOptions) == attributeReadOptions)
+          return true;
+
+        if(name == "WM/Picture")
+          return (options & File::ReadPictures) != 0;
+
+        if(name == "WM/AlbumTitle" || name == "WM/Genre" || name == "WM/Year" ||
+           name == "WM/TrackNumber" || name == "WM/Track")
+          return (options & File::ReadBasicTags) != 0;
+
+        return (options & File::ReadExtendedTags) != 0;
+      }
+
     }
   }
 }
@@ -49,6 +49,11 @@ namespace TagLib {
      * file.  Because in many situations speed is critical or the accuracy of the
      * values is not particularly important this allows the level of desired
      * accuracy to be set.
+     *
+     * Formats whose headers give exact values, which are most of them, read
+     * the same for every style.  Those which have to estimate some values
+     * document what each style reads, see MPEG::Properties and
+     * Matroska::Properties.
      */
     enum ReadStyle {
       //! Read as little of the file as possible
@@ -0,0 +1,418 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <tfile.h>
+#include <tfilestream.h>
+#include <trefcounter.h>
+
+#include "fileref.h"
+#include "batchscanner.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // Limits the number of files that are open at the same time.
+
+  class Semaphore
+  {
+  public:
+    explicit Semaphore(unsigned int count) :
+      available(count) {}
+
+    void acquire()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while(available == 0)
+        condition.wait(lock);
+      --available;
+    }
+
+    void release()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++available;
+      }
+      condition.notify_one();
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    unsigned int available;
+  };
+
+  // Collects the results of BatchScanner::scan() in the order of the paths.
+
+  class Collector : public BatchScanner::Listener
+  {
+  public:
+    explicit Collector(size_t count) :
+      results(count) {}
+
+    void fileScanned(const BatchScanner::Result &result)
+    {
+      results[result.index()] = result;
+    }
+
+    std::vector<BatchScanner::Result> results;
+  };
+}
+
+class BatchScanner::Result::ResultPrivate : public RefCounter
+{
+public:
+  ResultPrivate() :
+    RefCounter(),
+    index(0),
+    valid(false),
+    length(0),
+    bitrate(0),
+    sampleRate(0),
+    channels(0),
+    scanTime(0) {}
+
+  unsigned int index;
+  String path;
+  bool valid;
+  String errorMessage;
+  PropertyMap properties;
+  int length;
+  int bitrate;
+  int sampleRate;
+  int channels;
+  int scanTime;
+};
+
+class BatchScanner::BatchScannerPrivate
+{
+public:
+  struct ScanState;
+
+  BatchScannerPrivate() :
+    threadCount(0),
+    maxOpenFiles(0),
+    readOptions(File::ReadTags | File::ReadAudioProperties),
+    audioPropertiesStyle(AudioProperties::Average) {}
+
+  static void work(ScanState *state);
+  void scanFile(Result &result) const;
+
+  unsigned int threadCount;
+  unsigned int maxOpenFiles;
+  int readOptions;
+  AudioProperties::ReadStyle audioPropertiesStyle;
+};
+
+// What the workers of one scan() share.
+
+struct BatchScanner::BatchScannerPrivate::ScanState
+{
+  ScanState(const BatchScannerPrivate *p, const StringList &pathList,
+            Listener *l, unsigned int maxOpenFiles) :
+    scanner(p),
+    paths(pathList.begin(), pathList.end()),
+    listener(l),
+    openFiles(maxOpenFiles),
+    next(0) {}
+
+  const BatchScannerPrivate *scanner;
+  const std::vector<String> paths;
+  Listener *listener;
+  std::mutex listenerMutex;
+  Semaphore openFiles;
+  std::atomic<size_t> next;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Result public members
+////////////////////////////////////////////////////////////////////////////////
+
+BatchScanner::Result::Result() :
+  d(new ResultPrivate())
+{
+}
+
+BatchScanner::Result::Result(const Result &result) :
+  d(result.d)
+{
+  d->ref();
+}
+
+BatchScanner::Result::~Result()
+{
+  if(d->deref())
+    delete d;
+}
+
+BatchScanner::Result &BatchScanner::Result::operator=(const Result &result)
+{
+  if(d != result.d) {
+    result.d->ref();
+    if(d->deref())
+      delete d;
+    d = result.d;
+  }
+  return *this;
+}
+
+unsigned int BatchScanner::Result::index() const
+{
+  return d->index;
+}
+
+String BatchScanner::Result::path() const
+{
+  return d->path;
+}
+
+bool BatchScanner::Result::isValid() const
+{
+  return d->valid;
+}
+
+String BatchScanner::Result::errorMessage() const
+{
+  return d->errorMessage;
+}
+
+PropertyMap BatchScanner::Result::properties() const
+{
+  return d->properties;
+}
+
+int BatchScanner::Result::lengthInMilliseconds() const
+{
+  return d->length;
+}
+
+int BatchScanner::Result::bitrate() const
+{
+  return d->bitrate;
+}
+
+int BatchScanner::Result::sampleRate() const
+{
+  return d->sampleRate;
+}
+
+int BatchScanner::Result::channels() const
+{
+  return d->channels;
+}
+
+int BatchScanner::Result::scanTimeInMicroseconds() const
+{
+  return d->scanTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Listener public members
+////////////////////////////////////////////////////////////////////////////////
+
+BatchScanner::Listener::Listener()
+{
+}
+
+BatchScanner::Listener::~Listener()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+BatchScanner::BatchScanner() :
+  d(new BatchScannerPrivate())
+{
+}
+
+BatchScanner::~BatchScanner()
+{
+  delete d;
+}
+
+void BatchScanner::setThreadCount(unsigned int count)
+{
+  d->threadCount = count;
+}
+
+unsigned int BatchScanner::threadCount() const
+{
+  if(d->threadCount > 0)
+    return d->threadCount;
+
+  const unsigned int processors = std::thread::hardware_concurrency();
+  return processors > 0 ? processors : 1;
+}
+
+void BatchScanner::setMaxOpenFiles(unsigned int count)
+{
+  d->maxOpenFiles = count;
+}
+
+unsigned int BatchScanner::maxOpenFiles() const
+{
+  return d->maxOpenFiles > 0 ? d->maxOpenFiles : threadCount();
+}
+
+void BatchScanner::setReadAudioProperties(bool read, AudioProperties::ReadStyle style)
+{
+  if(read)
+    d->readOptions |= File::ReadAudioProperties;
+  else
+    d->readOptions &= ~File::ReadAudioProperties;
+  d->audioPropertiesStyle = style;
+}
+
+void BatchScanner::setReadOptions(int options)
+{
+  d->readOptions = options;
+}
+
+int BatchScanner::readOptions() const
+{
+  return d->readOptions;
+}
+
+void BatchScanner::scan(const StringList &paths, Listener *listener) const
+{
+  if(paths.isEmpty() || !listener)
+    return;
+
+  BatchScannerPrivate::ScanState state(d, paths, listener, maxOpenFiles());
+
+  const unsigned int threads =
+    static_cast<unsigned int>(std::min<size_t>(threadCount(), state.paths.size()));
+
+  std::vector<std::thread> pool;
+  for(unsigned int i = 1; i < threads; ++i)
+    pool.push_back(std::thread(&BatchScannerPrivate::work, &state));
+
+  BatchScannerPrivate::work(&state);
+
+  for(std::vector<std::thread>::iterator it = pool.begin(); it != pool.end(); ++it)
+    it->join();
+}
+
+List<BatchScanner::Result> BatchScanner::scan(const StringList &paths) const
+{
+  Collector collector(paths.size());
+  scan(paths, &collector);
+
+  List<Result> results;
+  for(std::vector<Result>::const_iterator it = collector.results.begin();
+      it != collector.results.end(); ++it) {
+    results.append(*it);
+  }
+  return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchScanner::BatchScannerPrivate::work(ScanState *state)
+{
+  // Each worker takes the next path that nobody has started on yet, so the
+  // load evens out however long the individual files take.
+
+  for(size_t i = state->next++; i < state->paths.size(); i = state->next++) {
+    Result result;
+    result.d->index = static_cast<unsigned int>(i);
+    result.d->path = state->paths[i];
+
+    state->openFiles.acquire();
+    state->scanner->scanFile(result);
+    state->openFiles.release();
+
+    std::lock_guard<std::mutex> lock(state->listenerMutex);
+    state->listener->fileScanned(result);
+  }
+}
+
+void BatchScanner::BatchScannerPrivate::scanFile(Result &result) const
+{
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+#ifdef _WIN32
+  const FileName fileName(result.d->path.toCWString());
+#else
+  const std::string name = result.d->path.to8Bit(true);
+  const FileName fileName(name.c_str());
+#endif
+
+  // Nothing may be thrown out of a worker thread, so the likes of bad_alloc
+  // on a corrupt file are reported as errors of that file.
+
+  try {
+    const FileRef file(fileName, static_cast<File::ReadOptions>(readOptions),
+                       audioPropertiesStyle);
+
+    if(file.isNull()) {
+      if(FileStream(fileName, true).isOpen())
+        result.d->errorMessage = "Unsupported file type or invalid file";
+      else
+        result.d->errorMessage = "Could not open the file";
+    }
+    else {
+      result.d->valid = true;
+
+      // PropertyMap has no assignment operator of its own, so the map and the
+      // unsupported data are swapped in.
+      PropertyMap properties = file.file()->properties();
+      result.d->properties.swap(properties);
+      result.d->properties.unsupportedData().swap(properties.unsupportedData());
+
+      if(const AudioProperties *audio = file.audioProperties()) {
+        // The video formats only implement the old length() in seconds.
+        result.d->length = audio->lengthInMilliseconds();
+        if(result.d->length == 0)
+          result.d->length = audio->length() * 1000;
+
+        result.d->bitrate = audio->bitrate();
+        result.d->sampleRate = audio->sampleRate();
+        result.d->channels = audio->channels();
+      }
+    }
+  }
+  catch(const std::exception &e) {
+    result.d->valid = false;
+    result.d->errorMessage = String("Exception while reading the file: ") + e.what();
+  }
+
+  result.d->scanTime = static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - start).count());
+}
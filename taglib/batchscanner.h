@@ -0,0 +1,274 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_BATCHSCANNER_H
+#define TAGLIB_BATCHSCANNER_H
+
+#include "tlist.h"
+#include "tstringlist.h"
+#include "tpropertymap.h"
+#include "taglib_export.h"
+#include "audioproperties.h"
+
+namespace TagLib {
+
+  //! Reads the metadata of many files in parallel
+
+  /*!
+   * BatchScanner opens and parses a list of files on a pool of worker threads
+   * and reports a compact Result for each of them.  A Result holds the tag
+   * properties and the audio (or video) properties of the file, so nothing
+   * has to be kept open once a file has been scanned.
+   *
+   * Idle workers take the next unscanned file from the list, so slow files do
+   * not hold up the others.  The number of files which are open at the same
+   * time can be limited independently of the number of threads, which is
+   * useful on storage that degrades with too many outstanding requests.
+   *
+   * \code
+   *
+   * class Printer : public TagLib::BatchScanner::Listener
+   * {
+   *   void fileScanned(const TagLib::BatchScanner::Result &result)
+   *   {
+   *     if(result.isValid())
+   *       std::cout << result.properties()["TITLE"].toString() << std::endl;
+   *     else
+   *       std::cerr << result.errorMessage() << std::endl;
+   *   }
+   * };
+   *
+   * TagLib::BatchScanner scanner;
+   * scanner.setThreadCount(8);
+   * Printer printer;
+   * scanner.scan(paths, &printer);
+   *
+   * \endcode
+   *
+   * Files are opened as by FileRef, so any file type resolvers added with
+   * FileRef::addFileTypeResolver() are used as well.  They are called from the
+   * worker threads and must not be added or removed during a scan.
+   */
+
+  class TAGLIB_EXPORT BatchScanner
+  {
+  public:
+
+    //! The metadata of one scanned file
+
+    /*!
+     * This is implicitly shared, and therefore cheap to copy.
+     */
+    class TAGLIB_EXPORT Result
+    {
+    public:
+      /*!
+       * Constructs an empty, invalid result.
+       */
+      Result();
+
+      /*!
+       * Makes a shallow, implicitly shared copy of \a result.
+       */
+      Result(const Result &result);
+
+      /*!
+       * Destroys this Result instance.
+       */
+      ~Result();
+
+      /*!
+       * Copies the contents of \a result into this Result.
+       */
+      Result &operator=(const Result &result);
+
+      /*!
+       * Returns the position of the file in the list that was scanned.
+       */
+      unsigned int index() const;
+
+      /*!
+       * Returns the path of the file, as it was given to the scanner.
+       */
+      String path() const;
+
+      /*!
+       * Returns true if the file could be opened and was recognised as a valid
+       * file of a supported type.
+       */
+      bool isValid() const;
+
+      /*!
+       * Returns why the file could not be read, or an empty string if it was
+       * read successfully.
+       */
+      String errorMessage() const;
+
+      /*!
+       * Returns the tag of the file as returned by File::properties().
+       */
+      PropertyMap properties() const;
+
+      /*!
+       * Returns the length of the file in milliseconds, or 0 if the audio
+       * properties were not read.
+       */
+      int lengthInMilliseconds() const;
+
+      /*!
+       * Returns the average bit rate in kb/s, or 0 if the audio properties were
+       * not read.
+       */
+      int bitrate() const;
+
+      /*!
+       * Returns the sample rate in Hz, or 0 if the audio properties were not
+       * read.
+       */
+      int sampleRate() const;
+
+      /*!
+       * Returns the number of audio channels, or 0 if the audio properties were
+       * not read.
+       */
+      int channels() const;
+
+      /*!
+       * Returns the time it took to open and read the file, in microseconds.
+       */
+      int scanTimeInMicroseconds() const;
+
+    private:
+      friend class BatchScanner;
+
+      class ResultPrivate;
+      ResultPrivate *d;
+    };
+
+    //! An interface for receiving results as files are scanned
+
+    class TAGLIB_EXPORT Listener
+    {
+    public:
+      Listener();
+      virtual ~Listener();
+
+      /*!
+       * Called once for every file when it has been scanned, in the order in
+       * which the files are finished rather than the order of the list.
+       *
+       * \note This is called from the worker threads, but never from two of
+       * them at the same time.  The workers wait while it runs, so it should
+       * return quickly.
+       */
+      virtual void fileScanned(const Result &result) = 0;
+
+    private:
+      // Noncopyable
+      Listener(const Listener &);
+      Listener &operator=(const Listener &);
+    };
+
+    /*!
+     * Constructs a scanner which uses one thread per processor and reads the
+     * audio properties with the Average read style.
+     */
+    BatchScanner();
+
+    /*!
+     * Destroys this BatchScanner instance.
+     */
+    ~BatchScanner();
+
+    /*!
+     * Sets the number of threads that open and parse files.  The thread
+     * calling scan() is one of them.  0 means one per processor.
+     */
+    void setThreadCount(unsigned int count);
+
+    /*!
+     * Returns the number of threads that open and parse files.
+     */
+    unsigned int threadCount() const;
+
+    /*!
+     * Sets the maximum number of files that are open at the same time.  0, the
+     * default, means one for each thread.
+     */
+    void setMaxOpenFiles(unsigned int count);
+
+    /*!
+     * Returns the maximum number of files that are open at the same time.
+     */
+    unsigned int maxOpenFiles() const;
+
+    /*!
+     * Sets whether the audio properties are read, and with what accuracy.  If
+     * \a read is false the audio values of the results are all 0.
+     */
+    void setReadAudioProperties(bool read,
+                                AudioProperties::ReadStyle style = AudioProperties::Average);
+
+    /*!
+     * Sets what is read of the files, a combination of File::ReadOptions.  The
+     * default is File::ReadTags and File::ReadAudioProperties, as the results
+     * hold neither pictures nor chapters.  Reading only File::ReadBasicTags,
+     * or only the audio properties, makes a scan cheaper for the formats which
+     * allow skipping the rest.
+     *
+     * \see FileRef(FileName, File::ReadOptions, AudioProperties::ReadStyle)
+     */
+    void setReadOptions(int options);
+
+    /*!
+     * Returns what is read of the files.
+     *
+     * \see setReadOptions()
+     */
+    int readOptions() const;
+
+    /*!
+     * Scans the files in \a paths and calls \a listener for each of them.
+     * Returns when all of them have been scanned.
+     */
+    void scan(const StringList &paths, Listener *listener) const;
+
+    /*!
+     * Scans the files in \a paths and returns their results, in the same
+     * order as \a paths.
+     */
+    List<Result> scan(const StringList &paths) const;
+
+  private:
+    BatchScanner(const BatchScanner &);
+    BatchScanner &operator=(const BatchScanner &);
+
+    class BatchScannerPrivate;
+    BatchScannerPrivate *d;
+  };
+
+}
+
+#endif
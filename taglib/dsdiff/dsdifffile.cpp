@@ -132,6 +132,16 @@ DSDIFF::File::File(IOStream *stream, bool readProperties,
     read(readProperties, propertiesStyle);
 }
 
+DSDIFF::File::File(IOStream *stream, ReadOptions readOptions,
+                   Properties::ReadStyle propertiesStyle) : TagLib::File(stream)
+{
+  d = new FilePrivate;
+  d->endianness = BigEndian;
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0, propertiesStyle);
+}
+
 DSDIFF::File::~File()
 {
   delete d;
@@ -203,6 +213,7 @@ bool DSDIFF::File::save()
 
   // First: save ID3V2 chunk
   ID3v2::Tag *id3v2Tag = d->tag.access<ID3v2::Tag>(ID3v2Index, false);
+
   if(d->isID3InPropChunk) {
     if(id3v2Tag != NULL && !id3v2Tag->isEmpty()) {
       setChildChunkData(d->id3v2TagChunkID, id3v2Tag->render(), PROPChunk);
@@ -740,7 +751,7 @@ void DSDIFF::File::read(bool readProperties, Properties::ReadStyle propertiesSty
   // Read title & artist from DIIN chunk
   d->tag.access<DSDIFF::DIIN::Tag>(DIINIndex, true);
 
-  if(d->hasDiin) {
+  if(d->hasDiin && (readOptions() & ReadBasicTags)) {
     for(unsigned int i = 0; i < d->childChunks[DIINChunk].size(); i++) {
       if(d->childChunks[DIINChunk][i].name == "DITI") {
         seek(d->childChunks[DIINChunk][i].offset);
@@ -82,6 +82,18 @@ namespace TagLib {
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an DSDIFF file from \a stream, reading only the
+       * parts of it given by \a readOptions, a combination of
+       * TagLib::File::ReadOptions.
+       *
+       * \note TagLib will *not* take ownership of the stream, the caller is
+       * responsible for deleting it after the File object.
+       *
+       * \note In the current implementation, \a propertiesStyle is ignored.
+       */
+      File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle propertiesStyle);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -90,6 +90,16 @@ DSF::File::File(IOStream *stream, bool readProperties,
     read(readProperties, propertiesStyle);
 }
 
+DSF::File::File(IOStream *stream, ReadOptions readOptions,
+                Properties::ReadStyle propertiesStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0, propertiesStyle);
+}
+
 DSF::File::~File()
 {
   delete d;
@@ -70,6 +70,13 @@ namespace TagLib {
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs a DSF file from \a stream, reading only the parts of it
+       * given by \a readOptions, a combination of TagLib::File::ReadOptions.
+       * The audio properties are read using \a propertiesStyle.
+       */
+      File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle propertiesStyle);
+
       /*!
        * Destroys this instance of the File.
        */
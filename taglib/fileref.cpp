@@ -27,8 +27,11 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tfile.h>
 #include <tfilestream.h>
+#include <tbytevectorstream.h>
 #include <tstring.h>
 #include <tdebug.h>
 #include <trefcounter.h>
@@ -36,6 +39,9 @@
 #include "fileref.h"
 #include "asffile.h"
 #include "mpegfile.h"
+#include "mpegheader.h"
+#include "mpegutils.h"
+#include "id3v2header.h"
 #include "vorbisfile.h"
 #include "flacfile.h"
 #include "oggflacfile.h"
@@ -82,7 +88,7 @@ namespace
 
   // Detect the file type based on the file extension.
 
-  File* detectByExtension(IOStream *stream, bool readAudioProperties,
+  File* detectByExtension(IOStream *stream, File::ReadOptions readOptions,
                           AudioProperties::ReadStyle audioPropertiesStyle)
   {
 #ifdef _WIN32
@@ -106,96 +112,194 @@ namespace
     // .oga can be any audio in the Ogg container. So leave it to content-based detection.
 
     if(ext == "MP3")
-      return new MPEG::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
+      return new MPEG::File(stream, ID3v2::FrameFactory::instance(), readOptions, audioPropertiesStyle);
     if(ext == "OGG")
-      return new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new Ogg::Vorbis::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "FLAC")
-      return new FLAC::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
+      return new FLAC::File(stream, ID3v2::FrameFactory::instance(), readOptions, audioPropertiesStyle);
     if(ext == "MPC")
-      return new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new MPC::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "WV")
-      return new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new WavPack::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "SPX")
-      return new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new Ogg::Speex::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "OPUS")
-      return new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new Ogg::Opus::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "TTA")
-      return new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new TrueAudio::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "M4A" || ext == "M4R" || ext == "M4B" || ext == "M4P" || ext == "MP4" || ext == "3G2" || ext == "M4V")
-      return new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new MP4::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "WMA" || ext == "ASF" || ext == "WMV")
-      return new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new ASF::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "AIF" || ext == "AIFF" || ext == "AFC" || ext == "AIFC")
-      return new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new RIFF::AIFF::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "WAV")
-      return new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new RIFF::WAV::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "APE")
-      return new APE::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new APE::File(stream, readOptions, audioPropertiesStyle);
     // module, nst and wow are possible but uncommon extensions
     if(ext == "MOD" || ext == "MODULE" || ext == "NST" || ext == "WOW")
-      return new Mod::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new Mod::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "S3M")
-      return new S3M::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new S3M::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "IT")
-      return new IT::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new IT::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "XM")
-      return new XM::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new XM::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "DFF" || ext == "DSDIFF")
-      return new DSDIFF::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new DSDIFF::File(stream, readOptions, audioPropertiesStyle);
     if(ext == "DSF")
-      return new DSF::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new DSF::File(stream, readOptions, audioPropertiesStyle);
 
     if (ext == "AVI")
-      return new RIFF::AVI::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new RIFF::AVI::File(stream, readOptions, audioPropertiesStyle);
     if (ext == "MKV")
-      return new Matroska::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new Matroska::File(stream, readOptions, audioPropertiesStyle);
     if (ext == "MPG" || ext == "MPEG")
-      return new MPEG_VIDEO::File(stream, readAudioProperties, audioPropertiesStyle);
+      return new MPEG_VIDEO::File(stream, readOptions, audioPropertiesStyle);
 
     return 0;
   }
 
+  // Wraps an IOStream so that MPEG frame headers can be parsed from it, and
+  // gives access to the buffer size the isSupported() functions use.
+
+  class AdapterFile : public TagLib::File
+  {
+  public:
+    AdapterFile(IOStream *stream) : File(stream) {}
+
+    using File::bufferSize;
+
+    Tag *tag() const { return 0; }
+    AudioProperties *audioProperties() const { return 0; }
+    bool save() { return false; }
+  };
+
+  // Returns true if there is a valid MPEG frame header within the first
+  // \a length bytes of \a window, which was read from \a offset of \a stream.
+  // This is the check of MPEG::File::isSupported(), except that the next frame
+  // header is taken from the window if it is there.
+
+  bool isMPEG(IOStream *stream, const ByteVector &window, long offset, unsigned int length)
+  {
+    if(window.size() < 2)
+      return false;
+
+    ByteVectorStream memory(window);
+    AdapterFile memoryFile(&memory);
+
+    const unsigned int end = std::min(length, window.size()) - 1;
+    for(unsigned int i = 0; i < end; ++i) {
+      if(!MPEG::isFrameSync(window, i))
+        continue;
+
+      const MPEG::Header header(&memoryFile, i, true);
+      if(header.isValid())
+        return true;
+
+      // The next frame header is past the window, so have a look at the stream.
+
+      if(header.frameLength() > 0 && window.size() < i + header.frameLength() + 4) {
+        AdapterFile file(stream);
+        if(MPEG::Header(&file, offset + i, true).isValid())
+          return true;
+      }
+    }
+
+    return false;
+  }
+
   // Detect the file type based on the actual content of the stream.
+  //
+  // The beginning of the stream, and the beginning of the audio data if an
+  // ID3v2 tag precedes it, are read once and every format is checked against
+  // them.  The checks and their order are those of the isSupported()
+  // functions of the file types, which would each read the stream again.
 
-  File *detectByContent(IOStream *stream, bool readAudioProperties,
+  File *detectByContent(IOStream *stream, File::ReadOptions readOptions,
                         AudioProperties::ReadStyle audioPropertiesStyle)
   {
+    if(!stream || !stream->isOpen())
+      return 0;
+
+    const long originalPosition = stream->tell();
+    const unsigned int length = AdapterFile::bufferSize();
+
+    // Read twice the buffer size, so that an MPEG frame starting in the
+    // checked part can usually be validated without another read.
+
+    stream->seek(0);
+    const ByteVector start = stream->readBlock(length * 2);
+    const ByteVector head = start.mid(0, length);
+
+    long audioOffset = 0;
+    ByteVector audioStart = start;
+
+    // The checks only need the first buffer of the audio data; isMPEG() reads
+    // the stream for a frame which goes past what was read.
+
+    if(head.startsWith(ID3v2::Header::fileIdentifier())) {
+      audioOffset = ID3v2::Header(head.mid(0, ID3v2::Header::size())).completeTagSize();
+      if(audioOffset + length <= start.size()) {
+        audioStart = start.mid(static_cast<unsigned int>(audioOffset));
+      }
+      else {
+        stream->seek(audioOffset);
+        audioStart = stream->readBlock(length * 2);
+      }
+    }
+
+    stream->seek(originalPosition);
+
+    const ByteVector audioHead = audioStart.mid(0, length);
+    const bool isOgg = (head.find("OggS") >= 0);
+
     File *file = 0;
 
-    if(MPEG::File::isSupported(stream))
-      file = new MPEG::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Vorbis::File::isSupported(stream))
-      file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::FLAC::File::isSupported(stream))
-      file = new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(FLAC::File::isSupported(stream))
-      file = new FLAC::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
-    else if(MPC::File::isSupported(stream))
-      file = new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(WavPack::File::isSupported(stream))
-      file = new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Speex::File::isSupported(stream))
-      file = new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Opus::File::isSupported(stream))
-      file = new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(TrueAudio::File::isSupported(stream))
-      file = new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(MP4::File::isSupported(stream))
-      file = new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ASF::File::isSupported(stream))
-      file = new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(RIFF::AIFF::File::isSupported(stream))
-      file = new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(RIFF::WAV::File::isSupported(stream))
-      file = new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(APE::File::isSupported(stream))
-      file = new APE::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(DSDIFF::File::isSupported(stream))
-      file = new DSDIFF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(DSF::File::isSupported(stream))
-      file = new DSF::File(stream, readAudioProperties, audioPropertiesStyle);
-
-    // isSupported() only does a quick check, so double check the file here.
+    // Video containers have fixed signatures, and must be ruled out before
+    // looking for MPEG audio frames, which they may well contain.
+
+    if(head.startsWith("\x1A\x45\xDF\xA3"))
+      file = new Matroska::File(stream, readOptions, audioPropertiesStyle);
+    else if(head.startsWith("RIFF") && head.containsAt("AVI ", 8))
+      file = new RIFF::AVI::File(stream, readOptions, audioPropertiesStyle);
+    else if(head.startsWith(ByteVector("\x00\x00\x01\xBA", 4)) || head.startsWith(ByteVector("\x00\x00\x01\xB3", 4)))
+      file = new MPEG_VIDEO::File(stream, readOptions, audioPropertiesStyle);
+    else if(isMPEG(stream, audioStart, audioOffset, length))
+      file = new MPEG::File(stream, ID3v2::FrameFactory::instance(), readOptions, audioPropertiesStyle);
+    else if(isOgg && head.find("\x01vorbis") >= 0)
+      file = new Ogg::Vorbis::File(stream, readOptions, audioPropertiesStyle);
+    else if(isOgg && head.find("fLaC") >= 0)
+      file = new Ogg::FLAC::File(stream, readOptions, audioPropertiesStyle);
+    else if(audioHead.find("fLaC") >= 0)
+      file = new FLAC::File(stream, ID3v2::FrameFactory::instance(), readOptions, audioPropertiesStyle);
+    else if(head.startsWith("MPCK") || head.startsWith("MP+"))
+      file = new MPC::File(stream, readOptions, audioPropertiesStyle);
+    else if(head.startsWith("wvpk"))
+      file = new WavPack::File(stream, readOptions, audioPropertiesStyle);
+    else if(isOgg && head.find("Speex   ") >= 0)
+      file = new Ogg::Speex::File(stream, readOptions, audioPropertiesStyle);
+    else if(isOgg && head.find("OpusHead") >= 0)
+      file = new Ogg::Opus::File(stream, readOptions, audioPropertiesStyle);
+    else if(audioHead.startsWith("TTA"))
+      file = new TrueAudio::File(stream, readOptions, audioPropertiesStyle);
+    else if(head.containsAt("ftyp", 4))
+      file = new MP4::File(stream, readOptions, audioPropertiesStyle);
+    else if(head.startsWith(ByteVector("\x30\x26\xB2\x75\x8E\x66\xCF\x11\xA6\xD9\x00\xAA\x00\x62\xCE\x6C", 16)))
+      file = new ASF::File(stream, readOptions, audioPropertiesStyle);
+    else if(head.startsWith("FORM") && (head.containsAt("AIFF", 8) || head.containsAt("AIFC", 8)))
+      file = new RIFF::AIFF::File(stream, readOptions, audioPropertiesStyle);
+    else if(head.startsWith("RIFF") && head.containsAt("WAVE", 8))
+      file = new RIFF::WAV::File(stream, readOptions, audioPropertiesStyle);
+    else if(audioHead.find("MAC ") >= 0)
+      file = new APE::File(stream, readOptions, audioPropertiesStyle);
+    else if(head.startsWith("FRM8") && head.containsAt("DSD ", 12))
+      file = new DSDIFF::File(stream, readOptions, audioPropertiesStyle);
+    else if(head.startsWith("DSD "))
+      file = new DSF::File(stream, readOptions, audioPropertiesStyle);
+
+    // The checks above are only quick ones, so double check the file here.
 
     if(file) {
       if(file->isValid())
@@ -207,6 +311,17 @@ namespace
     return 0;
   }
 
+  // Returns the read options equivalent to the \a readAudioProperties flag of
+  // the older constructors.
+
+  File::ReadOptions readOptionsFor(bool readAudioProperties)
+  {
+    if(readAudioProperties)
+      return File::ReadEverything;
+    else
+      return File::ReadEverything & ~File::ReadAudioProperties;
+  }
+
   // Internal function that supports FileRef::create().
   // This looks redundant, but necessary in order not to change the previous
   // behavior of FileRef::create().
@@ -314,13 +429,26 @@ FileRef::FileRef(FileName fileName, bool readAudioProperties,
                  AudioProperties::ReadStyle audioPropertiesStyle) :
   d(new FileRefPrivate())
 {
-  parse(fileName, readAudioProperties, audioPropertiesStyle);
+  parse(fileName, readOptionsFor(readAudioProperties), audioPropertiesStyle);
+}
+
+FileRef::FileRef(FileName fileName, File::ReadOptions readOptions,
+                 AudioProperties::ReadStyle audioPropertiesStyle) :
+  d(new FileRefPrivate())
+{
+  parse(fileName, readOptions, audioPropertiesStyle);
 }
 
 FileRef::FileRef(IOStream* stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle) :
   d(new FileRefPrivate())
 {
-  parse(stream, readAudioProperties, audioPropertiesStyle);
+  parse(stream, readOptionsFor(readAudioProperties), audioPropertiesStyle);
+}
+
+FileRef::FileRef(IOStream* stream, File::ReadOptions readOptions, AudioProperties::ReadStyle audioPropertiesStyle) :
+  d(new FileRefPrivate())
+{
+  parse(stream, readOptions, audioPropertiesStyle);
 }
 
 FileRef::FileRef(File *file) :
@@ -456,25 +584,26 @@ File *FileRef::create(FileName fileName, bool readAudioProperties,
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void FileRef::parse(FileName fileName, bool readAudioProperties,
+void FileRef::parse(FileName fileName, File::ReadOptions readOptions,
                     AudioProperties::ReadStyle audioPropertiesStyle)
 {
   // Try user-defined resolvers.
 
-  d->file = detectByResolvers(fileName, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByResolvers(fileName, (readOptions & File::ReadAudioProperties) != 0,
+                              audioPropertiesStyle);
   if(d->file)
     return;
 
   // Try to resolve file types based on the file extension.
 
   d->stream = new FileStream(fileName);
-  d->file = detectByExtension(d->stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByExtension(d->stream, readOptions, audioPropertiesStyle);
   if(d->file)
     return;
 
   // At last, try to resolve file types based on the actual content.
 
-  d->file = detectByContent(d->stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByContent(d->stream, readOptions, audioPropertiesStyle);
   if(d->file)
     return;
 
@@ -484,18 +613,18 @@ void FileRef::parse(FileName fileName, bool readAudioProperties,
   d->stream = 0;
 }
 
-void FileRef::parse(IOStream *stream, bool readAudioProperties,
+void FileRef::parse(IOStream *stream, File::ReadOptions readOptions,
                     AudioProperties::ReadStyle audioPropertiesStyle)
 {
   // User-defined resolvers won't work with a stream.
 
   // Try to resolve file types based on the file extension.
 
-  d->file = detectByExtension(stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByExtension(stream, readOptions, audioPropertiesStyle);
   if(d->file)
     return;
 
   // At last, try to resolve file types based on the actual content of the file.
 
-  d->file = detectByContent(stream, readAudioProperties, audioPropertiesStyle);
+  d->file = detectByContent(stream, readOptions, audioPropertiesStyle);
 }
@@ -144,6 +144,34 @@ namespace TagLib {
                      AudioProperties::ReadStyle
                      audioPropertiesStyle = AudioProperties::Average);
 
+    /*!
+     * Create a FileRef from \a fileName, reading only the parts of the file
+     * given by \a readOptions, a combination of File::ReadOptions.  The audio
+     * properties are read using \a audioPropertiesStyle if
+     * File::ReadAudioProperties is set.
+     *
+     * Reading less than File::ReadEverything is meant for scanning files, and
+     * skips the bytes of the metadata which is not wanted where the format
+     * allows it.  The file is then read only, see File::readOnly().
+     *
+     * \note User-defined resolvers are asked for the file with
+     * File::ReadAudioProperties only, as they don't know about read options.
+     */
+    FileRef(FileName fileName, File::ReadOptions readOptions,
+            AudioProperties::ReadStyle audioPropertiesStyle);
+
+    /*!
+     * Construct a FileRef from an opened \a IOStream, reading only the parts of
+     * the file given by \a readOptions, a combination of File::ReadOptions.
+     *
+     * \note TagLib will *not* take ownership of the stream, the caller is
+     * responsible for deleting it after the File object.
+     *
+     * \see FileRef(FileName, File::ReadOptions, AudioProperties::ReadStyle)
+     */
+    FileRef(IOStream* stream, File::ReadOptions readOptions,
+            AudioProperties::ReadStyle audioPropertiesStyle);
+
     /*!
      * Construct a FileRef using \a file.  The FileRef now takes ownership of the
      * pointer and will delete the File when it passes out of scope.
@@ -275,8 +303,8 @@ namespace TagLib {
                         AudioProperties::ReadStyle audioPropertiesStyle = AudioProperties::Average);
 
   private:
-    void parse(FileName fileName, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle);
-    void parse(IOStream *stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle);
+    void parse(FileName fileName, File::ReadOptions readOptions, AudioProperties::ReadStyle audioPropertiesStyle);
+    void parse(IOStream *stream, File::ReadOptions readOptions, AudioProperties::ReadStyle audioPropertiesStyle);
 
     class FileRefPrivate;
     FileRefPrivate *d;
@@ -23,7 +23,10 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tbytevector.h>
+#include <tbytevectorlist.h>
 #include <tstring.h>
 #include <tlist.h>
 #include <tdebug.h>
@@ -55,6 +58,119 @@ namespace
   const long MaxPaddingLegnth = 1024 * 1024;
 
   const char LastBlockFlag = '\x80';
+
+  // A metadata block which TagLib doesn't parse, such as a seek table or a
+  // cue sheet.  Only its place in the file is kept, and its data is read
+  // when it has to be written somewhere else.
+
+  class FileMetadataBlock : public FLAC::MetadataBlock
+  {
+  public:
+    FileMetadataBlock(File *file, int code, long long offset, unsigned int length) :
+      m_file(file),
+      m_code(code),
+      m_offset(offset),
+      m_length(length) {}
+
+    int code() const
+    {
+      return m_code;
+    }
+
+    ByteVector render() const
+    {
+      return m_file->readAt(m_offset, m_length);
+    }
+
+    long long offset() const
+    {
+      return m_offset;
+    }
+
+    void setOffset(long long offset)
+    {
+      m_offset = offset;
+    }
+
+    unsigned int length() const
+    {
+      return m_length;
+    }
+
+  private:
+    File *m_file;
+    int m_code;
+    long long m_offset;
+    unsigned int m_length;
+  };
+
+  ByteVector renderBlockHeader(int code, unsigned int length)
+  {
+    ByteVector header = ByteVector::fromUInt(length);
+    header[0] = static_cast<char>(code);
+    return header;
+  }
+
+  // Returns the position of the picture data length in \a data, the start of
+  // a picture block, or 0 if the fields before it are not all there.  See
+  // FLAC::Picture::parse() for the layout.  Each length is checked against
+  // the bytes left before it is added, so that the position can not wrap.
+
+  unsigned int pictureDataLengthPosition(const ByteVector &data)
+  {
+    if(data.size() < 8)
+      return 0;
+
+    unsigned int pos = 8;
+    const unsigned int mimeTypeLength = data.toUInt(4U);
+    if(mimeTypeLength > data.size() - pos || data.size() - pos - mimeTypeLength < 4)
+      return 0;
+    pos += mimeTypeLength;
+
+    const unsigned int descriptionLength = data.toUInt(pos);
+    pos += 4;
+    if(descriptionLength > data.size() - pos || data.size() - pos - descriptionLength < 20)
+      return 0;
+
+    return pos + descriptionLength + 16;
+  }
+
+  // Returns a handle to the picture of the picture block of \a length bytes
+  // which starts at the current position of \a file.  Only the fields before
+  // the picture data are read.
+
+  PictureHandle readPictureHandle(File *file, unsigned int length)
+  {
+    const long long start = file->tell();
+
+    ByteVector data = file->readBlock(std::min<unsigned int>(length, 256));
+
+    unsigned int pos = pictureDataLengthPosition(data);
+    if(pos == 0 && data.size() < length) {
+      data.append(file->readBlock(length - data.size()));
+      pos = pictureDataLengthPosition(data);
+    }
+
+    if(pos == 0) {
+      debug("FLAC::File::scan() -- invalid picture found, discarding");
+      return PictureHandle();
+    }
+
+    const unsigned int mimeTypeLength = data.toUInt(4U);
+    const unsigned int descriptionLength = data.toUInt(8 + mimeTypeLength);
+
+    const unsigned int dataLength = data.toUInt(pos);
+    pos += 4;
+    if(dataLength > length - pos) {
+      debug("FLAC::File::scan() -- invalid picture found, discarding");
+      return PictureHandle();
+    }
+
+    return PictureHandle(file, start + pos, dataLength,
+                         String(data.mid(8, mimeTypeLength), String::UTF8),
+                         static_cast<int>(data.toUInt(0U)),
+                         String(data.mid(8 + mimeTypeLength + 4, descriptionLength), String::UTF8));
+  }
 }
 
 class FLAC::File::FilePrivate
@@ -89,6 +205,7 @@ public:
   Properties *properties;
   ByteVector xiphCommentData;
   BlockList blocks;
+  PictureHandleList pictureHandles;
 
   long flacStart;
   long streamStart;
@@ -137,6 +254,16 @@ FLAC::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
     read(readProperties);
 }
 
+FLAC::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
+                 ReadOptions readOptions, Properties::ReadStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate(frameFactory))
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 FLAC::File::~File()
 {
   delete d;
@@ -198,21 +325,30 @@ bool FLAC::File::save()
 
   d->blocks.append(new UnknownMetadataBlock(MetadataBlock::VorbisComment, d->xiphCommentData));
 
-  // Render data for the metadata blocks
+  // Render data for the metadata blocks.  Those which are read from the
+  // file on demand are not read yet, since their size is known.
+
+  ByteVectorList blockData;
+  List<unsigned int> blockSizes;
+  long dataLength = 0;
 
-  ByteVector data;
   for(BlockConstIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
-    ByteVector blockData = (*it)->render();
-    ByteVector blockHeader = ByteVector::fromUInt(blockData.size());
-    blockHeader[0] = (*it)->code();
-    data.append(blockHeader);
-    data.append(blockData);
+    const FileMetadataBlock *fileBlock = dynamic_cast<const FileMetadataBlock *>(*it);
+    if(fileBlock) {
+      blockData.append(ByteVector());
+      blockSizes.append(fileBlock->length());
+    }
+    else {
+      blockData.append((*it)->render());
+      blockSizes.append(blockData.back().size());
+    }
+    dataLength += 4 + blockSizes.back();
   }
 
   // Compute the amount of padding, and append that to data.
 
   long originalLength = d->streamStart - d->flacStart;
-  long paddingLength = originalLength - data.size() - 4;
+  long paddingLength = originalLength - dataLength - 4;
 
   if(paddingLength <= 0) {
     paddingLength = MinPaddingLength;
@@ -228,6 +364,42 @@ bool FLAC::File::save()
       paddingLength = MinPaddingLength;
   }
 
+  // If the blocks fit in the space they had, the leading blocks which are
+  // already in the file as they would be written are left as they are.
+
+  long start = 0;
+
+  BlockConstIterator it = d->blocks.begin();
+  ByteVectorList::ConstIterator dataIt = blockData.begin();
+  List<unsigned int>::ConstIterator sizeIt = blockSizes.begin();
+
+  if(dataLength + 4 + paddingLength == originalLength) {
+    for(; it != d->blocks.end(); ++it, ++dataIt, ++sizeIt) {
+      const FileMetadataBlock *fileBlock = dynamic_cast<const FileMetadataBlock *>(*it);
+      if(fileBlock) {
+        if(fileBlock->offset() != d->flacStart + start + 4)
+          break;
+      }
+      else {
+        const ByteVector header = renderBlockHeader((*it)->code(), *sizeIt);
+        if(readAt(d->flacStart + start, 4 + *sizeIt) != header + *dataIt)
+          break;
+      }
+      start += 4 + *sizeIt;
+    }
+  }
+
+  ByteVector data;
+  for(; it != d->blocks.end(); ++it, ++dataIt, ++sizeIt) {
+    const ByteVector blockBody = dynamic_cast<const FileMetadataBlock *>(*it) ? (*it)->render() : *dataIt;
+    if(blockBody.size() != *sizeIt) {
+      debug("FLAC::File::save() -- Failed to read a metadata block.");
+      return false;
+    }
+    data.append(renderBlockHeader((*it)->code(), *sizeIt));
+    data.append(blockBody);
+  }
+
   ByteVector paddingHeader = ByteVector::fromUInt(paddingLength);
   paddingHeader[0] = static_cast<char>(MetadataBlock::Padding | LastBlockFlag);
   data.append(paddingHeader);
@@ -235,12 +407,14 @@ bool FLAC::File::save()
 
   // Write the data to the file
 
-  insert(data, d->flacStart, originalLength);
+  insert(data, d->flacStart + start, originalLength - start);
+
+  const long sizeDifference = start + static_cast<long>(data.size()) - originalLength;
 
-  d->streamStart += (static_cast<long>(data.size()) - originalLength);
+  d->streamStart += sizeDifference;
 
   if(d->ID3v1Location >= 0)
-    d->ID3v1Location += (static_cast<long>(data.size()) - originalLength);
+    d->ID3v1Location += sizeDifference;
 
   // Update ID3 tags
 
@@ -280,6 +454,17 @@ bool FLAC::File::save()
     }
   }
 
+  // The blocks which are read on demand are now where they were written.
+
+  long long offset = d->flacStart;
+  sizeIt = blockSizes.begin();
+  for(it = d->blocks.begin(); it != d->blocks.end(); ++it, ++sizeIt) {
+    FileMetadataBlock *fileBlock = dynamic_cast<FileMetadataBlock *>(*it);
+    if(fileBlock)
+      fileBlock->setOffset(offset + 4);
+    offset += 4 + *sizeIt;
+  }
+
   if(ID3v1Tag() && !ID3v1Tag()->isEmpty()) {
 
     // ID3v1 tag is not empty. Update the old one or create a new one.
@@ -351,6 +536,19 @@ List<FLAC::Picture *> FLAC::File::pictureList()
   return pictures;
 }
 
+PictureHandleList FLAC::File::pictureHandles() const
+{
+  PictureHandleList handles = d->pictureHandles;
+  for(BlockConstIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
+    const Picture *picture = dynamic_cast<const Picture *>(*it);
+    if(picture) {
+      handles.append(PictureHandle(picture->data(), picture->mimeType(),
+                                   picture->type(), picture->description()));
+    }
+  }
+  return handles;
+}
+
 void FLAC::File::addPicture(Picture *picture)
 {
   d->blocks.append(picture);
@@ -438,7 +636,7 @@ void FLAC::File::read(bool readProperties)
     return;
 
   if(!d->xiphCommentData.isEmpty())
-    d->tag.set(FlacXiphIndex, new Ogg::XiphComment(d->xiphCommentData));
+    d->tag.set(FlacXiphIndex, new Ogg::XiphComment(d->xiphCommentData, readOptions()));
   else
     d->tag.set(FlacXiphIndex, new Ogg::XiphComment());
 
@@ -485,6 +683,14 @@ void FLAC::File::scan()
   nextBlockOffset += 4;
   d->flacStart = nextBlockOffset;
 
+  // Blocks which are not needed for the read options are seeked over.  If
+  // some metadata is left out the file can not be saved, so the unknown
+  // blocks are then not needed either.
+
+  const int options = readOptions();
+  const bool readAll = (options & ReadEverything) == ReadEverything;
+  const long long fileLength = length();
+
   while(true) {
 
     seek(nextBlockOffset);
@@ -522,6 +728,57 @@ void FLAC::File::scan()
       return;
     }
 
+    bool wanted;
+    switch(blockType) {
+    case MetadataBlock::StreamInfo:
+      wanted = true;
+      break;
+    case MetadataBlock::VorbisComment:
+      wanted = (options & (ReadTags | ReadPictures | ReadChapters)) != 0;
+      break;
+    case MetadataBlock::Picture:
+      wanted = (options & ReadPictures) != 0;
+      break;
+    default:
+      wanted = readAll;
+      break;
+    }
+
+    if(!wanted) {
+      if(blockType == MetadataBlock::Picture && (options & ReadPictureHandles)) {
+        const PictureHandle picture = readPictureHandle(this, blockLength);
+        if(!picture.isNull())
+          d->pictureHandles.append(picture);
+      }
+
+      nextBlockOffset += blockLength + 4;
+      if(isLastBlock)
+        break;
+      continue;
+    }
+
+    // The blocks which TagLib doesn't parse are read only if they have to be
+    // written somewhere else.
+
+    if(blockType != MetadataBlock::StreamInfo &&
+       blockType != MetadataBlock::VorbisComment &&
+       blockType != MetadataBlock::Picture)
+    {
+      if(nextBlockOffset + 4 + blockLength > fileLength) {
+        debug("FLAC::File::scan() -- Failed to read a metadata block");
+        setValid(false);
+        return;
+      }
+
+      if(blockType != MetadataBlock::Padding)
+        d->blocks.append(new FileMetadataBlock(this, blockType, nextBlockOffset + 4, blockLength));
+
+      nextBlockOffset += blockLength + 4;
+      if(isLastBlock)
+        break;
+      continue;
+    }
+
     const ByteVector data = readBlock(blockLength);
     if(data.size() != blockLength) {
       debug("FLAC::File::scan() -- Failed to read a metadata block");
@@ -551,9 +808,6 @@ void FLAC::File::scan()
         delete picture;
       }
     }
-    else if(blockType == MetadataBlock::Padding) {
-      // Skip all padding blocks.
-    }
     else {
       block = new UnknownMetadataBlock(blockType, data);
     }
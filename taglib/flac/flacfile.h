@@ -126,6 +126,22 @@ namespace TagLib {
            bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs a FLAC file from \a stream, reading only the parts of it
+       * given by \a readOptions, a combination of TagLib::File::ReadOptions.
+       * The metadata blocks which are not needed are not read.
+       *
+       * \note TagLib will *not* take ownership of the stream, the caller is
+       * responsible for deleting it after the File object.
+       *
+       * If this file contains and ID3v2 tag the frames will be created using
+       * \a frameFactory.
+       *
+       * \note In the current implementation, \a propertiesStyle is ignored.
+       */
+      File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
+           ReadOptions readOptions, Properties::ReadStyle propertiesStyle);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -263,6 +279,16 @@ namespace TagLib {
        */
       List<Picture *> pictureList();
 
+      /*!
+       * Returns handles to the pictures of the picture blocks.  If the file
+       * was opened with File::ReadPictureHandles rather than
+       * File::ReadPictures, these blocks were not read and pictureList() is
+       * empty.
+       *
+       * \see File::pictureHandles()
+       */
+      PictureHandleList pictureHandles() const;
+
       /*!
        * Removes an attached picture. If \a del is true the picture's memory
        * will be freed; if it is false, it must be deleted by the user.
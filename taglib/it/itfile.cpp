@@ -63,6 +63,23 @@ IT::File::File(IOStream *stream, bool readProperties,
     read(readProperties);
 }
 
+IT::File::File(IOStream *stream, ReadOptions readOptions,
+               AudioProperties::ReadStyle propertiesStyle) :
+  Mod::FileBase(stream),
+  d(new FilePrivate(propertiesStyle))
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+
+  if(!(readOptions & ReadBasicTags)) {
+    d->tag.setTitle(String());
+    d->tag.setComment(String());
+  }
+  if(!(readOptions & ReadExtendedTags))
+    d->tag.setTrackerName(String());
+}
+
 IT::File::~File()
 {
   delete d;
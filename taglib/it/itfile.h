@@ -60,6 +60,22 @@ namespace TagLib {
              AudioProperties::ReadStyle propertiesStyle =
              AudioProperties::Average);
 
+        /*!
+         * Constructs a Impulse Tracker file from \a stream, reading only the parts
+         * of it given by \a readOptions, a combination of
+         * TagLib::File::ReadOptions.
+         *
+         * \note The module header holds the title, the comment and the audio
+         * properties together and is always read as a whole; \a readOptions
+         * only selects which of the fields are kept.  \a propertiesStyle is
+         * ignored.
+         *
+         * \note TagLib will *not* take ownership of the stream, the caller is
+         * responsible for deleting it after the File object.
+         */
+        File(IOStream *stream, ReadOptions readOptions,
+             AudioProperties::ReadStyle propertiesStyle);
+
         /*!
          * Destroys this instance of the File.
          */
@@ -1,6 +1,8 @@
 #include "ebmlreader.h"
 #include "ebmlelement.h"
 #include <tdebug.h>
+#include <algorithm>
+#include <tbytereader.h>
 
 using namespace TagLib;
 
@@ -66,13 +68,20 @@ ByteVector Matroska::EBMLReader::readBytes() const
       return result;
   }
 
-  file->seek(dataOffset);
-
-  result = file->readBlock(dataSize);
+  result = file->readAt(dataOffset, dataSize);
 
   return result;
 }
 
+ByteVector Matroska::EBMLReader::readBytes(long long maxLength) const
+{
+  if (!file || dataSize == 0 || maxLength <= 0) {
+      return ByteVector();
+  }
+
+  return file->readAt(dataOffset, static_cast<unsigned long>(std::min(dataSize, maxLength)));
+}
+
 ulong Matroska::EBMLReader::readUInt() const
 {
   ulong result = 0;
@@ -129,44 +138,32 @@ bool Matroska::EBMLReader::read()
   // Prepare for Consistency check
   uint ebmlIdCheck = ebmlId;
   long long ebmlSizeCheck = size();
-  file->seek(offset);
-
-  int idMaxLength = 4;
 
-  const ByteVector& headerByteVector = file->readBlock(1);
-  int mask = 0x80;
-  long idLength = getVINTLength(idMaxLength, headerByteVector, mask);
+  // The header is at most 4 bytes of ID and 8 bytes of size, so read it in
+  // one go and decode it from memory.
+  const ByteVector header = file->readAt(offset, 12);
+  Utils::ByteReader reader(header);
 
-  if (idLength > idMaxLength) {
+  unsigned long long value = 0;
+  unsigned int idLength = 0;
+  if (!reader.readVInt(value, idLength, true) || idLength > 4) {
       debug("Invalid EBML format read");
       return false;
   }
 
-  ByteVector idData = headerByteVector;
-  if (idLength > 1) {
-      idData.append(file->readBlock(static_cast<ulong>(idLength - 1)));
-  }
-
-  ebmlId = idData.toUInt();
-
-  ByteVector sizeLengthVector = file->readBlock(1);
-  int maxSizeLength = 8;
+  ebmlId = static_cast<uint>(value);
 
-  mask = 0x80; // reset mask
-  long sizeLength = getVINTLength(maxSizeLength, sizeLengthVector, mask);
-
-  if (sizeLength > 8) {
+  unsigned int sizeLength = 0;
+  if (!reader.readVInt(value, sizeLength)) {
+      if (reader.atEnd() || header[idLength] != 0) {
+          debug("Invalid EBML format read");
+          return false;
+      }
       sizeLength = 1; // Special: Empty element (all zero state)
-  } else {
-      sizeLengthVector[0] &= static_cast<char>(mask - 1);  // Clear the marker bit
-  }
-
-  // Now read the rest of the EBML element size
-  if (sizeLength > 1) {
-      sizeLengthVector.append(file->readBlock(static_cast<ulong>(sizeLength) - 1));
+      value = 0;
   }
 
-  dataSize = sizeLengthVector.toLongLong();
+  dataSize = static_cast<long long>(value);
 
   // Special: Auto-size (0xFF byte)
   if (sizeLength == 1 && dataSize == 0x7F) {
@@ -189,21 +186,3 @@ bool Matroska::EBMLReader::isAbstract() const
 {
   return offset == dataOffset;
 }
-
-char Matroska::EBMLReader::getVINTLength(int maxSize, const ByteVector &data, int& mask) const
-{
-  if (!data.size()) {
-      debug("Invalid data for reading VINT");
-      return -1;
-  }
-  const char headerByte = data[0];
-
-  char length = 1;
-
-  // VINT size reading
-  while (length <= maxSize && (headerByte & mask) == 0) {
-      length++;
-      mask >>= 1;
-  }
-  return length;
-}
@@ -24,6 +24,7 @@ namespace TagLib {
       bool read();
       String readString() const;
       ByteVector readBytes() const;
+      ByteVector readBytes(long long maxLength) const;
       ulong readUInt() const;
       double readDouble() const;
 
@@ -40,8 +41,6 @@ namespace TagLib {
       bool isSuccessRead;
 
       bool isAbstract() const;
-
-      char getVINTLength(int maxSize, const ByteVector &data, int &mask) const;
     };
 
   }
@@ -28,6 +28,7 @@
 #include "tstring.h"
 #include "matroskafile.h"
 #include "tag.h"
+#include "tpropertymap.h"
 #include "ebmlreader.h"
 #include "matroskatypes.h"
 #include "simpletag.h"
@@ -71,6 +72,16 @@ Matroska::File::File(IOStream *stream, bool readProperties,
     read(readProperties, propertiesStyle);
 }
 
+Matroska::File::File(IOStream *stream, ReadOptions readOptions,
+                     Properties::ReadStyle propertiesStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0, propertiesStyle);
+}
+
 Matroska::File::File(FileName file, bool readProperties,
                      Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
@@ -95,6 +106,20 @@ Matroska::Tag *Matroska::File::tag() const
   return d->unifiedTag;
 }
 
+PropertyMap Matroska::File::properties() const
+{
+  if(!d->unifiedTag)
+    return PropertyMap();
+  return d->unifiedTag->properties();
+}
+
+PropertyMap Matroska::File::setProperties(const PropertyMap &properties)
+{
+  if(!d->unifiedTag)
+    return properties;
+  return d->unifiedTag->setProperties(properties);
+}
+
 bool Matroska::File::save()
 {
   return false;
@@ -140,7 +165,10 @@ void Matroska::File::read(bool readProperties, Properties::ReadStyle propertiesS
 
       switch (matroskaId) {
         case Segment:
-          readSegment(element, propertiesStyle);
+          readSegment(element, readProperties, propertiesStyle);
+          if (readProperties && propertiesStyle == Properties::Accurate && d->properties) {
+              d->properties->readClusters(element);
+            }
           hasSegment = true;
           break;
         default:
@@ -196,13 +224,14 @@ void Matroska::File::readHeader(const EBMLReader &header)
       i += child.size();
     }
 
-  if (docType.isEmpty() || (docType != "matroska")) {
+  if (docType != "matroska" && docType != "webm") {
       debug("DocType is not matroska or webm");
       setValid(false);
     }
 }
 
-void Matroska::File::readSegment(const Matroska::EBMLReader &element, Properties::ReadStyle propertiesStyle, bool retry)
+void Matroska::File::readSegment(const Matroska::EBMLReader &element, bool readProperties,
+                                 Properties::ReadStyle propertiesStyle, bool retry)
 {
   // First make reference of all EBML elements at level 1 (top) in the Segment
   std::vector<Matroska::EBMLReader> segmentationList = readSegments(element, retry); // Try to get it from SeekHead the first time (way faster)
@@ -223,14 +252,15 @@ void Matroska::File::readSegment(const Matroska::EBMLReader &element, Properties
           break;
 
         case SegmentInfo:
-          if ((isValid = child->read())) {
-              readSegmentInfo(*child);
+          if ((isValid = child->read()) && readProperties) {
+              readSegmentInfo(*child, propertiesStyle);
             }
           break;
         case Tags:
           isValid = child->read();
           if (isValid) {
-              readTags(*child);
+              if (readOptions() & ReadTags)
+                readTags(*child);
               makeUnifiedTag();
             }
           break;
@@ -257,7 +287,7 @@ void Matroska::File::readSegment(const Matroska::EBMLReader &element, Properties
           d->m_tags.clear ();
 
           // Retry it one last time
-          readSegment (element, propertiesStyle, false);
+          readSegment (element, readProperties, propertiesStyle, false);
         } else {
           debug ("Invalid EBML element Read");
           setValid(false);
@@ -332,10 +362,11 @@ std::vector<Matroska::EBMLReader> Matroska::File::readSegments(const EBMLReader
   return segmentsList;
 }
 
-void Matroska::File::readSegmentInfo(const Matroska::EBMLReader &element)
+void Matroska::File::readSegmentInfo(const Matroska::EBMLReader &element,
+                                     Properties::ReadStyle propertiesStyle)
 {
   if (!d->properties) {
-      d->properties = new Matroska::Properties(element);
+      d->properties = new Matroska::Properties(element, propertiesStyle);
     }
 }
 
@@ -50,6 +50,8 @@ namespace TagLib {
        * Contructs an Matroska file from \a file.  If \a readProperties is true the
        * file's audio properties will also be read using \a propertiesStyle.  If
        * false, \a propertiesStyle is ignored.
+       *
+       * \see Matroska::Properties for what \a propertiesStyle changes.
        */
       File(FileName file, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -57,6 +59,14 @@ namespace TagLib {
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Contructs an Matroska file from \a stream, reading only the parts of
+       * it given by \a readOptions, a combination of TagLib::File::ReadOptions.
+       * The Tags element is skipped unless tags are requested.
+       */
+      File(IOStream *stream, ReadOptions readOptions,
+           Properties::ReadStyle propertiesStyle);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -72,6 +82,21 @@ namespace TagLib {
        * Returns unified tag;
        */
       virtual Tag* tag() const;
+
+      /*!
+       * Implements the unified property interface -- export function.
+       * This method forwards to the unified tag, and returns an empty map if
+       * the file has no tags.
+       */
+      PropertyMap properties() const;
+
+      /*!
+       * Implements the unified property interface -- import function.
+       * This method forwards to the unified tag.  As save() is not
+       * implemented, the properties are only set in memory, and all of them
+       * are returned if the file has no tags.
+       */
+      PropertyMap setProperties(const PropertyMap &);
       /*!
        * Stub! Not implemented!
        */
@@ -84,9 +109,10 @@ namespace TagLib {
       void read(bool readProperties, Properties::ReadStyle propertiesStyle);
       long long readLeadText();
       void readHeader(const EBMLReader &header);
-      void readSegment(const EBMLReader &element, AudioProperties::ReadStyle propertiesStyle, bool retry = true);
+      void readSegment(const EBMLReader &element, bool readProperties,
+                       AudioProperties::ReadStyle propertiesStyle, bool retry = true);
       std::vector<EBMLReader> readSegments(const EBMLReader& element, bool allowSeekHead);
-      void readSegmentInfo(const EBMLReader &element);
+      void readSegmentInfo(const EBMLReader &element, Properties::ReadStyle propertiesStyle);
       bool readSeekHead(const EBMLReader &element, std::vector<EBMLReader> &segmList);
       void readTags(const EBMLReader &element) const;
       void readTag(const EBMLReader &element) const;
@@ -23,9 +23,35 @@
 
 #include "matroskaproperties.h"
 #include "ebmlreader.h"
+#include <tbytereader.h>
+#include <algorithm>
 
 using namespace TagLib;
 
+namespace
+{
+  // Reads the time code of the (Simple)Block \a block, which is relative to
+  // that of its Cluster and follows the track number of the block, and
+  // raises \a timeCode to it.  Blocks need not be in presentation order.
+
+  bool readBlockTimeCode(const Matroska::EBMLReader &block, long long &timeCode)
+  {
+    const ByteVector data = block.readBytes(12);
+    Utils::ByteReader reader(data);
+
+    unsigned long long trackNumber = 0;
+    unsigned int trackNumberLength = 0;
+    unsigned short relativeTimeCode = 0;
+    if (!reader.readVInt(trackNumber, trackNumberLength) ||
+        !reader.readShort(relativeTimeCode)) {
+      return false;
+    }
+
+    timeCode = std::max(timeCode, static_cast<long long>(static_cast<short>(relativeTimeCode)));
+    return true;
+  }
+}
+
 class Matroska::Properties::PropertiesPrivate
 {
 public:
@@ -112,3 +138,77 @@ void Matroska::Properties::read(const Matroska::EBMLReader &data)
     }
 }
 
+void Matroska::Properties::readClusters(const Matroska::EBMLReader &segment)
+{
+  // Hop over the top level elements, reading only their headers, to find
+  // the last Cluster.
+
+  long long lastCluster = -1;
+  long long i = 0;
+  while (i < segment.getDataSize()) {
+      EBMLReader child (segment, segment.getDataOffset() + i);
+      if (!child.isValid() || child.size() <= 0) {
+          break;
+        }
+      if (child.id() == Cluster) {
+          lastCluster = segment.getDataOffset() + i;
+        }
+      i += child.size();
+    }
+
+  if (lastCluster < 0) {
+      return;
+    }
+
+  const EBMLReader cluster (segment, lastCluster);
+
+  long long clusterTimeCode = 0;
+  long long blockTimeCode = -32768;
+  bool hasBlock = false;
+
+  i = 0;
+  while (i < cluster.getDataSize()) {
+      EBMLReader child (cluster, cluster.getDataOffset() + i);
+      if (!child.isValid() || child.size() <= 0) {
+          break;
+        }
+
+      switch (child.id()) {
+        case ClusterTimeCode:
+          clusterTimeCode = static_cast<long long>(child.readUInt());
+          break;
+        case SimpleBlock:
+          hasBlock = readBlockTimeCode(child, blockTimeCode) || hasBlock;
+          break;
+        case BlockGroup: {
+            long long j = 0;
+            while (j < child.getDataSize()) {
+                EBMLReader block (child, child.getDataOffset() + j);
+                if (!block.isValid() || block.size() <= 0) {
+                    break;
+                  }
+                if (block.id() == Block) {
+                    hasBlock = readBlockTimeCode(block, blockTimeCode) || hasBlock;
+                    break;
+                  }
+                j += block.size();
+              }
+            break;
+          }
+        default:
+          break;
+        }
+
+      i += child.size();
+    }
+
+  if (!hasBlock) {
+      return;
+    }
+
+  const long long timeCode = clusterTimeCode + blockTimeCode;
+  if (timeCode > 0) {
+      const double timeScale = d->timeScale > 0 ? d->timeScale : 1000000.0;
+      d->length = static_cast<unsigned int>(timeCode * timeScale / 1000000.0 + 0.5);
+    }
+}
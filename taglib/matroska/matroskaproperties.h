@@ -34,6 +34,12 @@ namespace TagLib {
     /*!
      * This reads the data from a Matroska stream found in the AudioProperties
      * API.
+     *
+     * The length is taken from the Duration of the SegmentInfo, which is
+     * all that is read with the Fast and Average ReadStyle.  With Accurate
+     * the top level elements of the Segment are walked to its last Cluster,
+     * and the length is that of the time code of the last block in it,
+     * which is also right for files muxed without a Duration.
      */
 
     class TAGLIB_EXPORT Properties : public TagLib::AudioProperties
@@ -65,6 +71,9 @@ namespace TagLib {
       Properties &operator=(const Properties &);
 
       void read(const TagLib::Matroska::EBMLReader &data);
+      void readClusters(const TagLib::Matroska::EBMLReader &segment);
+
+      friend class File;
 
       class PropertiesPrivate;
       PropertiesPrivate *d;
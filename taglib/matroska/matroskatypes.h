@@ -76,6 +76,18 @@ namespace TagLib {
 
       ChapterTranslate = 0x6924,
 
+      /* IDs in the Cluster master */
+
+      ClusterTimeCode = 0xE7,
+
+      SimpleBlock = 0xA3,
+
+      BlockGroup = 0xA0,
+
+      /* ID in the BlockGroup master */
+
+      Block = 0xA1,
+
       /* ID in the Tracks master */
 
       TrackEntry = 0xAE,
@@ -37,21 +37,22 @@ const char *MP4::Atom::containers[11] = {
     "stsd"
 };
 
-MP4::Atom::Atom(File *file)
+MP4::Atom::Atom(File *file, long long atomOffset) :
+  offset(atomOffset),
+  length(0)
 {
-  children.setAutoDelete(true);
+  // The header is 8 bytes, followed by a 64-bit length if the 32-bit one is
+  // 1, so read enough for both at once.
 
-  offset = file->tell();
-  ByteVector header = file->readBlock(8);
-  if(header.size() != 8) {
+  const ByteVector header = file->readAt(offset, 16);
+  if(header.size() < 8) {
     // The atom header must be 8 bytes long, otherwise there is either
     // trailing garbage or the file is truncated
     debug("MP4: Couldn't read 8 bytes of data for atom header");
-    length = 0;
-    file->seek(0, File::End);
     return;
   }
 
+  long long dataOffset = offset + 8;
   length = header.toUInt();
 
   if(length == 0) {
@@ -60,13 +61,13 @@ MP4::Atom::Atom(File *file)
   }
   else if(length == 1) {
     // The atom has a 64-bit length.
-    length = file->readBlock(8).toLongLong();
+    length = header.size() == 16 ? header.toLongLong(8U) : 0;
+    dataOffset += 8;
   }
 
   if(length < 8) {
     debug("MP4: Invalid atom size");
     length = 0;
-    file->seek(0, File::End);
     return;
   }
 
@@ -75,26 +76,27 @@ MP4::Atom::Atom(File *file)
   for(int i = 0; i < numContainers; i++) {
     if(name == containers[i]) {
       if(name == "meta") {
-        file->seek(4, File::Current);
+        dataOffset += 4;
       }
       else if(name == "stsd") {
-        file->seek(8, File::Current);
+        dataOffset += 8;
       }
-      while(file->tell() < offset + length) {
-        MP4::Atom *child = new MP4::Atom(file);
-        children.append(child);
+      while(dataOffset < offset + length) {
+        MP4::Atom *child = new MP4::Atom(file, dataOffset);
+        children.push_back(child);
         if(child->length == 0)
           return;
+        dataOffset += child->length;
       }
       return;
     }
   }
-
-  file->seek(offset + length);
 }
 
 MP4::Atom::~Atom()
 {
+  for(AtomList::const_iterator it = children.begin(); it != children.end(); ++it)
+    delete *it;
 }
 
 MP4::Atom *
@@ -103,7 +105,7 @@ MP4::Atom::find(const char *name1, const char *name2, const char *name3, const c
   if(name1 == 0) {
     return this;
   }
-  for(AtomList::ConstIterator it = children.begin(); it != children.end(); ++it) {
+  for(AtomList::const_iterator it = children.begin(); it != children.end(); ++it) {
     if((*it)->name == name1) {
       return (*it)->find(name2, name3, name4);
     }
@@ -115,12 +117,13 @@ MP4::AtomList
 MP4::Atom::findall(const char *name, bool recursive)
 {
   MP4::AtomList result;
-  for(AtomList::ConstIterator it = children.begin(); it != children.end(); ++it) {
+  for(AtomList::const_iterator it = children.begin(); it != children.end(); ++it) {
     if((*it)->name == name) {
-      result.append(*it);
+      result.push_back(*it);
     }
     if(recursive) {
-      result.append((*it)->findall(name, recursive));
+      const AtomList found = (*it)->findall(name, recursive);
+      result.insert(result.end(), found.begin(), found.end());
     }
   }
   return result;
@@ -129,11 +132,11 @@ MP4::Atom::findall(const char *name, bool recursive)
 bool
 MP4::Atom::path(MP4::AtomList &path, const char *name1, const char *name2, const char *name3)
 {
-  path.append(this);
+  path.push_back(this);
   if(name1 == 0) {
     return true;
   }
-  for(AtomList::ConstIterator it = children.begin(); it != children.end(); ++it) {
+  for(AtomList::const_iterator it = children.begin(); it != children.end(); ++it) {
     if((*it)->name == name1) {
       return (*it)->path(path, name2, name3);
     }
@@ -143,27 +146,27 @@ MP4::Atom::path(MP4::AtomList &path, const char *name1, const char *name2, const
 
 MP4::Atoms::Atoms(File *file)
 {
-  atoms.setAutoDelete(true);
-
-  file->seek(0, File::End);
-  long long end = file->tell();
-  file->seek(0);
-  while(file->tell() + 8 <= end) {
-    MP4::Atom *atom = new MP4::Atom(file);
-    atoms.append(atom);
+  const long long end = file->length();
+  long long offset = 0;
+  while(offset + 8 <= end) {
+    MP4::Atom *atom = new MP4::Atom(file, offset);
+    atoms.push_back(atom);
     if (atom->length == 0)
       break;
+    offset += atom->length;
   }
 }
 
 MP4::Atoms::~Atoms()
 {
+  for(AtomList::const_iterator it = atoms.begin(); it != atoms.end(); ++it)
+    delete *it;
 }
 
 MP4::Atom *
 MP4::Atoms::find(const char *name1, const char *name2, const char *name3, const char *name4)
 {
-  for(AtomList::ConstIterator it = atoms.begin(); it != atoms.end(); ++it) {
+  for(AtomList::const_iterator it = atoms.begin(); it != atoms.end(); ++it) {
     if((*it)->name == name1) {
       return (*it)->find(name2, name3, name4);
     }
@@ -175,7 +178,7 @@ MP4::AtomList
 MP4::Atoms::path(const char *name1, const char *name2, const char *name3, const char *name4)
 {
   MP4::AtomList path;
-  for(AtomList::ConstIterator it = atoms.begin(); it != atoms.end(); ++it) {
+  for(AtomList::const_iterator it = atoms.begin(); it != atoms.end(); ++it) {
     if((*it)->name == name1) {
       if(!(*it)->path(path, name2, name3, name4)) {
         path.clear();
@@ -30,6 +30,8 @@
 #ifndef TAGLIB_MP4ATOM_H
 #define TAGLIB_MP4ATOM_H
 
+#include <vector>
+
 #include "tfile.h"
 #include "tlist.h"
 
@@ -38,7 +40,9 @@ namespace TagLib {
   namespace MP4 {
 
     class Atom;
-    typedef TagLib::List<Atom *> AtomList;
+    // Atoms are walked far more often than they are inserted, so the tree is
+    // kept in contiguous storage rather than in a linked list.
+    typedef std::vector<Atom *> AtomList;
 
     enum AtomDataType
     {
@@ -77,7 +81,7 @@ namespace TagLib {
     class Atom
     {
     public:
-      Atom(File *file);
+      Atom(File *file, long long offset);
       ~Atom();
       Atom *find(const char *name1, const char *name2 = 0, const char *name3 = 0, const char *name4 = 0);
       bool path(AtomList &path, const char *name1, const char *name2 = 0, const char *name3 = 0);
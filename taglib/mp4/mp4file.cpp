@@ -38,7 +38,7 @@ namespace
 {
   bool checkValid(const MP4::AtomList &list)
   {
-    for(MP4::AtomList::ConstIterator it = list.begin(); it != list.end(); ++it) {
+    for(MP4::AtomList::const_iterator it = list.begin(); it != list.end(); ++it) {
 
       if((*it)->length == 0)
         return false;
@@ -103,6 +103,15 @@ MP4::File::File(IOStream *stream, bool readProperties, AudioProperties::ReadStyl
     read(readProperties);
 }
 
+MP4::File::File(IOStream *stream, ReadOptions readOptions, AudioProperties::ReadStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 MP4::File::~File()
 {
   delete d;
@@ -119,6 +128,14 @@ PropertyMap MP4::File::properties() const
   return d->tag->properties();
 }
 
+PictureHandleList MP4::File::pictureHandles() const
+{
+  if(d->tag)
+    return d->tag->pictureHandles();
+
+  return PictureHandleList();
+}
+
 void MP4::File::removeUnsupportedProperties(const StringList &properties)
 {
   d->tag->removeUnsupportedProperties(properties);
@@ -69,6 +69,17 @@ namespace TagLib {
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle audioPropertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an MP4 file from \a stream, reading only the parts of it
+       * given by \a readOptions, a combination of TagLib::File::ReadOptions.
+       *
+       * \note TagLib will *not* take ownership of the stream, the caller is
+       * responsible for deleting it after the File object.
+       *
+       * \note In the current implementation, \a propertiesStyle is ignored.
+       */
+      File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle audioPropertiesStyle);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -91,6 +102,13 @@ namespace TagLib {
        */
       PropertyMap properties() const;
 
+      /*!
+       * Returns handles to the cover art of the file.
+       *
+       * \see MP4::Tag::pictureHandles()
+       */
+      PictureHandleList pictureHandles() const;
+
       /*!
        * Removes unsupported properties. Forwards to the actual Tag's
        * removeUnsupportedProperties() function.
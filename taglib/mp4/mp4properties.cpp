@@ -148,7 +148,7 @@ MP4::Properties::readAudioData(File *file, Atoms *atoms)
   ByteVector data;
 
   const MP4::AtomList trakList = moov->findall("trak");
-  for(MP4::AtomList::ConstIterator it = trakList.begin(); it != trakList.end(); ++it) {
+  for(MP4::AtomList::const_iterator it = trakList.begin(); it != trakList.end(); ++it) {
     trak = *it;
     MP4::Atom *hdlr = trak->find("mdia", "hdlr");
     if(!hdlr) {
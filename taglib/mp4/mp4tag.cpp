@@ -23,6 +23,8 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tdebug.h>
 #include <tstring.h>
 #include <tpropertymap.h>
@@ -32,6 +34,88 @@
 
 using namespace TagLib;
 
+namespace
+{
+  const int itemReadOptions = File::ReadTags | File::ReadPictures;
+
+  // Returns whether an item in an atom named \a name is one of the parts of
+  // the file given by the read options.
+
+  bool isItemWanted(const ByteVector &name, int options)
+  {
+    if((options & itemReadOptions) == itemReadOptions)
+      return true;
+
+    if(name == "covr")
+      return (options & File::ReadPictures) != 0;
+
+    if(name == "\251nam" || name == "\251ART" || name == "\251alb" || name == "\251cmt" ||
+       name == "\251gen" || name == "gnre" || name == "\251day" || name == "trkn")
+      return (options & File::ReadBasicTags) != 0;
+
+    return (options & File::ReadExtendedTags) != 0;
+  }
+
+  String coverArtMimeType(int format)
+  {
+    switch(format) {
+    case MP4::CoverArt::JPEG:
+      return "image/jpeg";
+    case MP4::CoverArt::PNG:
+      return "image/png";
+    case MP4::CoverArt::BMP:
+      return "image/bmp";
+    case MP4::CoverArt::GIF:
+      return "image/gif";
+    default:
+      return String();
+    }
+  }
+
+  // Cover art has no picture type, but is shown as the front cover.
+
+  const int coverArtPictureType = 3;
+
+  // Appends handles to the pictures of the "covr" atom \a atom to \a pictures,
+  // reading only the headers of its "data" atoms.
+
+  void readCovrHandles(TagLib::File *file, const MP4::Atom *atom, PictureHandleList &pictures)
+  {
+    long long offset = atom->offset + 8;
+    const long long end = atom->offset + atom->length;
+
+    while(offset + 16 <= end) {
+      file->seek(offset);
+      const ByteVector header = file->readBlock(16);
+      if(header.size() != 16)
+        break;
+
+      const unsigned int length = header.toUInt(0U);
+      if(length < 16 || offset + length > end) {
+        debug("MP4: Too short atom");
+        break;
+      }
+
+      if(!header.containsAt("data", 4)) {
+        debug("MP4: Unexpected atom \"" + header.mid(4, 4) + "\", expecting \"data\"");
+        break;
+      }
+
+      const int flags = static_cast<int>(header.toUInt(8U));
+      if(flags == MP4::TypeJPEG || flags == MP4::TypePNG || flags == MP4::TypeBMP ||
+         flags == MP4::TypeGIF || flags == MP4::TypeImplicit) {
+        pictures.append(PictureHandle(file, offset + 16, length - 16,
+                                      coverArtMimeType(flags), coverArtPictureType, String()));
+      }
+      else {
+        debug("MP4: Unknown covr format " + String::number(flags));
+      }
+
+      offset += length;
+    }
+  }
+}
+
 class MP4::Tag::TagPrivate
 {
 public:
@@ -42,6 +126,7 @@ public:
   TagLib::File *file;
   Atoms *atoms;
   ItemMap items;
+  PictureHandleList pictureHandles;
 };
 
 MP4::Tag::Tag() :
@@ -61,8 +146,16 @@ MP4::Tag::Tag(TagLib::File *file, MP4::Atoms *atoms) :
     return;
   }
 
-  for(AtomList::ConstIterator it = ilst->children.begin(); it != ilst->children.end(); ++it) {
+  const int options = file->readOptions();
+
+  for(AtomList::const_iterator it = ilst->children.begin(); it != ilst->children.end(); ++it) {
     MP4::Atom *atom = *it;
+    if(!isItemWanted(atom->name, options)) {
+      if(atom->name == "covr" && (options & File::ReadPictureHandles))
+        readCovrHandles(file, atom, d->pictureHandles);
+      continue;
+    }
+
     file->seek(atom->offset + 8);
     if(atom->name == "----") {
       parseFreeForm(atom);
@@ -317,6 +410,23 @@ MP4::Tag::parseCovr(const MP4::Atom *atom)
     addItem(atom->name, value);
 }
 
+PictureHandleList
+MP4::Tag::pictureHandles() const
+{
+  PictureHandleList handles = d->pictureHandles;
+
+  const ItemMap::ConstIterator covr = d->items.find("covr");
+  if(covr != d->items.end()) {
+    const CoverArtList pictures = covr->second.toCoverArtList();
+    for(CoverArtList::ConstIterator it = pictures.begin(); it != pictures.end(); ++it) {
+      handles.append(PictureHandle(it->data(), coverArtMimeType(it->format()),
+                                   coverArtPictureType, String()));
+    }
+  }
+
+  return handles;
+}
+
 ByteVector
 MP4::Tag::padIlst(const ByteVector &data, int length) const
 {
@@ -526,10 +636,9 @@ MP4::Tag::updateParents(const AtomList &path, long delta, int ignore)
   if(static_cast<int>(path.size()) <= ignore)
     return;
 
-  AtomList::ConstIterator itEnd = path.end();
-  std::advance(itEnd, 0 - ignore);
+  const AtomList::const_iterator itEnd = path.end() - ignore;
 
-  for(AtomList::ConstIterator it = path.begin(); it != itEnd; ++it) {
+  for(AtomList::const_iterator it = path.begin(); it != itEnd; ++it) {
     d->file->seek((*it)->offset);
     long size = d->file->readBlock(4).toUInt();
     // 64-bit
@@ -554,7 +663,7 @@ MP4::Tag::updateOffsets(long delta, long offset)
   MP4::Atom *moov = d->atoms->find("moov");
   if(moov) {
     MP4::AtomList stco = moov->findall("stco", true);
-    for(MP4::AtomList::ConstIterator it = stco.begin(); it != stco.end(); ++it) {
+    for(MP4::AtomList::const_iterator it = stco.begin(); it != stco.end(); ++it) {
       MP4::Atom *atom = *it;
       if(atom->offset > offset) {
         atom->offset += delta;
@@ -575,7 +684,7 @@ MP4::Tag::updateOffsets(long delta, long offset)
     }
 
     MP4::AtomList co64 = moov->findall("co64", true);
-    for(MP4::AtomList::ConstIterator it = co64.begin(); it != co64.end(); ++it) {
+    for(MP4::AtomList::const_iterator it = co64.begin(); it != co64.end(); ++it) {
       MP4::Atom *atom = *it;
       if(atom->offset > offset) {
         atom->offset += delta;
@@ -599,7 +708,7 @@ MP4::Tag::updateOffsets(long delta, long offset)
   MP4::Atom *moof = d->atoms->find("moof");
   if(moof) {
     MP4::AtomList tfhd = moof->findall("tfhd", true);
-    for(MP4::AtomList::ConstIterator it = tfhd.begin(); it != tfhd.end(); ++it) {
+    for(MP4::AtomList::const_iterator it = tfhd.begin(); it != tfhd.end(); ++it) {
       MP4::Atom *atom = *it;
       if(atom->offset > offset) {
         atom->offset += delta;
@@ -641,25 +750,26 @@ MP4::Tag::saveNew(ByteVector data)
 
   // Insert the newly created atoms into the tree to keep it up-to-date.
 
-  d->file->seek(offset);
-  path.back()->children.prepend(new Atom(d->file));
+  AtomList &children = path.back()->children;
+  children.insert(children.begin(), new Atom(d->file, offset));
 }
 
 void
 MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
 {
-  AtomList::ConstIterator it = path.end();
+  AtomList::const_iterator it = path.end();
 
   MP4::Atom *ilst = *(--it);
   long offset = ilst->offset;
   long length = ilst->length;
 
   MP4::Atom *meta = *(--it);
-  AtomList::ConstIterator index = meta->children.find(ilst);
+  AtomList::const_iterator index =
+    std::find(meta->children.begin(), meta->children.end(), ilst);
 
   // check if there is an atom before 'ilst', and possibly use it as padding
   if(index != meta->children.begin()) {
-    AtomList::ConstIterator prevIndex = index;
+    AtomList::const_iterator prevIndex = index;
     prevIndex--;
     MP4::Atom *prev = *prevIndex;
     if(prev->name == "free") {
@@ -668,7 +778,7 @@ MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
     }
   }
   // check if there is an atom after 'ilst', and possibly use it as padding
-  AtomList::ConstIterator nextIndex = index;
+  AtomList::const_iterator nextIndex = index;
   nextIndex++;
   if(nextIndex != meta->children.end()) {
     MP4::Atom *next = *nextIndex;
@@ -81,6 +81,15 @@ namespace TagLib {
          */
         const ItemMap &itemMap() const;
 
+        /*!
+         * Returns handles to the cover art of this tag, including that which
+         * was not read because the file was opened with
+         * File::ReadPictureHandles rather than File::ReadPictures.
+         *
+         * \see File::pictureHandles()
+         */
+        PictureHandleList pictureHandles() const;
+
         /*!
          * \return The item, if any, corresponding to \a key.
          */
@@ -108,6 +108,15 @@ MPC::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
     read(readProperties);
 }
 
+MPC::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 MPC::File::~File()
 {
   delete d;
@@ -221,7 +221,9 @@ void ID3v1::Tag::setStringHandler(const StringHandler *handler)
 
 void ID3v1::Tag::read()
 {
-  if(d->file && d->file->isValid()) {
+  // All the fields of an ID3v1 tag are basic ones.
+
+  if(d->file && d->file->isValid() && (d->file->readOptions() & File::ReadBasicTags)) {
     d->file->seek(d->tagOffset);
     // read the tag -- always 128 bytes
     const ByteVector data = d->file->readBlock(128);
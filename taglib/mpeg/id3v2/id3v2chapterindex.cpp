@@ -0,0 +1,147 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <vector>
+
+#include <tdebug.h>
+#include <tstring.h>
+
+#include "id3v2chapterindex.h"
+
+using namespace TagLib;
+using namespace ID3v2;
+
+namespace
+{
+  bool startsAfter(unsigned int time, const ChapterIndex::Chapter &chapter)
+  {
+    return time < chapter.startTime;
+  }
+}
+
+class ChapterIndex::ChapterIndexPrivate
+{
+public:
+  std::vector<Chapter> chapters;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+ChapterIndex::Chapter::Chapter() :
+  startTime(0),
+  endTime(0),
+  startOffset(0xFFFFFFFF),
+  endOffset(0xFFFFFFFF)
+{
+}
+
+ChapterIndex::Chapter::Chapter(const ByteVector &id, unsigned int start, unsigned int end,
+                               unsigned int startOff, unsigned int endOff) :
+  elementID(id),
+  startTime(start),
+  endTime(end),
+  startOffset(startOff),
+  endOffset(endOff)
+{
+}
+
+ChapterIndex::ChapterIndex() :
+  d(new ChapterIndexPrivate())
+{
+}
+
+ChapterIndex::ChapterIndex(const ChapterIndex &index) :
+  d(new ChapterIndexPrivate(*index.d))
+{
+}
+
+ChapterIndex::~ChapterIndex()
+{
+  delete d;
+}
+
+ChapterIndex &ChapterIndex::operator=(const ChapterIndex &index)
+{
+  if(this != &index)
+    *d = *index.d;
+
+  return *this;
+}
+
+void ChapterIndex::append(const Chapter &chapter)
+{
+  // Chapters are usually in order, so this is mostly an append.
+
+  const std::vector<Chapter>::iterator it =
+    std::upper_bound(d->chapters.begin(), d->chapters.end(), chapter.startTime, startsAfter);
+  d->chapters.insert(it, chapter);
+}
+
+unsigned int ChapterIndex::size() const
+{
+  return static_cast<unsigned int>(d->chapters.size());
+}
+
+bool ChapterIndex::isEmpty() const
+{
+  return d->chapters.empty();
+}
+
+ChapterIndex::Chapter ChapterIndex::operator[](unsigned int index) const
+{
+  if(index >= d->chapters.size()) {
+    debug("ChapterIndex::operator[]() -- Index out of range.");
+    return Chapter();
+  }
+
+  return d->chapters[index];
+}
+
+int ChapterIndex::chapterAt(unsigned int milliseconds) const
+{
+  const std::vector<Chapter>::const_iterator it =
+    std::upper_bound(d->chapters.begin(), d->chapters.end(), milliseconds, startsAfter);
+
+  if(it == d->chapters.begin())
+    return -1;
+
+  const std::vector<Chapter>::const_iterator chapter = it - 1;
+  if(chapter->endTime <= milliseconds)
+    return -1;
+
+  return static_cast<int>(chapter - d->chapters.begin());
+}
+
+int ChapterIndex::find(const ByteVector &elementID) const
+{
+  for(std::vector<Chapter>::const_iterator it = d->chapters.begin(); it != d->chapters.end(); ++it) {
+    if(it->elementID == elementID)
+      return static_cast<int>(it - d->chapters.begin());
+  }
+
+  return -1;
+}
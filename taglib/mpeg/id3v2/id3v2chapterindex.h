@@ -0,0 +1,131 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_ID3V2CHAPTERINDEX_H
+#define TAGLIB_ID3V2CHAPTERINDEX_H
+
+#include "taglib_export.h"
+#include "tbytevector.h"
+
+namespace TagLib {
+
+  namespace ID3v2 {
+
+    //! The times of the chapters of an ID3v2 tag
+
+    /*!
+     * This holds the element ID and the times and offsets of each CHAP frame
+     * of a tag, in the order of their start times, and finds the chapter at a
+     * time with a binary search.  It is made by Tag::chapterIndex().
+     *
+     * With File::ReadFramesOnDemand the CHAP frames are not parsed to make the
+     * index; only their first bytes are read.  Their embedded frames, such as
+     * titles and pictures, are parsed when Tag::chapterFrame() asks for the
+     * chapter.
+     *
+     * \see ChapterFrame
+     */
+
+    class TAGLIB_EXPORT ChapterIndex
+    {
+    public:
+      /*!
+       * A chapter of the index.  All times are in milliseconds.
+       */
+      struct Chapter {
+        Chapter();
+        Chapter(const ByteVector &id, unsigned int start, unsigned int end,
+                unsigned int startOff, unsigned int endOff);
+
+        ByteVector elementID;
+        unsigned int startTime;
+        unsigned int endTime;
+        unsigned int startOffset;
+        unsigned int endOffset;
+      };
+
+      /*!
+       * Constructs an empty index.
+       */
+      ChapterIndex();
+
+      /*!
+       * Makes a copy of \a index.
+       */
+      ChapterIndex(const ChapterIndex &index);
+
+      /*!
+       * Destroys this index.
+       */
+      ~ChapterIndex();
+
+      /*!
+       * Copies the contents of \a index into this index.
+       */
+      ChapterIndex &operator=(const ChapterIndex &index);
+
+      /*!
+       * Adds \a chapter to the index, keeping the chapters in the order of
+       * their start times.
+       */
+      void append(const Chapter &chapter);
+
+      /*!
+       * Returns the number of chapters.
+       */
+      unsigned int size() const;
+
+      /*!
+       * Returns true if there are no chapters.
+       */
+      bool isEmpty() const;
+
+      /*!
+       * Returns the chapter at \a index, in the order of their start times.
+       * Returns an empty chapter if \a index is out of range.
+       */
+      Chapter operator[](unsigned int index) const;
+
+      /*!
+       * Returns the position of the chapter playing at \a milliseconds, which
+       * is the last to start at or before it and ends after it, or -1 if no
+       * chapter is playing then.  This takes O(log n) time.
+       */
+      int chapterAt(unsigned int milliseconds) const;
+
+      /*!
+       * Returns the position of the chapter with the element ID \a elementID,
+       * or -1 if there is none.
+       */
+      int find(const ByteVector &elementID) const;
+
+    private:
+      class ChapterIndexPrivate;
+      ChapterIndexPrivate *d;
+    };
+
+  }
+}
+
+#endif
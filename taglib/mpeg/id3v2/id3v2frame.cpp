@@ -28,6 +28,7 @@
 #include <tdebug.h>
 #include <tstringlist.h>
 #include <tzlib.h>
+#include <tkeyindex.h>
 
 #include "id3v2tag.h"
 #include "id3v2frame.h"
@@ -61,6 +62,9 @@ public:
 
 namespace
 {
+  // The size of a tag is a 28 bit integer, so a frame can hold no more.
+  const unsigned int MaxDecompressedSize = 256 * 1024 * 1024;
+
   bool isValidFrameID(const ByteVector &frameID)
   {
     if(frameID.size() != 4)
@@ -251,7 +255,11 @@ ByteVector Frame::fieldData(const ByteVector &frameData) const
       return ByteVector();
     }
 
-    const ByteVector outData = zlib::decompress(frameData.mid(frameDataOffset));
+    // The data length indicator is only used as a hint, since it is wrong in
+    // some files.
+
+    const ByteVector outData = zlib::decompress(frameData.mid(frameDataOffset),
+                                                frameDataLength, MaxDecompressedSize);
     if(!outData.isEmpty() && frameDataLength != outData.size()) {
       debug("frameDataLength does not match the data length returned by zlib");
     }
@@ -419,6 +427,36 @@ namespace
   const size_t deprecatedFramesSize = sizeof(deprecatedFrames) / sizeof(deprecatedFrames[0]);;
 }
 
+namespace
+{
+  // The translation tables are consulted for every frame and every property
+  // key in properties() and setProperties(), so they are hashed once.
+
+  const Utils::KeyIndex &frameIDIndex()
+  {
+    static const Utils::KeyIndex index(frameTranslation, frameTranslationSize, 0);
+    return index;
+  }
+
+  const Utils::KeyIndex &keyIndex()
+  {
+    static const Utils::KeyIndex index(frameTranslation, frameTranslationSize, 1);
+    return index;
+  }
+
+  const Utils::KeyIndex &txxxDescriptionIndex()
+  {
+    static const Utils::KeyIndex index(txxxFrameTranslation, txxxFrameTranslationSize, 0);
+    return index;
+  }
+
+  const Utils::KeyIndex &txxxKeyIndex()
+  {
+    static const Utils::KeyIndex index(txxxFrameTranslation, txxxFrameTranslationSize, 1);
+    return index;
+  }
+}
+
 String Frame::frameIDToKey(const ByteVector &id)
 {
   ByteVector id24 = id;
@@ -428,40 +466,33 @@ String Frame::frameIDToKey(const ByteVector &id)
       break;
     }
   }
-  for(size_t i = 0; i < frameTranslationSize; ++i) {
-    if(id24 == frameTranslation[i][0])
-      return frameTranslation[i][1];
-  }
+  const int row = frameIDIndex().find(id24);
+  if(row >= 0)
+    return frameTranslation[row][1];
   return String();
 }
 
 ByteVector Frame::keyToFrameID(const String &s)
 {
-  const String key = s.upper();
-  for(size_t i = 0; i < frameTranslationSize; ++i) {
-    if(key == frameTranslation[i][1])
-      return frameTranslation[i][0];
-  }
+  const int row = keyIndex().find(s);
+  if(row >= 0)
+    return frameTranslation[row][0];
   return ByteVector();
 }
 
 String Frame::txxxToKey(const String &description)
 {
-  const String d = description.upper();
-  for(size_t i = 0; i < txxxFrameTranslationSize; ++i) {
-    if(d == txxxFrameTranslation[i][0])
-      return txxxFrameTranslation[i][1];
-  }
-  return d;
+  const int row = txxxDescriptionIndex().find(description);
+  if(row >= 0)
+    return txxxFrameTranslation[row][1];
+  return description.upper();
 }
 
 String Frame::keyToTXXX(const String &s)
 {
-  const String key = s.upper();
-  for(size_t i = 0; i < txxxFrameTranslationSize; ++i) {
-    if(key == txxxFrameTranslation[i][1])
-      return txxxFrameTranslation[i][0];
-  }
+  const int row = txxxKeyIndex().find(s);
+  if(row >= 0)
+    return txxxFrameTranslation[row][0];
   return s;
 }
 
@@ -23,6 +23,8 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tdebug.h>
 #include <tzlib.h>
 
@@ -53,6 +55,27 @@ using namespace ID3v2;
 
 namespace
 {
+  // Frame IDs are compared as 32 bit integers, with the characters in order
+  // from the most significant byte, so that they can be switched on and
+  // sorted.  The last byte of an ID3v2.2 ID is 0.
+
+  constexpr unsigned int packedID(const char *id)
+  {
+    return (static_cast<unsigned int>(static_cast<unsigned char>(id[0])) << 24) |
+           (static_cast<unsigned int>(static_cast<unsigned char>(id[1])) << 16) |
+           (static_cast<unsigned int>(static_cast<unsigned char>(id[2])) << 8)  |
+           static_cast<unsigned int>(static_cast<unsigned char>(id[3]));
+  }
+
+  unsigned int packFrameID(const ByteVector &id)
+  {
+    if(id.size() < 3 || id.size() > 4)
+      return 0;
+
+    const char packed[4] = { id[0], id[1], id[2], id.size() == 4 ? id[3] : '\0' };
+    return packedID(packed);
+  }
+
   void updateGenre(TextIdentificationFrame *frame)
   {
     StringList fields = frame->fieldList();
@@ -192,30 +215,44 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
   frameID = header->frameID();
 
   // This is where things get necissarily nasty.  Here we determine which
-  // Frame subclass (or if none is found simply an Frame) based
-  // on the frame ID.  Since there are a lot of possibilities, that means
-  // a lot of if blocks.
+  // Frame subclass (or if none is found simply an Frame) based on the frame
+  // ID.  Since there are a lot of possibilities, the ID is switched on as an
+  // integer rather than compared with each of them in turn.
 
-  // Text Identification (frames 4.2)
+  switch(packFrameID(frameID)) {
 
-  // Apple proprietary WFED (Podcast URL), MVNM (Movement Name), MVIN (Movement Number) are in fact text frames.
-  if(frameID.startsWith("T") || frameID == "WFED" || frameID == "MVNM" || frameID == "MVIN") {
+  // Text Identification (frames 4.2)
 
-    TextIdentificationFrame *f = frameID != "TXXX"
-      ? new TextIdentificationFrame(data, header)
-      : new UserTextIdentificationFrame(data, header);
+  case packedID("TXXX"):
+  {
+    UserTextIdentificationFrame *f = new UserTextIdentificationFrame(data, header);
+    d->setTextEncoding(f);
+    return f;
+  }
 
+  case packedID("TCON"):
+  {
+    TextIdentificationFrame *f = new TextIdentificationFrame(data, header);
     d->setTextEncoding(f);
+    updateGenre(f);
+    return f;
+  }
 
-    if(frameID == "TCON")
-      updateGenre(f);
+  // Apple proprietary WFED (Podcast URL), MVNM (Movement Name), MVIN (Movement Number) are in fact text frames.
 
+  case packedID("WFED"):
+  case packedID("MVNM"):
+  case packedID("MVIN"):
+  {
+    TextIdentificationFrame *f = new TextIdentificationFrame(data, header);
+    d->setTextEncoding(f);
     return f;
   }
 
   // Comments (frames 4.10)
 
-  if(frameID == "COMM") {
+  case packedID("COMM"):
+  {
     CommentsFrame *f = new CommentsFrame(data, header);
     d->setTextEncoding(f);
     return f;
@@ -223,7 +260,8 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Attached Picture (frames 4.14)
 
-  if(frameID == "APIC") {
+  case packedID("APIC"):
+  {
     AttachedPictureFrame *f = new AttachedPictureFrame(data, header);
     d->setTextEncoding(f);
     return f;
@@ -231,7 +269,8 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // ID3v2.2 Attached Picture
 
-  if(frameID == "PIC") {
+  case packedID("PIC"):
+  {
     AttachedPictureFrame *f = new AttachedPictureFrameV22(data, header);
     d->setTextEncoding(f);
     return f;
@@ -239,17 +278,18 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Relative Volume Adjustment (frames 4.11)
 
-  if(frameID == "RVA2")
+  case packedID("RVA2"):
     return new RelativeVolumeFrame(data, header);
 
   // Unique File Identifier (frames 4.1)
 
-  if(frameID == "UFID")
+  case packedID("UFID"):
     return new UniqueFileIdentifierFrame(data, header);
 
   // General Encapsulated Object (frames 4.15)
 
-  if(frameID == "GEOB") {
+  case packedID("GEOB"):
+  {
     GeneralEncapsulatedObjectFrame *f = new GeneralEncapsulatedObjectFrame(data, header);
     d->setTextEncoding(f);
     return f;
@@ -257,20 +297,17 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // URL link (frames 4.3)
 
-  if(frameID.startsWith("W")) {
-    if(frameID != "WXXX") {
-      return new UrlLinkFrame(data, header);
-    }
-    else {
-      UserUrlLinkFrame *f = new UserUrlLinkFrame(data, header);
-      d->setTextEncoding(f);
-      return f;
-    }
+  case packedID("WXXX"):
+  {
+    UserUrlLinkFrame *f = new UserUrlLinkFrame(data, header);
+    d->setTextEncoding(f);
+    return f;
   }
 
   // Unsynchronized lyric/text transcription (frames 4.8)
 
-  if(frameID == "USLT") {
+  case packedID("USLT"):
+  {
     UnsynchronizedLyricsFrame *f = new UnsynchronizedLyricsFrame(data, header);
     if(d->useDefaultEncoding)
       f->setTextEncoding(d->defaultEncoding);
@@ -279,7 +316,8 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Synchronised lyrics/text (frames 4.9)
 
-  if(frameID == "SYLT") {
+  case packedID("SYLT"):
+  {
     SynchronizedLyricsFrame *f = new SynchronizedLyricsFrame(data, header);
     if(d->useDefaultEncoding)
       f->setTextEncoding(d->defaultEncoding);
@@ -288,22 +326,23 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Event timing codes (frames 4.5)
 
-  if(frameID == "ETCO")
+  case packedID("ETCO"):
     return new EventTimingCodesFrame(data, header);
 
   // Popularimeter (frames 4.17)
 
-  if(frameID == "POPM")
+  case packedID("POPM"):
     return new PopularimeterFrame(data, header);
 
   // Private (frames 4.27)
 
-  if(frameID == "PRIV")
+  case packedID("PRIV"):
     return new PrivateFrame(data, header);
 
   // Ownership (frames 4.22)
 
-  if(frameID == "OWNE") {
+  case packedID("OWNE"):
+  {
     OwnershipFrame *f = new OwnershipFrame(data, header);
     d->setTextEncoding(f);
     return f;
@@ -311,19 +350,34 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Chapter (ID3v2 chapters 1.0)
 
-  if(frameID == "CHAP")
+  case packedID("CHAP"):
     return new ChapterFrame(tagHeader, data, header);
 
   // Table of contents (ID3v2 chapters 1.0)
 
-  if(frameID == "CTOC")
+  case packedID("CTOC"):
     return new TableOfContentsFrame(tagHeader, data, header);
 
   // Apple proprietary PCST (Podcast)
 
-  if(frameID == "PCST")
+  case packedID("PCST"):
     return new PodcastFrame(data, header);
 
+  default:
+    break;
+  }
+
+  // The rest of the text and URL link frames.
+
+  if(frameID.startsWith("T")) {
+    TextIdentificationFrame *f = new TextIdentificationFrame(data, header);
+    d->setTextEncoding(f);
+    return f;
+  }
+
+  if(frameID.startsWith("W"))
+    return new UrlLinkFrame(data, header);
+
   return new UnknownFrame(data, header);
 }
 
@@ -386,145 +440,169 @@ FrameFactory::~FrameFactory()
 
 namespace
 {
+  struct FrameConversion
+  {
+    unsigned int from;
+    const char *to;
+  };
+
+  bool operator<(const FrameConversion &conversion, unsigned int id)
+  {
+    return conversion.from < id;
+  }
+
+  // The conversion tables are sorted by the packed IDs, so that they can be
+  // searched in O(log n), which is checked when they are compiled.
+
+  template <size_t N>
+  constexpr bool isSorted(const FrameConversion (&table)[N], size_t i = 1)
+  {
+    return i >= N || (table[i - 1].from < table[i].from && isSorted(table, i + 1));
+  }
+
   // Frame conversion table ID3v2.2 -> 2.4
-  const char *frameConversion2[][2] = {
-    { "BUF", "RBUF" },
-    { "CNT", "PCNT" },
-    { "COM", "COMM" },
-    { "CRA", "AENC" },
-    { "ETC", "ETCO" },
-    { "GEO", "GEOB" },
-    { "IPL", "TIPL" },
-    { "MCI", "MCDI" },
-    { "MLL", "MLLT" },
-    { "POP", "POPM" },
-    { "REV", "RVRB" },
-    { "SLT", "SYLT" },
-    { "STC", "SYTC" },
-    { "TAL", "TALB" },
-    { "TBP", "TBPM" },
-    { "TCM", "TCOM" },
-    { "TCO", "TCON" },
-    { "TCP", "TCMP" },
-    { "TCR", "TCOP" },
-    { "TDY", "TDLY" },
-    { "TEN", "TENC" },
-    { "TFT", "TFLT" },
-    { "TKE", "TKEY" },
-    { "TLA", "TLAN" },
-    { "TLE", "TLEN" },
-    { "TMT", "TMED" },
-    { "TOA", "TOAL" },
-    { "TOF", "TOFN" },
-    { "TOL", "TOLY" },
-    { "TOR", "TDOR" },
-    { "TOT", "TOAL" },
-    { "TP1", "TPE1" },
-    { "TP2", "TPE2" },
-    { "TP3", "TPE3" },
-    { "TP4", "TPE4" },
-    { "TPA", "TPOS" },
-    { "TPB", "TPUB" },
-    { "TRC", "TSRC" },
-    { "TRD", "TDRC" },
-    { "TRK", "TRCK" },
-    { "TS2", "TSO2" },
-    { "TSA", "TSOA" },
-    { "TSC", "TSOC" },
-    { "TSP", "TSOP" },
-    { "TSS", "TSSE" },
-    { "TST", "TSOT" },
-    { "TT1", "TIT1" },
-    { "TT2", "TIT2" },
-    { "TT3", "TIT3" },
-    { "TXT", "TOLY" },
-    { "TXX", "TXXX" },
-    { "TYE", "TDRC" },
-    { "UFI", "UFID" },
-    { "ULT", "USLT" },
-    { "WAF", "WOAF" },
-    { "WAR", "WOAR" },
-    { "WAS", "WOAS" },
-    { "WCM", "WCOM" },
-    { "WCP", "WCOP" },
-    { "WPB", "WPUB" },
-    { "WXX", "WXXX" },
-
-    // Apple iTunes nonstandard frames
-    { "PCS", "PCST" },
-    { "TCT", "TCAT" },
-    { "TDR", "TDRL" },
-    { "TDS", "TDES" },
-    { "TID", "TGID" },
-    { "WFD", "WFED" },
-    { "MVN", "MVNM" },
-    { "MVI", "MVIN" },
+  constexpr FrameConversion frameConversion2[] = {
+    { packedID("BUF"),  "RBUF" },
+    { packedID("CNT"),  "PCNT" },
+    { packedID("COM"),  "COMM" },
+    { packedID("CRA"),  "AENC" },
+    { packedID("ETC"),  "ETCO" },
+    { packedID("GEO"),  "GEOB" },
+    { packedID("IPL"),  "TIPL" },
+    { packedID("MCI"),  "MCDI" },
+    { packedID("MLL"),  "MLLT" },
+    { packedID("MVI"),  "MVIN" },  // Apple iTunes nonstandard
+    { packedID("MVN"),  "MVNM" },  // Apple iTunes nonstandard
+    { packedID("PCS"),  "PCST" },  // Apple iTunes nonstandard
+    { packedID("POP"),  "POPM" },
+    { packedID("REV"),  "RVRB" },
+    { packedID("SLT"),  "SYLT" },
+    { packedID("STC"),  "SYTC" },
+    { packedID("TAL"),  "TALB" },
+    { packedID("TBP"),  "TBPM" },
+    { packedID("TCM"),  "TCOM" },
+    { packedID("TCO"),  "TCON" },
+    { packedID("TCP"),  "TCMP" },
+    { packedID("TCR"),  "TCOP" },
+    { packedID("TCT"),  "TCAT" },  // Apple iTunes nonstandard
+    { packedID("TDR"),  "TDRL" },  // Apple iTunes nonstandard
+    { packedID("TDS"),  "TDES" },  // Apple iTunes nonstandard
+    { packedID("TDY"),  "TDLY" },
+    { packedID("TEN"),  "TENC" },
+    { packedID("TFT"),  "TFLT" },
+    { packedID("TID"),  "TGID" },  // Apple iTunes nonstandard
+    { packedID("TKE"),  "TKEY" },
+    { packedID("TLA"),  "TLAN" },
+    { packedID("TLE"),  "TLEN" },
+    { packedID("TMT"),  "TMED" },
+    { packedID("TOA"),  "TOAL" },
+    { packedID("TOF"),  "TOFN" },
+    { packedID("TOL"),  "TOLY" },
+    { packedID("TOR"),  "TDOR" },
+    { packedID("TOT"),  "TOAL" },
+    { packedID("TP1"),  "TPE1" },
+    { packedID("TP2"),  "TPE2" },
+    { packedID("TP3"),  "TPE3" },
+    { packedID("TP4"),  "TPE4" },
+    { packedID("TPA"),  "TPOS" },
+    { packedID("TPB"),  "TPUB" },
+    { packedID("TRC"),  "TSRC" },
+    { packedID("TRD"),  "TDRC" },
+    { packedID("TRK"),  "TRCK" },
+    { packedID("TS2"),  "TSO2" },
+    { packedID("TSA"),  "TSOA" },
+    { packedID("TSC"),  "TSOC" },
+    { packedID("TSP"),  "TSOP" },
+    { packedID("TSS"),  "TSSE" },
+    { packedID("TST"),  "TSOT" },
+    { packedID("TT1"),  "TIT1" },
+    { packedID("TT2"),  "TIT2" },
+    { packedID("TT3"),  "TIT3" },
+    { packedID("TXT"),  "TOLY" },
+    { packedID("TXX"),  "TXXX" },
+    { packedID("TYE"),  "TDRC" },
+    { packedID("UFI"),  "UFID" },
+    { packedID("ULT"),  "USLT" },
+    { packedID("WAF"),  "WOAF" },
+    { packedID("WAR"),  "WOAR" },
+    { packedID("WAS"),  "WOAS" },
+    { packedID("WCM"),  "WCOM" },
+    { packedID("WCP"),  "WCOP" },
+    { packedID("WFD"),  "WFED" },  // Apple iTunes nonstandard
+    { packedID("WPB"),  "WPUB" },
+    { packedID("WXX"),  "WXXX" },
   };
-  const size_t frameConversion2Size = sizeof(frameConversion2) / sizeof(frameConversion2[0]);
+  static_assert(isSorted(frameConversion2), "frameConversion2 must be sorted");
 
   // Frame conversion table ID3v2.3 -> 2.4
-  const char *frameConversion3[][2] = {
-    { "TORY", "TDOR" },
-    { "TYER", "TDRC" },
-    { "IPLS", "TIPL" },
+  constexpr FrameConversion frameConversion3[] = {
+    { packedID("IPLS"), "TIPL" },
+    { packedID("TORY"), "TDOR" },
+    { packedID("TYER"), "TDRC" },
   };
-  const size_t frameConversion3Size = sizeof(frameConversion3) / sizeof(frameConversion3[0]);
+  static_assert(isSorted(frameConversion3), "frameConversion3 must be sorted");
+
+  template <size_t N>
+  const char *convertedFrameID(const FrameConversion (&table)[N], unsigned int id)
+  {
+    const FrameConversion *it = std::lower_bound(table, table + N, id);
+    return (it != table + N && it->from == id) ? it->to : 0;
+  }
 }
 
 bool FrameFactory::updateFrame(Frame::Header *header) const
 {
   const ByteVector frameID = header->frameID();
+  const unsigned int id = packFrameID(frameID);
 
   switch(header->version()) {
 
   case 2: // ID3v2.2
   {
-    if(frameID == "CRM" ||
-       frameID == "EQU" ||
-       frameID == "LNK" ||
-       frameID == "RVA" ||
-       frameID == "TIM" ||
-       frameID == "TSI" ||
-       frameID == "TDA")
-    {
+    switch(id) {
+    case packedID("CRM"):
+    case packedID("EQU"):
+    case packedID("LNK"):
+    case packedID("RVA"):
+    case packedID("TIM"):
+    case packedID("TSI"):
+    case packedID("TDA"):
       debug("ID3v2.4 no longer supports the frame type " + String(frameID) +
             ".  It will be discarded from the tag.");
       return false;
+    default:
+      break;
     }
 
     // ID3v2.2 only used 3 bytes for the frame ID, so we need to convert all of
     // the frames to their 4 byte ID3v2.4 equivalent.
 
-    for(size_t i = 0; i < frameConversion2Size; ++i) {
-      if(frameID == frameConversion2[i][0]) {
-        header->setFrameID(frameConversion2[i][1]);
-        break;
-      }
-    }
+    const char *newID = convertedFrameID(frameConversion2, id);
+    if(newID)
+      header->setFrameID(newID);
 
     break;
   }
 
   case 3: // ID3v2.3
   {
-    if(frameID == "EQUA" ||
-       frameID == "RVAD" ||
-       frameID == "TIME" ||
-       frameID == "TRDA" ||
-       frameID == "TSIZ" ||
-       frameID == "TDAT")
-    {
+    switch(id) {
+    case packedID("EQUA"):
+    case packedID("RVAD"):
+    case packedID("TIME"):
+    case packedID("TRDA"):
+    case packedID("TSIZ"):
+    case packedID("TDAT"):
       debug("ID3v2.4 no longer supports the frame type " + String(frameID) +
             ".  It will be discarded from the tag.");
       return false;
+    default:
+      break;
     }
 
-    for(size_t i = 0; i < frameConversion3Size; ++i) {
-      if(frameID == frameConversion3[i][0]) {
-        header->setFrameID(frameConversion3[i][1]);
-        break;
-      }
-    }
+    const char *newID = convertedFrameID(frameConversion3, id);
+    if(newID)
+      header->setFrameID(newID);
 
     break;
   }
@@ -534,7 +612,7 @@ bool FrameFactory::updateFrame(Frame::Header *header) const
     // This should catch a typo that existed in TagLib up to and including
     // version 1.1 where TRDC was used for the year rather than TDRC.
 
-    if(frameID == "TRDC")
+    if(id == packedID("TRDC"))
       header->setFrameID("TDRC");
 
     break;
@@ -23,13 +23,76 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <cstring>
 #include <iostream>
 
 #include "id3v2synchdata.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define TAGLIB_SYNCHDATA_SSE2
+# include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+# define TAGLIB_SYNCHDATA_NEON
+# include <arm_neon.h>
+#endif
+
 using namespace TagLib;
 using namespace ID3v2;
 
+namespace
+{
+#if defined(TAGLIB_SYNCHDATA_SSE2) || defined(TAGLIB_SYNCHDATA_NEON)
+
+  const unsigned int BlockSize = 16;
+
+  // Returns true if any of the 16 bytes at \a p is a 0xFF followed by a 0x00,
+  // comparing each byte and the one after it at once.  17 bytes are read.
+
+  inline bool blockHasFalseSync(const char *p)
+  {
+#if defined(TAGLIB_SYNCHDATA_SSE2)
+    const __m128i first  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 1));
+    const __m128i pairs  = _mm_and_si128(_mm_cmpeq_epi8(first, _mm_set1_epi8(static_cast<char>(0xFF))),
+                                         _mm_cmpeq_epi8(second, _mm_setzero_si128()));
+    return _mm_movemask_epi8(pairs) != 0;
+#else
+    const uint8x16_t first  = vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+    const uint8x16_t second = vld1q_u8(reinterpret_cast<const uint8_t *>(p + 1));
+    const uint8x16_t pairs  = vandq_u8(vceqq_u8(first, vdupq_n_u8(0xFF)), vceqzq_u8(second));
+    return vmaxvq_u8(pairs) != 0;
+#endif
+  }
+
+#endif
+
+  inline bool isFalseSync(const char *p)
+  {
+    return p[0] == '\xff' && p[1] == '\x00';
+  }
+
+  // Returns true if there is a 0xFF followed by a 0x00 in [begin, end).
+
+  bool hasFalseSync(const char *begin, const char *end)
+  {
+    const char *p = begin;
+
+#if defined(TAGLIB_SYNCHDATA_SSE2) || defined(TAGLIB_SYNCHDATA_NEON)
+    for(; end - p > BlockSize; p += BlockSize) {
+      if(blockHasFalseSync(p))
+        return true;
+    }
+#endif
+
+    for(; end - p > 1; ++p) {
+      if(isFalseSync(p))
+        return true;
+    }
+
+    return false;
+  }
+}
+
 unsigned int SynchData::toUInt(const ByteVector &data)
 {
   unsigned int sum = 0;
@@ -76,23 +139,44 @@ ByteVector SynchData::decode(const ByteVector &data)
 {
   // We have this optimized method instead of using ByteVector::replace(),
   // since it makes a great difference when decoding huge unsynchronized frames.
+  // Where vector instructions are available, blocks without a 0xFF 0x00 pair
+  // are copied whole, and data without any is not copied at all.
 
-  ByteVector result(data.size());
+  const char *src = data.data();
+  const char *end = src + data.size();
 
-  ByteVector::ConstIterator src = data.begin();
-  ByteVector::Iterator dst = result.begin();
+  if(!hasFalseSync(src, end))
+    return data;
 
-  while(src < data.end() - 1) {
-    *dst++ = *src++;
+  ByteVector result(data.size());
+  char *dst = result.data();
+
+#if defined(TAGLIB_SYNCHDATA_SSE2) || defined(TAGLIB_SYNCHDATA_NEON)
+  while(end - src > BlockSize) {
+    if(!blockHasFalseSync(src)) {
+      ::memcpy(dst, src, BlockSize);
+      dst += BlockSize;
+      src += BlockSize;
+    }
+    else {
+      const char *blockEnd = src + BlockSize;
+      while(src < blockEnd) {
+        *dst++ = *src;
+        src += isFalseSync(src) ? 2 : 1;
+      }
+    }
+  }
+#endif
 
-    if(*(src - 1) == '\xff' && *src == '\x00')
-      src++;
+  while(end - src > 1) {
+    *dst++ = *src;
+    src += isFalseSync(src) ? 2 : 1;
   }
 
-  if(src < data.end())
-    *dst++ = *src++;
+  if(src < end)
+    *dst++ = *src;
 
-  result.resize(static_cast<unsigned int>(dst - result.begin()));
+  result.resize(static_cast<unsigned int>(dst - result.data()));
 
   return result;
 }
@@ -24,6 +24,8 @@
  ***************************************************************************/
 
 #include <algorithm>
+#include <map>
+#include <vector>
 
 #include <tfile.h>
 #include <tbytevector.h>
@@ -43,6 +45,8 @@
 #include "frames/uniquefileidentifierframe.h"
 #include "frames/unsynchronizedlyricsframe.h"
 #include "frames/unknownframe.h"
+#include "frames/attachedpictureframe.h"
+#include "frames/chapterframe.h"
 
 using namespace TagLib;
 using namespace ID3v2;
@@ -54,17 +58,369 @@ namespace
 
   const long MinPaddingSize = 1024;
   const long MaxPaddingSize = 1024 * 1024;
+
+  const int frameReadOptions = File::ReadTags | File::ReadPictures | File::ReadChapters;
+
+  // Returns whether a frame with the ID \a id, as it is in the tag, is one of
+  // the parts of the file given by the read options.
+
+  bool isFrameWanted(const ByteVector &id, int options)
+  {
+    if((options & frameReadOptions) == frameReadOptions)
+      return true;
+
+    if(id == "APIC" || id == "PIC")
+      return (options & File::ReadPictures) != 0;
+
+    if(id == "CHAP" || id == "CTOC")
+      return (options & File::ReadChapters) != 0;
+
+    // The fields of TagLib::Tag, including the ID3v2.2 and ID3v2.3 frames
+    // which are converted to them.
+
+    static const char *const basicFrameIDs[] = {
+      "TIT2", "TPE1", "TALB", "COMM", "TCON", "TDRC", "TYER", "TDAT", "TIME", "TRCK",
+      "TT2",  "TP1",  "TAL",  "COM",  "TCO",  "TYE",  "TDA",  "TIM",  "TRK"
+    };
+
+    for(size_t i = 0; i < sizeof(basicFrameIDs) / sizeof(basicFrameIDs[0]); ++i) {
+      if(id == basicFrameIDs[i])
+        return (options & File::ReadBasicTags) != 0;
+    }
+
+    return (options & File::ReadExtendedTags) != 0;
+  }
+
+  bool isValidFrameID(const ByteVector &frameID)
+  {
+    if(frameID.size() != 4)
+      return false;
+
+    for(ByteVector::ConstIterator it = frameID.begin(); it != frameID.end(); it++) {
+      if( (*it < 'A' || *it > 'Z') && (*it < '0' || *it > '9') ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool isPictureFrame(const ByteVector &id)
+  {
+    return id == "APIC" || id == "PIC";
+  }
+
+  // The frames whose payload is usually large and rarely needed, which are
+  // only indexed with File::ReadFramesOnDemand.  None of them is converted by
+  // the FrameFactory, so the ID in the file is the ID of the parsed frame.
+
+  bool isOnDemandFrame(const ByteVector &id)
+  {
+    return id == "APIC" || id == "GEOB" || id == "PRIV" ||
+           id == "SYLT" || id == "CHAP" || id == "CTOC";
+  }
+
+  // A frame which has been found in the file but is parsed only when it is
+  // accessed.  Its header is rebuilt from the fields kept here.
+
+  struct PendingFrame
+  {
+    ByteVector frameID;
+    long long offset;          // of the frame data in the file
+    unsigned int size;         // of the frame data
+    unsigned short flags;
+    unsigned int framesBefore; // the number of frames read before it
+    const Frame *next;         // the parsed frame which follows it, if any
+  };
+
+  typedef std::vector<PendingFrame> PendingFrameList;
+
+  bool isBefore(const PendingFrame &frame, long long offset)
+  {
+    return frame.offset < offset;
+  }
+
+  // A CHAP frame of the tag.  The chapter of a pending frame is read when the
+  // tag is read; a parsed frame is asked for its times when they are needed.
+
+  struct ChapterEntry
+  {
+    ChapterIndex::Chapter chapter;
+    long long offset;    // of the pending frame, or -1 if it is parsed
+    ChapterFrame *frame; // the parsed frame, if any
+  };
+
+  typedef std::multimap<ByteVector, ChapterEntry> ChapterEntryMap;
+
+  // Rebuilds the header of the pending frame \a frame as it is in the file.
+
+  ByteVector pendingFrameHeader(const PendingFrame &frame, unsigned int version)
+  {
+    ByteVector data = frame.frameID;
+    data.append(version >= 4 ? SynchData::fromUInt(frame.size) : ByteVector::fromUInt(frame.size));
+    data.append(ByteVector::fromShort(static_cast<short>(frame.flags)));
+    return data;
+  }
+
+  // Reads the element ID and the times of the pending CHAP frame \a frame
+  // into \a chapter, without reading its embedded frames.  Returns false if
+  // the frame data is encoded or too short, so that the frame has to be
+  // parsed instead.
+
+  bool readChapterTimes(File *file, const Header &tagHeader, const PendingFrame &frame,
+                        ChapterIndex::Chapter *chapter)
+  {
+    // The format flags are compression, encryption and grouping in ID3v2.3
+    // (structure 3.3.1), and the same plus unsynchronisation and the data
+    // length indicator in ID3v2.4 (structure 4.1.2).
+
+    const unsigned int formatFlags = tagHeader.majorVersion() >= 4 ? 0x4F : 0xE0;
+    if((frame.flags & formatFlags) || tagHeader.unsynchronisation())
+      return false;
+
+    // The element ID is usually short, so the start of the frame is enough.
+
+    const unsigned int timesSize = 16;
+    const unsigned int headSize = std::min(frame.size, 64U);
+
+    ByteVector data = file->readAt(frame.offset, headSize);
+    int end = data.find('\0');
+    if((end < 0 || data.size() < end + 1 + timesSize) && frame.size > headSize) {
+      data = file->readAt(frame.offset, frame.size);
+      end = data.find('\0');
+    }
+
+    if(end < 0 || data.size() < end + 1 + timesSize)
+      return false;
+
+    const unsigned int pos = end + 1;
+    chapter->elementID   = data.mid(0, end);
+    chapter->startTime   = data.toUInt(pos, true);
+    chapter->endTime     = data.toUInt(pos + 4, true);
+    chapter->startOffset = data.toUInt(pos + 8, true);
+    chapter->endOffset   = data.toUInt(pos + 12, true);
+    return true;
+  }
+
+  // Parses the fields of a picture frame which come before the picture, from
+  // the start of the frame data \a data.  Returns their size, or 0 if they
+  // are not all in \a data.
+
+  unsigned int parsePictureFields(const ByteVector &data, unsigned int version,
+                                  String &mimeType, int &type, String &description)
+  {
+    if(data.size() < 2 || static_cast<unsigned char>(data[0]) > String::UTF8)
+      return 0;
+
+    const String::Type encoding = static_cast<String::Type>(data[0]);
+    unsigned int pos = 1;
+
+    if(version < 3) {
+      if(data.size() < 5)
+        return 0;
+
+      // The same conversion as in AttachedPictureFrameV22.
+
+      const String format(data.mid(1, 3), String::Latin1);
+      if(format.upper() == "JPG")
+        mimeType = "image/jpeg";
+      else if(format.upper() == "PNG")
+        mimeType = "image/png";
+      else
+        mimeType = "image/" + format;
+      pos = 4;
+    }
+    else {
+      const int end = data.find('\0', 1);
+      if(end < 0)
+        return 0;
+      mimeType = String(data.mid(1, end - 1), String::Latin1);
+      pos = end + 1;
+    }
+
+    if(pos >= data.size())
+      return 0;
+    type = static_cast<unsigned char>(data[pos++]);
+
+    const ByteVector delimiter = Frame::textDelimiter(encoding);
+    const int end = data.find(delimiter, pos, delimiter.size());
+    if(end < 0)
+      return 0;
+    description = String(data.mid(pos, end - pos), encoding);
+
+    return end + delimiter.size();
+  }
+
+  // Returns a handle to the picture of the frame whose data, of \a size bytes,
+  // starts at the current position of \a file.  Only the fields before the
+  // picture are read.
+
+  PictureHandle readPictureHandle(File *file, unsigned int size, unsigned int version)
+  {
+    const long long start = file->tell();
+
+    ByteVector data = file->readBlock(std::min<unsigned int>(size, 256));
+
+    String mimeType;
+    int type = 0;
+    String description;
+    unsigned int fieldsSize = parsePictureFields(data, version, mimeType, type, description);
+
+    // A long description, so read the rest of the frame after all.
+
+    if(fieldsSize == 0 && data.size() < size) {
+      data.append(file->readBlock(size - data.size()));
+      fieldsSize = parsePictureFields(data, version, mimeType, type, description);
+    }
+
+    if(fieldsSize == 0) {
+      debug("ID3v2::Tag::read() - Invalid picture frame.");
+      return PictureHandle();
+    }
+
+    return PictureHandle(file, start + fieldsSize, size - fieldsSize, mimeType, type, description);
+  }
+
+  // Frame::Header is not accessible here, so the ID and the size of a frame
+  // are taken from its header data as it does (structure 4).
+
+  ByteVector frameIDOf(const ByteVector &frameHeaderData, unsigned int version)
+  {
+    return frameHeaderData.mid(0, version < 3 ? 3 : 4);
+  }
+
+  unsigned int frameSizeOf(const ByteVector &frameHeaderData, unsigned int version)
+  {
+    if(version < 3)
+      return frameHeaderData.toUInt(3U, 3U);
+    if(version == 3)
+      return frameHeaderData.toUInt(4U);
+    return SynchData::toUInt(frameHeaderData.mid(4, 4));
+  }
+
+  // Reads the frames of the tag whose header is \a header that are wanted by
+  // \a options, starting at the current position of \a file, and seeks over
+  // the others.  The frames are returned as they are laid out in the tag so
+  // that they can be parsed as usual.  Handles to the pictures which are not
+  // read are appended to \a pictures if File::ReadPictureHandles is set.
+  // Large frames are only indexed in \a pending, unless it is null.
+
+  ByteVector readWantedFrames(File *file, const Header &header, int options,
+                              PictureHandleList &pictures, PendingFrameList *pending)
+  {
+    const unsigned int version = header.majorVersion();
+    const unsigned int frameHeaderSize = Frame::headerSize(version);
+    const long long tagEnd = file->tell() + header.tagSize();
+
+    ByteVector data;
+    unsigned int framesRead = 0;
+
+    long long position = file->tell();
+    while(position + frameHeaderSize < tagEnd) {
+      ByteVector frameHeaderData = file->readBlock(frameHeaderSize);
+      if(frameHeaderData.size() < frameHeaderSize || frameHeaderData[0] == 0)
+        break;
+
+      unsigned int frameSize = frameSizeOf(frameHeaderData, version);
+
+#ifndef NO_ITUNES_HACKS
+      // The same check as in Frame::Header, for iTunes writing v2.4 tags with
+      // v2.3-like frame sizes.  Here the size is fixed in the copied header,
+      // as the next frame might not be copied.
+      if(version >= 4 && frameSize > 127) {
+        const long long next = position + frameHeaderSize + frameSize;
+        file->seek(next);
+        if(next + 4 > tagEnd || !isValidFrameID(file->readBlock(4))) {
+          const unsigned int uintSize = frameHeaderData.toUInt(4U);
+          const long long uintNext = position + frameHeaderSize + uintSize;
+          file->seek(uintNext);
+          if(uintNext + 4 <= tagEnd && isValidFrameID(file->readBlock(4))) {
+            frameSize = uintSize;
+            const ByteVector synchSafeSize = SynchData::fromUInt(frameSize);
+            std::copy(synchSafeSize.begin(), synchSafeSize.end(), frameHeaderData.begin() + 4);
+          }
+        }
+        file->seek(position + frameHeaderSize);
+      }
+#endif
+
+      if(frameSize == 0)
+        break;
+
+      const ByteVector frameID = frameIDOf(frameHeaderData, version);
+
+      if(pending && isOnDemandFrame(frameID) && isFrameWanted(frameID, options)) {
+        PendingFrame frame;
+        frame.frameID      = frameID;
+        frame.offset       = position + frameHeaderSize;
+        frame.size         = frameSize;
+        frame.flags        = frameHeaderData.toUShort(8U);
+        frame.framesBefore = framesRead;
+        frame.next         = 0;
+        pending->push_back(frame);
+      }
+      else if(isFrameWanted(frameID, options)) {
+        data.append(frameHeaderData);
+        data.append(file->readBlock(frameSize));
+        ++framesRead;
+      }
+      else if((options & File::ReadPictureHandles) && isPictureFrame(frameID)) {
+
+        // Compressed, encrypted or unsynchronised pictures can not be read
+        // from the file as they are, so they are read along with the tag.
+
+        if(version < 3 || frameHeaderData[9] == 0) {
+          const PictureHandle picture = readPictureHandle(file, frameSize, version);
+          if(!picture.isNull())
+            pictures.append(picture);
+        }
+        else {
+          data.append(frameHeaderData);
+          data.append(file->readBlock(frameSize));
+          ++framesRead;
+        }
+      }
+
+      position += frameHeaderSize + frameSize;
+      file->seek(position);
+    }
+
+    // parse() expects the footer to follow the frames.
+
+    if(!data.isEmpty() && header.footerPresent())
+      data.append(ByteVector(Footer::size(), '\0'));
+
+    return data;
+  }
 }
 
 class ID3v2::Tag::TagPrivate
 {
 public:
+  // Parses the pending frames before the file is changed, as they are read
+  // from where they were.
+
+  class PendingFrameReader : public File::DeferredReader
+  {
+  public:
+    PendingFrameReader() :
+      tag(0) {}
+
+    virtual void readDeferred()
+    {
+      tag->parseAllFrames();
+    }
+
+    const Tag *tag;
+  };
+
   TagPrivate() :
     factory(0),
     file(0),
     tagOffset(0),
     extendedHeader(0),
-    footer(0)
+    footer(0),
+    parsedFrameBytes(0),
+    chapterIndex(0)
   {
     frameList.setAutoDelete(true);
   }
@@ -73,6 +429,15 @@ public:
   {
     delete extendedHeader;
     delete footer;
+    delete chapterIndex;
+  }
+
+  // Drops the chapter index, so that it is made again when it is asked for.
+
+  void invalidateChapterIndex()
+  {
+    delete chapterIndex;
+    chapterIndex = 0;
   }
 
   const FrameFactory *factory;
@@ -86,6 +451,15 @@ public:
 
   FrameListMap frameListMap;
   FrameList frameList;
+
+  PictureHandleList pictureHandles;
+
+  PendingFrameList pendingFrames;
+  PendingFrameReader pendingFrameReader;
+  unsigned long long parsedFrameBytes;
+
+  ChapterEntryMap chapters;
+  ChapterIndex *chapterIndex;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,6 +503,9 @@ ID3v2::Tag::Tag(File *file, long tagOffset, const FrameFactory *factory) :
 
 ID3v2::Tag::~Tag()
 {
+  if(!d->pendingFrames.empty())
+    d->file->removeDeferredReader(&d->pendingFrameReader);
+
   delete d;
 }
 
@@ -305,7 +682,7 @@ void ID3v2::Tag::setTrack(unsigned int i)
 
 bool ID3v2::Tag::isEmpty() const
 {
-  return d->frameList.isEmpty();
+  return d->frameList.isEmpty() && d->pendingFrames.empty();
 }
 
 Header *ID3v2::Tag::header() const
@@ -325,35 +702,65 @@ Footer *ID3v2::Tag::footer() const
 
 const FrameListMap &ID3v2::Tag::frameListMap() const
 {
+  parsePendingFrames(ByteVector());
   return d->frameListMap;
 }
 
 const FrameList &ID3v2::Tag::frameList() const
 {
+  parsePendingFrames(ByteVector());
   return d->frameList;
 }
 
 const FrameList &ID3v2::Tag::frameList(const ByteVector &frameID) const
 {
+  parsePendingFrames(frameID);
   return d->frameListMap[frameID];
 }
 
 void ID3v2::Tag::addFrame(Frame *frame)
 {
+  // Frames of the same type which are still pending go first.
+  parsePendingFrames(frame->frameID());
+
   d->frameList.append(frame);
   d->frameListMap[frame->frameID()].append(frame);
+
+  ChapterFrame *chapterFrame = dynamic_cast<ChapterFrame *>(frame);
+  if(chapterFrame) {
+    ChapterEntry entry;
+    entry.offset = -1;
+    entry.frame  = chapterFrame;
+    d->chapters.insert(std::make_pair(chapterFrame->elementID(), entry));
+    d->invalidateChapterIndex();
+  }
 }
 
 void ID3v2::Tag::removeFrame(Frame *frame, bool del)
 {
   // remove the frame from the frame list
   FrameList::Iterator it = d->frameList.find(frame);
-  d->frameList.erase(it);
+  it = d->frameList.erase(it);
+
+  // ...keeping the place of the pending frames which went before it
+  for(PendingFrameList::iterator pit = d->pendingFrames.begin(); pit != d->pendingFrames.end(); ++pit) {
+    if(pit->next == frame)
+      pit->next = it != d->frameList.end() ? *it : 0;
+  }
 
   // ...and from the frame list map
   it = d->frameListMap[frame->frameID()].find(frame);
   d->frameListMap[frame->frameID()].erase(it);
 
+  // ...and from the chapters
+  for(ChapterEntryMap::iterator cit = d->chapters.begin(); cit != d->chapters.end(); ++cit) {
+    if(cit->second.frame == frame) {
+      d->chapters.erase(cit);
+      d->invalidateChapterIndex();
+      break;
+    }
+  }
+
   // ...and delete as desired
   if(del)
     delete frame;
@@ -361,7 +768,7 @@ void ID3v2::Tag::removeFrame(Frame *frame, bool del)
 
 void ID3v2::Tag::removeFrames(const ByteVector &id)
 {
-  FrameList l = d->frameListMap[id];
+  FrameList l = frameList(id);
   for(FrameList::ConstIterator it = l.begin(); it != l.end(); ++it)
     removeFrame(*it, true);
 }
@@ -369,10 +776,19 @@ void ID3v2::Tag::removeFrames(const ByteVector &id)
 PropertyMap ID3v2::Tag::properties() const
 {
   PropertyMap properties;
-  for(FrameList::ConstIterator it = frameList().begin(); it != frameList().end(); ++it) {
+  for(FrameList::ConstIterator it = d->frameList.begin(); it != d->frameList.end(); ++it) {
     PropertyMap props = (*it)->asProperties();
     properties.merge(props);
   }
+
+  // None of the frames which are parsed on demand has properties, so they
+  // are not parsed just to say so.
+
+  for(PendingFrameList::const_iterator it = d->pendingFrames.begin();
+      it != d->pendingFrames.end(); ++it) {
+    properties.unsupportedData().append(String(it->frameID));
+  }
+
   return properties;
 }
 
@@ -425,7 +841,11 @@ PropertyMap ID3v2::Tag::setProperties(const PropertyMap &origProps)
   PropertyMap tiplProperties;
   PropertyMap tmclProperties;
   Frame::splitProperties(origProps, properties, tiplProperties, tmclProperties);
-  for(FrameListMap::ConstIterator it = frameListMap().begin(); it != frameListMap().end(); ++it){
+
+  // The frames which are still pending have no properties and are kept, so
+  // they are left as they are.
+
+  for(FrameListMap::ConstIterator it = d->frameListMap.begin(); it != d->frameListMap.end(); ++it){
     for(FrameList::ConstIterator lit = it->second.begin(); lit != it->second.end(); ++lit){
       PropertyMap frameProperties = (*lit)->asProperties();
       if(it->first == "TIPL") {
@@ -467,6 +887,8 @@ ByteVector ID3v2::Tag::render() const
 
 void ID3v2::Tag::downgradeFrames(FrameList *frames, FrameList *newFrames) const
 {
+  parsePendingFrames(ByteVector());
+
 #ifdef NO_ITUNES_HACKS
   const char *unsupportedFrames[] = {
     "ASPI", "EQU2", "RVA2", "SEEK", "SIGN", "TDRL", "TDTG",
@@ -581,6 +1003,8 @@ ByteVector ID3v2::Tag::render(int version) const
 
   // TODO: Render the extended header.
 
+  parsePendingFrames(ByteVector());
+
   // Downgrade the frames that ID3v2.3 doesn't support.
 
   FrameList newFrames;
@@ -594,11 +1018,13 @@ ByteVector ID3v2::Tag::render(int version) const
     downgradeFrames(&frameList, &newFrames);
   }
 
-  // Reserve a 10-byte blank space for an ID3v2 tag header.
-
-  ByteVector tagData(Header::size(), '\0');
+  // The tag is rendered in two passes, so that it is written once into a
+  // buffer of the right size instead of being grown frame by frame.  The
+  // first pass renders the fields of the frames and adds up their sizes.
 
-  // Loop through the frames rendering them and adding them to the tagData.
+  List<ByteVector> fieldDataList;
+  FrameList renderedFrames;
+  unsigned int framesSize = 0;
 
   for(FrameList::ConstIterator it = frameList.begin(); it != frameList.end(); it++) {
     (*it)->header()->setVersion(version);
@@ -608,20 +1034,23 @@ ByteVector ID3v2::Tag::render(int version) const
       continue;
     }
     if(!(*it)->header()->tagAlterPreservation()) {
-      const ByteVector frameData = (*it)->render();
-      if(frameData.size() == Frame::headerSize((*it)->header()->version())) {
+      const ByteVector fieldData = (*it)->renderFields();
+      if(fieldData.isEmpty()) {
         debug("An empty ID3v2 frame \'"
           + String((*it)->header()->frameID()) + "\' has been discarded");
         continue;
       }
-      tagData.append(frameData);
+      (*it)->header()->setFrameSize(fieldData.size());
+      fieldDataList.append(fieldData);
+      renderedFrames.append(*it);
+      framesSize += Frame::headerSize(version) + fieldData.size();
     }
   }
 
-  // Compute the amount of padding, and append that to tagData.
+  // Compute the amount of padding.
 
   long originalSize = d->header.tagSize();
-  long paddingSize = originalSize - (tagData.size() - Header::size());
+  long paddingSize = originalSize - framesSize;
 
   if(paddingSize <= 0) {
     paddingSize = MinPaddingSize;
@@ -637,15 +1066,24 @@ ByteVector ID3v2::Tag::render(int version) const
       paddingSize = MinPaddingSize;
   }
 
-  tagData.resize(static_cast<unsigned int>(tagData.size() + paddingSize), '\0');
-
   // Set the version and data size.
   d->header.setMajorVersion(version);
-  d->header.setTagSize(tagData.size() - Header::size());
+  d->header.setTagSize(framesSize + static_cast<unsigned int>(paddingSize));
+
+  // The second pass writes the header, the frames and the padding.
+
+  ByteVector tagData(Header::size() + d->header.tagSize(), '\0');
 
   // TODO: This should eventually include d->footer->render().
   const ByteVector headerData = d->header.render();
-  std::copy(headerData.begin(), headerData.end(), tagData.begin());
+  ByteVector::Iterator out = std::copy(headerData.begin(), headerData.end(), tagData.begin());
+
+  List<ByteVector>::ConstIterator fieldData = fieldDataList.begin();
+  for(FrameList::ConstIterator it = renderedFrames.begin(); it != renderedFrames.end(); ++it, ++fieldData) {
+    const ByteVector frameHeaderData = (*it)->header()->render();
+    out = std::copy(frameHeaderData.begin(), frameHeaderData.end(), out);
+    out = std::copy(fieldData->begin(), fieldData->end(), out);
+  }
 
   return tagData;
 }
@@ -681,8 +1119,62 @@ void ID3v2::Tag::read()
   // If the tag size is 0, then this is an invalid tag (tags must contain at
   // least one frame)
 
-  if(d->header.tagSize() != 0)
-    parse(d->file->readBlock(d->header.tagSize()));
+  if(d->header.tagSize() != 0) {
+    const int options = d->file->readOptions();
+    const bool onDemand =
+      (options & File::ReadFramesOnDemand) && d->header.majorVersion() >= 3;
+
+    // The frames are walked in the file, so that those which are not wanted
+    // are not read at all, unless they can not be told apart beforehand.
+
+    if(d->header.extendedHeader() ||
+       (d->header.unsynchronisation() && d->header.majorVersion() <= 3) ||
+       (!onDemand && (options & frameReadOptions) == frameReadOptions)) {
+      parse(d->file->readBlock(d->header.tagSize()));
+    }
+    else if(options & (frameReadOptions | File::ReadPictureHandles)) {
+      const ByteVector data = readWantedFrames(d->file, d->header, options, d->pictureHandles,
+                                               onDemand ? &d->pendingFrames : 0);
+      if(!data.isEmpty())
+        parse(data);
+
+      // Find where the pending frames go among those which were parsed.
+
+      FrameList::ConstIterator frame = d->frameList.begin();
+      unsigned int index = 0;
+      for(PendingFrameList::iterator it = d->pendingFrames.begin(); it != d->pendingFrames.end(); ++it) {
+        for(; index < it->framesBefore && frame != d->frameList.end(); ++index)
+          ++frame;
+        it->next = frame != d->frameList.end() ? *frame : 0;
+      }
+
+      if(!d->pendingFrames.empty()) {
+        d->pendingFrameReader.tag = this;
+        d->file->addDeferredReader(&d->pendingFrameReader);
+      }
+
+      // The chapters of the pending CHAP frames are read once, here.  Those
+      // which can not be read that way are parsed.
+
+      unsigned int pendingIndex = 0;
+      while(pendingIndex < d->pendingFrames.size()) {
+        const PendingFrame &frame = d->pendingFrames[pendingIndex];
+        ChapterEntry entry;
+        if(frame.frameID != "CHAP") {
+          ++pendingIndex;
+        }
+        else if(readChapterTimes(d->file, d->header, frame, &entry.chapter)) {
+          entry.offset = frame.offset;
+          entry.frame  = 0;
+          d->chapters.insert(std::make_pair(entry.chapter.elementID, entry));
+          ++pendingIndex;
+        }
+        else {
+          parsePendingFrame(pendingIndex);
+        }
+      }
+    }
+  }
 
   // Look for duplicate ID3v2 tags and treat them as an extra blank of this one.
   // It leads to overwriting them with zero when saving the tag.
@@ -740,10 +1232,13 @@ void ID3v2::Tag::parse(const ByteVector &origData)
 
   // parse frames
 
+  const int options = d->file ? d->file->readOptions() : static_cast<int>(File::ReadEverything);
+  const unsigned int frameHeaderSize = Frame::headerSize(d->header.majorVersion());
+
   // Make sure that there is at least enough room in the remaining frame data for
   // a frame header.
 
-  while(frameDataPosition < frameDataLength - Frame::headerSize(d->header.majorVersion())) {
+  while(frameDataPosition < frameDataLength - frameHeaderSize) {
 
     // If the next data is position is 0, assume that we've hit the padding
     // portion of the frame data.
@@ -756,6 +1251,20 @@ void ID3v2::Tag::parse(const ByteVector &origData)
       break;
     }
 
+    // Frames which are not wanted are only left here if the whole tag had to
+    // be read.
+
+    if((options & frameReadOptions) != frameReadOptions) {
+      const Frame::Header frameHeader(data.mid(frameDataPosition), d->header.majorVersion());
+      const bool pictureHandle = (options & File::ReadPictureHandles) && isPictureFrame(frameHeader.frameID());
+      if(!isFrameWanted(frameHeader.frameID(), options) && !pictureHandle) {
+        if(frameHeader.frameSize() == 0)
+          return;
+        frameDataPosition += frameHeader.frameSize() + frameHeaderSize;
+        continue;
+      }
+    }
+
     Frame *frame = d->factory->createFrame(data.mid(frameDataPosition),
                                            &d->header);
 
@@ -769,13 +1278,113 @@ void ID3v2::Tag::parse(const ByteVector &origData)
       return;
     }
 
-    frameDataPosition += frame->size() + Frame::headerSize(d->header.majorVersion());
+    frameDataPosition += frame->size() + frameHeaderSize;
+    d->parsedFrameBytes += frame->size() + frameHeaderSize;
+
+    // Pictures which had to be read although only handles to them were
+    // asked for are kept as such, not as frames.
+
+    if(!(options & File::ReadPictures)) {
+      const AttachedPictureFrame *picture = dynamic_cast<const AttachedPictureFrame *>(frame);
+      if(picture) {
+        d->pictureHandles.append(PictureHandle(picture->picture(), picture->mimeType(),
+                                               picture->type(), picture->description()));
+        delete frame;
+        continue;
+      }
+    }
+
     addFrame(frame);
   }
 
   d->factory->rebuildAggregateFrames(this);
 }
 
+PictureHandleList ID3v2::Tag::pictureHandles() const
+{
+  parsePendingFrames("APIC");
+
+  PictureHandleList handles = d->pictureHandles;
+
+  const FrameListMap::ConstIterator apic = d->frameListMap.find("APIC");
+  if(apic == d->frameListMap.end())
+    return handles;
+
+  for(FrameList::ConstIterator it = apic->second.begin(); it != apic->second.end(); ++it) {
+    const AttachedPictureFrame *picture = dynamic_cast<const AttachedPictureFrame *>(*it);
+    if(picture) {
+      handles.append(PictureHandle(picture->picture(), picture->mimeType(),
+                                   picture->type(), picture->description()));
+    }
+  }
+
+  return handles;
+}
+
+void ID3v2::Tag::parseAllFrames() const
+{
+  parsePendingFrames(ByteVector());
+}
+
+unsigned int ID3v2::Tag::pendingFrameCount() const
+{
+  return static_cast<unsigned int>(d->pendingFrames.size());
+}
+
+unsigned long long ID3v2::Tag::parsedFrameBytes() const
+{
+  return d->parsedFrameBytes;
+}
+
+ChapterIndex ID3v2::Tag::chapterIndex() const
+{
+  if(!d->chapterIndex) {
+    d->chapterIndex = new ChapterIndex();
+    for(ChapterEntryMap::const_iterator it = d->chapters.begin(); it != d->chapters.end(); ++it) {
+      const ChapterFrame *frame = it->second.frame;
+      if(frame) {
+        d->chapterIndex->append(ChapterIndex::Chapter(frame->elementID(),
+                                                      frame->startTime(), frame->endTime(),
+                                                      frame->startOffset(), frame->endOffset()));
+      }
+      else {
+        d->chapterIndex->append(it->second.chapter);
+      }
+    }
+  }
+
+  return *d->chapterIndex;
+}
+
+ChapterFrame *ID3v2::Tag::chapterFrame(const ByteVector &elementID) const
+{
+  const std::pair<ChapterEntryMap::iterator, ChapterEntryMap::iterator> range =
+    d->chapters.equal_range(elementID);
+
+  for(ChapterEntryMap::iterator it = range.first; it != range.second; ++it) {
+    if(it->second.frame && it->second.frame->elementID() == elementID)
+      return it->second.frame;
+  }
+
+  // A pending frame, which is found by its offset, as they are in the order
+  // of the file.
+
+  for(ChapterEntryMap::iterator it = range.first; it != range.second; ++it) {
+    const PendingFrameList::iterator pending =
+      std::lower_bound(d->pendingFrames.begin(), d->pendingFrames.end(),
+                       it->second.offset, isBefore);
+    if(pending != d->pendingFrames.end() && pending->offset == it->second.offset) {
+      ChapterFrame *frame = dynamic_cast<ChapterFrame *>(
+        parsePendingFrame(static_cast<unsigned int>(pending - d->pendingFrames.begin())));
+      if(frame && frame->elementID() == elementID)
+        return frame;
+      break;
+    }
+  }
+
+  return 0;
+}
+
 void ID3v2::Tag::setTextFrame(const ByteVector &id, const String &value)
 {
   if(value.isEmpty()) {
@@ -792,3 +1401,86 @@ void ID3v2::Tag::setTextFrame(const ByteVector &id, const String &value)
     f->setText(value);
   }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void ID3v2::Tag::parsePendingFrames(const ByteVector &frameID) const
+{
+  unsigned int index = 0;
+  while(index < d->pendingFrames.size()) {
+    if(frameID.isEmpty() || d->pendingFrames[index].frameID == frameID)
+      parsePendingFrame(index);
+    else
+      ++index;
+  }
+}
+
+Frame *ID3v2::Tag::parsePendingFrame(unsigned int index) const
+{
+  const PendingFrameList::iterator it = d->pendingFrames.begin() + index;
+
+  ByteVector data = pendingFrameHeader(*it, d->header.majorVersion());
+  data.append(d->file->readAt(it->offset, it->size));
+
+  Frame *frame = d->factory->createFrame(data, &d->header);
+  if(frame && frame->size() > 0) {
+    d->parsedFrameBytes += data.size();
+
+    FrameList::Iterator next = d->frameList.end();
+    if(it->next)
+      next = d->frameList.find(const_cast<Frame *>(it->next));
+    d->frameList.insert(next, frame);
+    d->frameListMap[frame->frameID()].append(frame);
+  }
+  else {
+    debug("ID3v2::Tag::parsePendingFrame() -- Could not parse a " + String(it->frameID) +
+          " frame.");
+    delete frame;
+    frame = 0;
+  }
+
+  if(it->frameID == "CHAP") {
+    ChapterFrame *chapterFrame = dynamic_cast<ChapterFrame *>(frame);
+    ChapterEntryMap::iterator chapter = d->chapters.end();
+    if(chapterFrame) {
+      const std::pair<ChapterEntryMap::iterator, ChapterEntryMap::iterator> range =
+        d->chapters.equal_range(chapterFrame->elementID());
+      for(ChapterEntryMap::iterator cit = range.first; cit != range.second; ++cit) {
+        if(cit->second.offset == it->offset)
+          chapter = cit;
+      }
+    }
+    if(chapter == d->chapters.end()) {
+      chapter = d->chapters.begin();
+      while(chapter != d->chapters.end() && chapter->second.offset != it->offset)
+        ++chapter;
+    }
+
+    // The index is still right if the chapter was read as it is parsed.
+
+    if(chapter != d->chapters.end() && chapterFrame &&
+       chapter->first == chapterFrame->elementID()) {
+      chapter->second.offset = -1;
+      chapter->second.frame  = chapterFrame;
+    }
+    else {
+      if(chapter != d->chapters.end())
+        d->chapters.erase(chapter);
+      if(chapterFrame) {
+        ChapterEntry entry;
+        entry.offset = -1;
+        entry.frame  = chapterFrame;
+        d->chapters.insert(std::make_pair(chapterFrame->elementID(), entry));
+      }
+      d->invalidateChapterIndex();
+    }
+  }
+
+  d->pendingFrames.erase(it);
+  if(d->pendingFrames.empty())
+    d->file->removeDeferredReader(&d->pendingFrameReader);
+
+  return frame;
+}
@@ -32,8 +32,10 @@
 #include "tlist.h"
 #include "tmap.h"
 #include "taglib_export.h"
+#include "tpicturehandle.h"
 
 #include "id3v2framefactory.h"
+#include "id3v2chapterindex.h"
 
 namespace TagLib {
 
@@ -53,6 +55,7 @@ namespace TagLib {
     class Header;
     class ExtendedHeader;
     class Footer;
+    class ChapterFrame;
 
     typedef List<Frame *> FrameList;
     typedef Map<ByteVector, FrameList> FrameListMap;
@@ -239,6 +242,62 @@ namespace TagLib {
        */
       const FrameListMap &frameListMap() const;
 
+      /*!
+       * Returns handles to the pictures of the tag.  These are those of the
+       * APIC frames, and, if the file was opened with File::ReadPictureHandles
+       * rather than File::ReadPictures, those of the pictures which were not
+       * read.  The latter are not in the frame list.
+       *
+       * \see File::pictureHandles()
+       */
+      PictureHandleList pictureHandles() const;
+
+      /*!
+       * Returns the number of frames which have been found in the file but not
+       * parsed yet.  With File::ReadFramesOnDemand the large frames (APIC,
+       * GEOB, PRIV, SYLT, CHAP and CTOC) are only indexed when the tag is read,
+       * and are parsed when frameList() or frameListMap() is called, or
+       * frameList() with their ID.
+       */
+      unsigned int pendingFrameCount() const;
+
+      /*!
+       * Parses the frames which are still pending, see pendingFrameCount().
+       * This is done before the file of the tag is first changed, since the
+       * pending frames are read from it.
+       */
+      void parseAllFrames() const;
+
+      /*!
+       * Returns the number of bytes of frames, headers included, which have
+       * been parsed since the tag was read.
+       */
+      unsigned long long parsedFrameBytes() const;
+
+      /*!
+       * Returns the element IDs, times and offsets of the CHAP frames of the
+       * tag, in the order of their start times.  CHAP frames which are still
+       * pending, see File::ReadFramesOnDemand, are not parsed for this; only
+       * their element ID and times are read from the file, once, when the tag
+       * is read.
+       *
+       * The index is kept until CHAP frames are added or removed, so changes
+       * to the times of a ChapterFrame are seen after that.
+       *
+       * \see chapterFrame()
+       */
+      ChapterIndex chapterIndex() const;
+
+      /*!
+       * Returns the CHAP frame with the element ID \a elementID, or null if
+       * there is none.  Of the CHAP frames which are still pending only this
+       * one is parsed, along with its embedded frames.  The frame is found by
+       * the element ID it had when it was added to the tag.
+       *
+       * \see ChapterFrame::findByElementID()
+       */
+      ChapterFrame *chapterFrame(const ByteVector &elementID) const;
+
       /*!
        * Returns a reference to the frame list.  This is an FrameList of all of
        * the frames in the tag in the order that they were parsed.
@@ -402,6 +461,9 @@ namespace TagLib {
       Tag(const Tag &);
       Tag &operator=(const Tag &);
 
+      void parsePendingFrames(const ByteVector &frameID) const;
+      Frame *parsePendingFrame(unsigned int index) const;
+
       class TagPrivate;
       TagPrivate *d;
     };
@@ -132,30 +132,40 @@ bool MPEG::File::isSupported(IOStream *stream)
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-MPEG::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+MPEG::File::File(FileName file, bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 MPEG::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(file),
   d(new FilePrivate(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 MPEG::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(stream),
   d(new FilePrivate(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
+}
+
+MPEG::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
+                 ReadOptions readOptions, Properties::ReadStyle readStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate(frameFactory))
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0, readStyle);
 }
 
 MPEG::File::~File()
@@ -173,6 +183,14 @@ PropertyMap MPEG::File::properties() const
   return d->tag.properties();
 }
 
+PictureHandleList MPEG::File::pictureHandles() const
+{
+  if(d->tag[ID3v2Index])
+    return static_cast<ID3v2::Tag *>(d->tag[ID3v2Index])->pictureHandles();
+
+  return PictureHandleList();
+}
+
 void MPEG::File::removeUnsupportedProperties(const StringList &properties)
 {
   d->tag.removeUnsupportedProperties(properties);
@@ -488,7 +506,7 @@ bool MPEG::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::File::read(bool readProperties)
+void MPEG::File::read(bool readProperties, Properties::ReadStyle readStyle)
 {
   // Look for an ID3v2 tag
 
@@ -517,7 +535,7 @@ void MPEG::File::read(bool readProperties)
   }
 
   if(readProperties)
-    d->properties = new Properties(this);
+    d->properties = new Properties(this, readStyle);
 
   // Make sure that we have our default tag types available.
 
@@ -74,7 +74,8 @@ namespace TagLib {
        * Constructs an MPEG file from \a file.  If \a readProperties is true the
        * file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * The audio properties are read using \a propertiesStyle, see
+       * MPEG::Properties for what it changes.
        *
        * \deprecated This constructor will be dropped in favor of the one below
        * in a future version.
@@ -89,7 +90,8 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * The audio properties are read using \a propertiesStyle, see
+       * MPEG::Properties for what it changes.
        */
       // BIC: merge with the above constructor
       File(FileName file, ID3v2::FrameFactory *frameFactory,
@@ -106,12 +108,29 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * The audio properties are read using \a propertiesStyle, see
+       * MPEG::Properties for what it changes.
        */
       File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
            bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an MPEG file from \a stream, reading only the parts of it
+       * given by \a readOptions, a combination of TagLib::File::ReadOptions.
+       *
+       * \note TagLib will *not* take ownership of the stream, the caller is
+       * responsible for deleting it after the File object.
+       *
+       * If this file contains and ID3v2 tag the frames will be created using
+       * \a frameFactory.
+       *
+       * The audio properties are read using \a propertiesStyle, see
+       * MPEG::Properties for what it changes.
+       */
+      File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
+           ReadOptions readOptions, Properties::ReadStyle propertiesStyle);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -144,6 +163,13 @@ namespace TagLib {
        */
       PropertyMap properties() const;
 
+      /*!
+       * Returns handles to the pictures of the ID3v2 tag.
+       *
+       * \see ID3v2::Tag::pictureHandles()
+       */
+      PictureHandleList pictureHandles() const;
+
       void removeUnsupportedProperties(const StringList &properties);
 
       /*!
@@ -383,7 +409,7 @@ namespace TagLib {
       File(const File &);
       File &operator=(const File &);
 
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle readStyle);
       long findID3v2();
 
       class FilePrivate;
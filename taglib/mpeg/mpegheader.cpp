@@ -72,7 +72,7 @@ public:
 MPEG::Header::Header(const ByteVector &data) :
   d(new HeaderPrivate())
 {
-  debug("MPEG::Header::Header() - This constructor is no longer used.");
+  d->isValid = parse(data);
 }
 
 MPEG::Header::Header(File *file, long offset, bool checkLength) :
@@ -170,21 +170,18 @@ MPEG::Header &MPEG::Header::operator=(const Header &h)
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::Header::parse(File *file, long offset, bool checkLength)
+bool MPEG::Header::parse(const ByteVector &data)
 {
-  file->seek(offset);
-  const ByteVector data = file->readBlock(4);
-
   if(data.size() < 4) {
     debug("MPEG::Header::parse() -- data is too short for an MPEG frame header.");
-    return;
+    return false;
   }
 
   // Check for the MPEG synch bytes.
 
   if(!isFrameSync(data)) {
     debug("MPEG::Header::parse() -- MPEG header did not match MPEG synch.");
-    return;
+    return false;
   }
 
   // Set the MPEG version
@@ -198,7 +195,7 @@ void MPEG::Header::parse(File *file, long offset, bool checkLength)
   else if(versionBits == 3)
     d->version = Version1;
   else
-    return;
+    return false;
 
   // Set the MPEG layer
 
@@ -211,7 +208,7 @@ void MPEG::Header::parse(File *file, long offset, bool checkLength)
   else if(layerBits == 3)
     d->layer = 1;
   else
-    return;
+    return false;
 
   d->protectionEnabled = (static_cast<unsigned char>(data[1] & 0x01) == 0);
 
@@ -241,7 +238,7 @@ void MPEG::Header::parse(File *file, long offset, bool checkLength)
   d->bitrate = bitrates[versionIndex][layerIndex][bitrateIndex];
 
   if(d->bitrate == 0)
-    return;
+    return false;
 
   // Set the sample rate
 
@@ -258,7 +255,7 @@ void MPEG::Header::parse(File *file, long offset, bool checkLength)
   d->sampleRate = sampleRates[d->version][samplerateIndex];
 
   if(d->sampleRate == 0) {
-    return;
+    return false;
   }
 
   // The channel mode is encoded as a 2 bit value at the end of the 3nd byte,
@@ -292,6 +289,17 @@ void MPEG::Header::parse(File *file, long offset, bool checkLength)
   if(d->isPadded)
     d->frameLength += paddingSize[layerIndex];
 
+  return true;
+}
+
+void MPEG::Header::parse(File *file, long offset, bool checkLength)
+{
+  file->seek(offset);
+  const ByteVector data = file->readBlock(4);
+
+  if(!parse(data))
+    return;
+
   if(checkLength) {
 
     // Check if the frame length has been calculated correctly, or the next frame
@@ -48,9 +48,11 @@ namespace TagLib {
     {
     public:
       /*!
-       * Parses an MPEG header based on \a data.
+       * Parses an MPEG header based on \a data, the four bytes of the header.
        *
-       * \deprecated
+       * \note Unlike the File based constructor this can't check the frame
+       * length against the following frame, so it's not suitable for seeking
+       * for the first valid frame.
        */
       Header(const ByteVector &data);
 
@@ -168,6 +170,7 @@ namespace TagLib {
 
     private:
       void parse(File *file, long offset, bool checkLength);
+      bool parse(const ByteVector &data);
 
       class HeaderPrivate;
       HeaderPrivate *d;
@@ -34,6 +34,82 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // The size of the windows the frame walk reads the stream in.
+
+  const unsigned int frameWalkBufferSize = 1024 * 1024;
+
+  // The bits which have to be the same in all of the frame headers of a
+  // stream: the synch, the version, the layer and the sample rate.
+
+  const unsigned int frameHeaderMask = 0xFFFE0C00;
+
+  // Counts the frames of the stream starting at \a offset, and their total
+  // size.  Only the bitrate and the padding of the following frames can
+  // differ, so their lengths are looked up in a table made from the first
+  // header.  The stream is read in large windows and the frames are hopped
+  // over within them, and the walk stops at the first header which doesn't
+  // belong to the stream, e.g. that of a tag at the end of the file.
+
+  void walkFrames(MPEG::File *file, long long offset,
+                  unsigned long long &frames, unsigned long long &streamLength)
+  {
+    frames = 0;
+    streamLength = 0;
+
+    file->seek(offset);
+    const ByteVector firstHeader = file->readBlock(4);
+    if(firstHeader.size() < 4)
+      return;
+
+    const unsigned int first = firstHeader.toUInt(0U, true) & frameHeaderMask;
+
+    // The lengths of the frames indexed by the bitrate index and padding bit.
+
+    unsigned int frameLengths[32];
+    for(unsigned int i = 0; i < 32; ++i) {
+      ByteVector data(firstHeader);
+      data[2] = static_cast<char>((data[2] & 0x0D) | ((i >> 1) << 4) | ((i & 1) << 1));
+      const MPEG::Header header(data);
+      frameLengths[i] = header.isValid() ? header.frameLength() : 0;
+    }
+
+    while(true) {
+      file->seek(offset);
+      const ByteVector window = file->readBlock(frameWalkBufferSize);
+      const unsigned char *data = reinterpret_cast<const unsigned char *>(window.data());
+      const unsigned int size = window.size();
+
+      unsigned int position = 0;
+      while(position + 4 <= size) {
+        const unsigned int header = (static_cast<unsigned int>(data[position])     << 24) |
+                                    (static_cast<unsigned int>(data[position + 1]) << 16) |
+                                    (static_cast<unsigned int>(data[position + 2]) << 8)  |
+                                     static_cast<unsigned int>(data[position + 3]);
+
+        if((header & frameHeaderMask) != first)
+          return;
+
+        const unsigned int frameLength = frameLengths[((header >> 11) & 0x1E) | ((header >> 9) & 0x01)];
+        if(frameLength == 0)
+          return;
+
+        ++frames;
+        streamLength += frameLength;
+        position += frameLength;
+      }
+
+      // The next frame header is beyond this window or straddles its end.
+
+      if(size < frameWalkBufferSize)
+        return;
+
+      offset += position;
+    }
+  }
+}
+
 class MPEG::Properties::PropertiesPrivate
 {
 public:
@@ -48,7 +124,9 @@ public:
     channelMode(Header::Stereo),
     protectionEnabled(false),
     isCopyrighted(false),
-    isOriginal(false) {}
+    isOriginal(false),
+    streamOffset(-1),
+    streamEnd(-1) {}
 
   ~PropertiesPrivate()
   {
@@ -66,6 +144,9 @@ public:
   bool protectionEnabled;
   bool isCopyrighted;
   bool isOriginal;
+  SeekPointList seekPoints;
+  long long streamOffset;
+  long long streamEnd;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -76,7 +157,7 @@ MPEG::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
-  read(file);
+  read(file, style);
 }
 
 MPEG::Properties::~Properties()
@@ -149,11 +230,57 @@ bool MPEG::Properties::isOriginal() const
   return d->isOriginal;
 }
 
+MPEG::Properties::SeekPointList MPEG::Properties::seekPoints() const
+{
+  return d->seekPoints;
+}
+
+long long MPEG::Properties::seekOffset(int milliseconds) const
+{
+  if(milliseconds < 0 || milliseconds > d->length || d->streamOffset < 0)
+    return -1;
+
+  // Interpolate between the seek points around the time, the stream start
+  // and end being the outermost ones.
+
+  int time = 0;
+  long long offset = d->streamOffset;
+  int nextTime = d->length;
+  long long nextOffset = d->streamEnd;
+
+  for(SeekPointList::ConstIterator it = d->seekPoints.begin(); it != d->seekPoints.end(); ++it) {
+    if(it->time <= milliseconds) {
+      time = it->time;
+      offset = it->offset;
+    }
+    else {
+      nextTime = it->time;
+      nextOffset = it->offset;
+      break;
+    }
+  }
+
+  if(nextTime <= time)
+    return offset;
+
+  return offset + (nextOffset - offset) * (milliseconds - time) / (nextTime - time);
+}
+
+int MPEG::Properties::encoderDelay() const
+{
+  return d->xingHeader ? d->xingHeader->encoderDelay() : 0;
+}
+
+int MPEG::Properties::encoderPadding() const
+{
+  return d->xingHeader ? d->xingHeader->encoderPadding() : 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::Properties::read(File *file)
+void MPEG::Properties::read(File *file, ReadStyle style)
 {
   // Only the first valid frame is required if we have a VBR header.
 
@@ -184,15 +311,77 @@ void MPEG::Properties::read(File *file)
 
     d->length  = static_cast<int>(length + 0.5);
     d->bitrate = static_cast<int>(d->xingHeader->totalSize() * 8.0 / length + 0.5);
+
+    d->streamOffset = firstFrameOffset;
+    d->streamEnd    = firstFrameOffset + d->xingHeader->totalSize();
+
+    // The table of contents of a Xing header gives the position at each
+    // percent of the length as a fraction of 256 of the stream size.  The
+    // seek table of a VBRI header gives the sizes of the parts of the stream
+    // after its frame, which are of a fixed number of frames.
+
+    const ByteVector toc = d->xingHeader->tableOfContents();
+    for(unsigned int i = 0; i < toc.size(); ++i) {
+      const unsigned int position = static_cast<unsigned char>(toc[i]);
+      d->seekPoints.append(SeekPoint(
+        static_cast<int>(length * i / toc.size() + 0.5),
+        firstFrameOffset + static_cast<long long>(d->xingHeader->totalSize()) * position / 256));
+    }
+
+    const List<unsigned int> vbriTable = d->xingHeader->vbriTable();
+    if(!vbriTable.isEmpty()) {
+      const double timePerEntry = timePerFrame * d->xingHeader->vbriFramesPerEntry();
+      long long offset = firstFrameOffset + firstHeader.frameLength();
+      d->seekPoints.append(SeekPoint(0, offset));
+      unsigned int entry = 0;
+      for(List<unsigned int>::ConstIterator it = vbriTable.begin(); it != vbriTable.end(); ++it) {
+        offset += *it;
+        d->seekPoints.append(SeekPoint(static_cast<int>(timePerEntry * ++entry + 0.5), offset));
+      }
+    }
+  }
+  else if(style == Accurate && firstHeader.samplesPerFrame() > 0 && firstHeader.sampleRate() > 0) {
+
+    // Count the frames, which works for both constant and variable bitrates.
+
+    unsigned long long frames = 0;
+    unsigned long long streamLength = 0;
+    walkFrames(file, firstFrameOffset, frames, streamLength);
+
+    const double timePerFrame = firstHeader.samplesPerFrame() * 1000.0 / firstHeader.sampleRate();
+    const double length = timePerFrame * frames;
+
+    if(length > 0) {
+      d->length  = static_cast<int>(length + 0.5);
+      d->bitrate = static_cast<int>(streamLength * 8.0 / length + 0.5);
+      d->streamOffset = firstFrameOffset;
+      d->streamEnd    = firstFrameOffset + streamLength;
+    }
+  }
+  else if(style == Fast && firstHeader.bitrate() > 0) {
+
+    // Assume a constant bitrate up to the tags at the end of the file.
+
+    d->bitrate = firstHeader.bitrate();
+
+    long long streamEnd = file->length();
+    if(file->hasID3v1Tag())
+      streamEnd -= 128;
+    if(file->hasAPETag())
+      streamEnd -= file->APETag()->footer()->completeTagSize();
+
+    const long long streamLength = streamEnd - firstFrameOffset;
+    if(streamLength > 0) {
+      d->length = static_cast<int>(streamLength * 8.0 / d->bitrate + 0.5);
+      d->streamOffset = firstFrameOffset;
+      d->streamEnd    = streamEnd;
+    }
   }
   else if(firstHeader.bitrate() > 0) {
 
     // Since there was no valid VBR header found, we hope that we're in a constant
     // bitrate file.
 
-    // TODO: Make this more robust with audio property detection for VBR without a
-    // Xing header.
-
     d->bitrate = firstHeader.bitrate();
 
     // Look for the last MPEG audio frame to calculate the stream length.
@@ -205,8 +394,11 @@ void MPEG::Properties::read(File *file)
 
     const Header lastHeader(file, lastFrameOffset, false);
     const long streamLength = lastFrameOffset - firstFrameOffset + lastHeader.frameLength();
-    if(streamLength > 0)
+    if(streamLength > 0) {
       d->length = static_cast<int>(streamLength * 8.0 / d->bitrate + 0.5);
+      d->streamOffset = firstFrameOffset;
+      d->streamEnd    = firstFrameOffset + streamLength;
+    }
   }
 
   d->sampleRate        = firstHeader.sampleRate();
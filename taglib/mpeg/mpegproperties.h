@@ -27,6 +27,7 @@
 #define TAGLIB_MPEGPROPERTIES_H
 
 #include "taglib_export.h"
+#include "tlist.h"
 #include "audioproperties.h"
 
 #include "mpegheader.h"
@@ -43,11 +44,40 @@ namespace TagLib {
     /*!
      * This reads the data from an MPEG Layer III stream found in the
      * AudioProperties API.
+     *
+     * The length and the bitrate of a stream with a Xing or VBRI header are
+     * taken from it.  Otherwise the stream is assumed to have a constant
+     * bitrate, that of its first frame, and they depend on the ReadStyle:
+     *
+     * - Fast: the length is estimated from the size of the file less its
+     *   tags, reading nothing but the first frame.
+     * - Average: the length is that from the first to the last frame, which
+     *   is looked for from the end of the file.
+     * - Accurate: every frame header is read, which gives the exact length
+     *   and average bitrate of streams with a variable bitrate as well.
+     *
+     * The seek table of a Xing or VBRI header is available as seekPoints(),
+     * which maps times to positions in the file without decoding the stream.
      */
 
     class TAGLIB_EXPORT Properties : public AudioProperties
     {
     public:
+      /*!
+       * A point of the seek table: the position in the file of the frame
+       * playing at a time in milliseconds.
+       */
+      struct SeekPoint {
+        SeekPoint(int ms, long long pos) : time(ms), offset(pos) {}
+        int time;
+        long long offset;
+      };
+
+      /*!
+       * List of seek points, in order of time.
+       */
+      typedef TagLib::List<SeekPoint> SeekPointList;
+
       /*!
        * Create an instance of MPEG::Properties with the data read from the
        * MPEG::File \a file.
@@ -137,11 +167,42 @@ namespace TagLib {
        */
       bool isOriginal() const;
 
+      /*!
+       * Returns the seek table of the stream, made from the table of contents
+       * of a Xing header or the seek table of a VBRI header.  This is empty if
+       * the stream has neither.
+       *
+       * \see seekOffset()
+       */
+      SeekPointList seekPoints() const;
+
+      /*!
+       * Returns the position in the file of the frame playing at \a milliseconds,
+       * interpolated between the seek points.  Without seekPoints() this
+       * assumes a constant bitrate.  Returns -1 if the position is unknown.
+       *
+       * \note The position is that of a frame, but the bit reservoir of MPEG
+       * Layer III means that the preceding frames may be needed to decode it.
+       */
+      long long seekOffset(int milliseconds) const;
+
+      /*!
+       * Returns the number of samples the encoder added to the start of the
+       * stream, as given by the LAME extension of the Xing header, or 0.
+       */
+      int encoderDelay() const;
+
+      /*!
+       * Returns the number of samples the encoder added to the end of the
+       * stream, as given by the LAME extension of the Xing header, or 0.
+       */
+      int encoderPadding() const;
+
     private:
       Properties(const Properties &);
       Properties &operator=(const Properties &);
 
-      void read(File *file);
+      void read(File *file, ReadStyle style);
 
       class PropertiesPrivate;
       PropertiesPrivate *d;
@@ -38,12 +38,25 @@ public:
   XingHeaderPrivate() :
     frames(0),
     size(0),
-    type(MPEG::XingHeader::Invalid) {}
+    type(MPEG::XingHeader::Invalid),
+    vbriFramesPerEntry(0),
+    hasLameHeader(false),
+    encoderDelay(0),
+    encoderPadding(0) {}
 
   unsigned int frames;
   unsigned int size;
 
   MPEG::XingHeader::HeaderType type;
+
+  ByteVector tableOfContents;
+  List<unsigned int> vbriTable;
+  unsigned int vbriFramesPerEntry;
+
+  bool hasLameHeader;
+  String encoder;
+  int encoderDelay;
+  int encoderPadding;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -81,6 +94,41 @@ MPEG::XingHeader::HeaderType MPEG::XingHeader::type() const
   return d->type;
 }
 
+ByteVector MPEG::XingHeader::tableOfContents() const
+{
+  return d->tableOfContents;
+}
+
+List<unsigned int> MPEG::XingHeader::vbriTable() const
+{
+  return d->vbriTable;
+}
+
+unsigned int MPEG::XingHeader::vbriFramesPerEntry() const
+{
+  return d->vbriFramesPerEntry;
+}
+
+bool MPEG::XingHeader::hasLameHeader() const
+{
+  return d->hasLameHeader;
+}
+
+String MPEG::XingHeader::encoder() const
+{
+  return d->encoder;
+}
+
+int MPEG::XingHeader::encoderDelay() const
+{
+  return d->encoderDelay;
+}
+
+int MPEG::XingHeader::encoderPadding() const
+{
+  return d->encoderPadding;
+}
+
 int MPEG::XingHeader::xingHeaderOffset(TagLib::MPEG::Header::Version /*v*/,
                                        TagLib::MPEG::Header::ChannelMode /*c*/)
 {
@@ -116,6 +164,36 @@ void MPEG::XingHeader::parse(const ByteVector &data)
     d->frames = data.toUInt(offset + 8,  true);
     d->size   = data.toUInt(offset + 12, true);
     d->type   = Xing;
+
+    // The optional table of contents and quality indicator follow, and then
+    // possibly the LAME extension.
+
+    const unsigned char flags = static_cast<unsigned char>(data[offset + 7]);
+    unsigned int position = offset + 16;
+
+    if(flags & 0x04) {
+      if(data.size() < position + 100)
+        return;
+      d->tableOfContents = data.mid(position, 100);
+      position += 100;
+    }
+
+    if(flags & 0x08)
+      position += 4;
+
+    // The encoder delay and padding are 12 bits each at byte 21 of the LAME
+    // extension.
+
+    if(data.size() >= position + 24) {
+      const ByteVector encoder = data.mid(position, 9);
+      if(encoder.startsWith("LAME") || encoder.startsWith("Lavf") || encoder.startsWith("Lavc")) {
+        const unsigned int delays = data.toUInt(position + 21, 3U, true);
+        d->hasLameHeader  = true;
+        d->encoder        = String(encoder.mid(0, encoder.find('\0')));
+        d->encoderDelay   = static_cast<int>(delays >> 12);
+        d->encoderPadding = static_cast<int>(delays & 0x0FFF);
+      }
+    }
   }
   else {
 
@@ -135,6 +213,23 @@ void MPEG::XingHeader::parse(const ByteVector &data)
       d->frames = data.toUInt(offset + 14, true);
       d->size   = data.toUInt(offset + 10, true);
       d->type   = VBRI;
+
+      // The seek table follows, its entries being scaled sizes of 1 to 4
+      // bytes.
+
+      const unsigned int entries   = data.toUShort(offset + 18, true);
+      const unsigned int scale     = data.toUShort(offset + 20, true);
+      const unsigned int entrySize = data.toUShort(offset + 22, true);
+
+      if(entrySize < 1 || entrySize > 4 ||
+         data.size() < static_cast<unsigned long>(offset + 26 + entries * entrySize)) {
+        debug("MPEG::XingHeader::parse() -- VBRI seek table is invalid or too short.");
+        return;
+      }
+
+      d->vbriFramesPerEntry = data.toUShort(offset + 24, true);
+      for(unsigned int i = 0; i < entries; ++i)
+        d->vbriTable.append(data.toUInt(offset + 26 + i * entrySize, entrySize, true) * scale);
     }
   }
 }
@@ -27,6 +27,8 @@
 #define TAGLIB_XINGHEADER_H
 
 #include "mpegheader.h"
+#include "tlist.h"
+#include "tstring.h"
 #include "taglib_export.h"
 
 namespace TagLib {
@@ -42,9 +44,10 @@ namespace TagLib {
     /*!
      * This is a minimalistic implementation of the Xing/VBRI VBR headers.
      * Xing/VBRI headers are often added to VBR (variable bit rate) MP3 streams
-     * to make it easy to compute the length and quality of a VBR stream.  Our
-     * implementation is only concerned with the total size of the stream (so
-     * that we can calculate the total playing time and the average bitrate).
+     * to make it easy to compute the length and quality of a VBR stream.  Besides
+     * the total size of the stream (so that we can calculate the total playing
+     * time and the average bitrate) the seek tables of both, and the encoder
+     * delay and padding of the LAME extension of Xing headers, are read.
      * It uses <a href="http://home.pcisys.net/~melanson/codecs/mp3extensions.txt">
      * this text</a> and the XMMS sources as references.
      */
@@ -105,6 +108,52 @@ namespace TagLib {
        */
       HeaderType type() const;
 
+      /*!
+       * Returns the table of contents of a Xing header: 100 bytes, the byte
+       * at i giving the position in the stream at i percent of its length as
+       * a fraction of 256 of totalSize().  This is empty if the header has no
+       * table of contents or is a VBRI header.
+       */
+      ByteVector tableOfContents() const;
+
+      /*!
+       * Returns the seek table of a VBRI header: the sizes in bytes of the
+       * consecutive parts of the stream following the frame of the header,
+       * each of which is vbriFramesPerEntry() frames long.  This is empty for
+       * Xing headers.
+       */
+      List<unsigned int> vbriTable() const;
+
+      /*!
+       * Returns the number of frames covered by each entry of vbriTable().
+       */
+      unsigned int vbriFramesPerEntry() const;
+
+      /*!
+       * Returns true if the Xing header is followed by a LAME extension, as
+       * written by LAME and FFmpeg, which gives the encoder delay and padding.
+       */
+      bool hasLameHeader() const;
+
+      /*!
+       * Returns the encoder which wrote the LAME extension, e.g. "LAME3.100".
+       */
+      String encoder() const;
+
+      /*!
+       * Returns the number of samples the encoder added to the start of the
+       * stream, which a gapless player skips.  This is 0 without a LAME
+       * extension.
+       */
+      int encoderDelay() const;
+
+      /*!
+       * Returns the number of samples the encoder added to the end of the
+       * stream, which a gapless player skips.  This is 0 without a LAME
+       * extension.
+       */
+      int encoderPadding() const;
+
       /*!
        * Returns the offset for the start of this Xing header, given the
        * version and channels of the frame
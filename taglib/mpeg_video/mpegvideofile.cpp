@@ -1,5 +1,6 @@
 #include "mpegvideofile.h"
 #include "tdebug.h"
+#include "tpropertymap.h"
 #include "id3v1/id3v1tag.h"
 
 using namespace TagLib;
@@ -34,7 +35,7 @@ TagLib::MPEG_VIDEO::File::File(TagLib::FileName file, bool readProperties, TagLi
     d(new FilePrivate())
 {
   if (isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 MPEG_VIDEO::File::File(IOStream *stream, bool readProperties, AudioProperties::ReadStyle propertiesStyle)
@@ -42,7 +43,16 @@ MPEG_VIDEO::File::File(IOStream *stream, bool readProperties, AudioProperties::R
     d(new FilePrivate())
 {
   if (isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
+}
+
+MPEG_VIDEO::File::File(IOStream *stream, ReadOptions readOptions, AudioProperties::ReadStyle propertiesStyle)
+  : TagLib::File(stream),
+    d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if (isOpen())
+    read((readOptions & ReadAudioProperties) != 0, propertiesStyle);
 }
 
 MPEG_VIDEO::File::~File()
@@ -60,20 +70,39 @@ MPEG_VIDEO::Properties *MPEG_VIDEO::File::audioProperties() const
   return d->properties;
 }
 
+PropertyMap MPEG_VIDEO::File::properties() const
+{
+  if (!d->tag) {
+    return PropertyMap();
+  }
+  return d->tag->properties();
+}
+
+PropertyMap MPEG_VIDEO::File::setProperties(const PropertyMap &properties)
+{
+  if (!d->tag) {
+    return properties;
+  }
+  return d->tag->setProperties(properties);
+}
+
 bool MPEG_VIDEO::File::save()
 {
   return false;
 }
 
-void MPEG_VIDEO::File::read(bool readProperties)
+void MPEG_VIDEO::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   readStart();
-  readEnd();
 
-  if (d->startTime < 0) {
-    d->startTime = 0;
+  if (readProperties) {
+    readEnd();
+
+    if (d->startTime < 0) {
+      d->startTime = 0;
+    }
+    d->properties = new Properties(propertiesStyle, d->endTime - d->startTime);
   }
-  d->properties = new Properties(Properties::Average, d->endTime - d->startTime);
   if (isValid()) {
     d->tag = new ID3v1::Tag();
   }
@@ -47,7 +47,8 @@ namespace TagLib {
        * Constructs an MPEG file from \a file.  If \a readProperties is true the
        * file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note The length is taken from the first and the last system time
+       * stamps, which is the same for every \a propertiesStyle.
        */
       File(FileName file, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -59,11 +60,25 @@ namespace TagLib {
        * \note TagLib will *not* take ownership of the stream, the caller is
        * responsible for deleting it after the File object.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note The length is taken from the first and the last system time
+       * stamps, which is the same for every \a propertiesStyle.
        */
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
 
+      /*!
+       * Constructs an MPEG file from \a stream, reading only the
+       * parts of it given by \a readOptions, a combination of
+       * TagLib::File::ReadOptions.
+       *
+       * \note TagLib will *not* take ownership of the stream, the caller is
+       * responsible for deleting it after the File object.
+       *
+       * \note The length is taken from the first and the last system time
+       * stamps, which is the same for every \a propertiesStyle.
+       */
+      File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle propertiesStyle);
+
       /*!
        * Destroys this instance of the File.
        */
@@ -75,6 +90,19 @@ namespace TagLib {
        */
       virtual Tag *tag() const;
 
+      /*!
+       * Implements the unified property interface -- export function.
+       * Returns the properties of tag(), or an empty map if there is none.
+       */
+      PropertyMap properties() const;
+
+      /*!
+       * Implements the unified property interface -- import function.
+       * Sets the properties of tag() in memory only, as save() is not
+       * implemented, or returns all of them if there is no tag.
+       */
+      PropertyMap setProperties(const PropertyMap &);
+
       /*!
        * Returns the MPEG::Properties for this file.  If no properties
        * were read then this will return a null pointer.
@@ -90,7 +118,7 @@ namespace TagLib {
       File(const File &);
       File &operator=(const File &);
 
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle propertiesStyle);
       void readStart();
       void readEnd();
 
@@ -100,6 +100,16 @@ Ogg::FLAC::File::File(IOStream *stream, bool readProperties,
     read(readProperties, propertiesStyle);
 }
 
+Ogg::FLAC::File::File(IOStream *stream, ReadOptions readOptions,
+                      Properties::ReadStyle propertiesStyle) :
+  Ogg::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0, propertiesStyle);
+}
+
 Ogg::FLAC::File::~File()
 {
   delete d;
@@ -185,7 +195,7 @@ void Ogg::FLAC::File::read(bool readProperties, Properties::ReadStyle properties
 
 
   if(d->hasXiphComment)
-    d->comment = new Ogg::XiphComment(xiphCommentData());
+    d->comment = new Ogg::XiphComment(xiphCommentData(), readOptions());
   else
     d->comment = new Ogg::XiphComment();
 
@@ -284,10 +294,13 @@ void Ogg::FLAC::File::scan()
 
   d->streamInfoData = metadataHeader.mid(4, length);
 
-  // Search through the remaining metadata
+  // Search through the remaining metadata.  Only the headers of the blocks
+  // are read, unless the Vorbis comment is wanted.
+
+  const bool readComment = (readOptions() & (ReadTags | ReadPictures | ReadChapters)) != 0;
 
   while(!lastBlock) {
-    metadataHeader = packet(++ipacket);
+    metadataHeader = packetStart(++ipacket, 4);
     header = metadataHeader.mid(0, 4);
     if(header.size() != 4) {
       debug("Ogg::FLAC::File::scan() -- Invalid Ogg/FLAC metadata header");
@@ -304,7 +317,8 @@ void Ogg::FLAC::File::scan()
     }
     else if(blockType == 4) {
       // debug("Ogg::FLAC::File::scan() -- Vorbis-comments found");
-      d->xiphCommentData = metadataHeader.mid(4, length);
+      if(readComment)
+        d->xiphCommentData = packet(ipacket).mid(4, length);
       d->hasXiphComment = true;
       d->commentPacket = ipacket;
     }
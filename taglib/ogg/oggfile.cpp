@@ -23,6 +23,8 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tbytevectorlist.h>
 #include <tmap.h>
 #include <tstring.h>
@@ -36,6 +38,11 @@ using namespace TagLib;
 
 namespace
 {
+  // Padding of a packet won't be more than 1% of the file size or 1MB.
+
+  const long MinPaddingSize = 1024;
+  const long MaxPaddingSize = 1024 * 1024;
+
   // Returns the first packet index of the right next page to the given one.
   unsigned int nextPacketIndex(const Ogg::Page *page)
   {
@@ -44,12 +51,193 @@ namespace
     else
       return page->firstPacketIndex() + page->packetCount() - 1;
   }
+
+  // Returns the offset in the file of the packet at \a index of \a page.
+
+  long long packetOffset(const Ogg::Page *page, unsigned int index)
+  {
+    const List<int> sizes = page->header()->packetSizes();
+
+    long long offset = page->fileOffset() + page->header()->size();
+    List<int>::ConstIterator size = sizes.begin();
+    for(unsigned int i = 0; i < index; ++i, ++size)
+      offset += *size;
+
+    return offset;
+  }
+
+  // Creates the pages to replace those from \a firstPage to \a lastPage.
+
+  List<Ogg::Page *> paginate(const ByteVectorList &packets,
+                             const Ogg::Page *firstPage, const Ogg::Page *lastPage)
+  {
+    // TODO: This pagination method isn't accurate for what's being done here.
+    // This should account for real possibilities like non-aligned packets and such.
+
+    return Ogg::Page::paginate(packets,
+                               Ogg::Page::SinglePagePerGroup,
+                               firstPage->header()->streamSerialNumber(),
+                               firstPage->pageSequenceNumber(),
+                               firstPage->header()->firstPacketContinued(),
+                               lastPage->header()->lastPacketCompleted());
+  }
+
+  ByteVector render(const List<Ogg::Page *> &pages)
+  {
+    ByteVector data;
+    for(List<Ogg::Page *>::ConstIterator it = pages.begin(); it != pages.end(); ++it)
+      data.append((*it)->render());
+    return data;
+  }
+
+  // Appends zeros to the packet at \a index of \a packets until its pages
+  // render to \a length bytes in \a pageCount pages.  Each zero may add to
+  // the lacing values as well, so this takes a few steps.  Returns the
+  // rendered pages, or an empty ByteVector if no padding up to
+  // \a maxPadding fits.
+
+  ByteVector renderPadded(ByteVectorList packets, unsigned int index,
+                          const Ogg::Page *firstPage, const Ogg::Page *lastPage,
+                          unsigned long length, unsigned int pageCount,
+                          unsigned long unpaddedLength, long maxPadding)
+  {
+    const ByteVector packet = packets[index];
+
+    long padding = 0;
+    long difference = static_cast<long>(length) - static_cast<long>(unpaddedLength);
+
+    for(int step = 0; step < 8 && difference != 0; ++step) {
+      padding += difference;
+      if(padding < 0 || padding > maxPadding)
+        return ByteVector();
+
+      packets[index] = packet;
+      packets[index].resize(packet.size() + static_cast<unsigned int>(padding), '\0');
+
+      List<Ogg::Page *> pages = paginate(packets, firstPage, lastPage);
+      pages.setAutoDelete(true);
+
+      const ByteVector data = render(pages);
+      if(data.size() == length)
+        return pages.size() == pageCount ? data : ByteVector();
+
+      difference = static_cast<long>(length) - static_cast<long>(data.size());
+    }
+
+    return ByteVector();
+  }
+
+  // The largest Ogg page: 27 bytes of header, 255 lacing values and 255
+  // segments of 255 bytes each.
+
+  const unsigned int MaxPageSize = 27 + 255 + 255 * 255;
+
+  // The last page is looked for in tail windows growing from the smaller to
+  // the larger of these sizes, and then by bisection in windows of ProbeSize,
+  // which always hold a complete page.
+
+  const long long MinTailSize = 16 * 1024;
+  const long long MaxTailSize = 256 * 1024;
+  const long long ProbeSize   = 2 * MaxPageSize;
+
+  // Returns the size of the page at \a pos of \a data if all of it is in
+  // \a data and its checksum is right, or 0 otherwise.
+
+  unsigned int checkedPageSize(const ByteVector &data, unsigned int pos)
+  {
+    if(pos + 27 > data.size() || data[pos + 4] != 0)
+      return 0;
+
+    const unsigned int segmentCount = static_cast<unsigned char>(data[pos + 26]);
+    if(segmentCount == 0 || pos + 27 + segmentCount > data.size())
+      return 0;
+
+    unsigned int size = 27 + segmentCount;
+    for(unsigned int i = 0; i < segmentCount; ++i)
+      size += static_cast<unsigned char>(data[pos + 27 + i]);
+
+    if(pos + size > data.size())
+      return 0;
+
+    // The checksum is taken with its own 4 bytes zeroed.
+
+    ByteVector page = data.mid(pos, size);
+    const unsigned int checksum = page.toUInt(22, false);
+    std::fill(page.begin() + 22, page.begin() + 26, '\0');
+
+    return page.checksum() == checksum ? size : 0;
+  }
+
+  // Returns the offset of the last page of the stream \a serial which is
+  // completely within \a length bytes from \a offset of \a file and has the
+  // right checksum, or -1 if there is none.  Only the header fields are
+  // looked at until a candidate is found, and only its checksum is computed.
+
+  long long findLastPage(Ogg::File *file, long long offset, unsigned long length,
+                         unsigned int serial)
+  {
+    const ByteVector data = file->readAt(offset, length);
+
+    for(int pos = static_cast<int>(data.size()) - 27; pos >= 0; --pos) {
+      if(data[pos] == 'O' &&
+         data.containsAt("OggS", pos) &&
+         data.toUInt(pos + 14, false) == serial &&
+         checkedPageSize(data, pos) > 0)
+      {
+        return offset + pos;
+      }
+    }
+
+    return -1;
+  }
+
+  // Returns the offset of the last page of the stream \a serial, whose first
+  // page is at \a firstOffset of \a file, or -1 if it could not be found.
+
+  long long findLastPageOfStream(Ogg::File *file, long long firstOffset, unsigned int serial)
+  {
+    const long long fileLength = file->length();
+
+    // A file with a single stream, or with streams multiplexed up to its end,
+    // has the page near the end, so look at the tail first.
+
+    long long start = fileLength;
+    for(long long size = MinTailSize; size <= MaxTailSize; size *= 2) {
+      start = std::max(firstOffset, fileLength - size);
+
+      const long long offset = findLastPage(file, start, static_cast<unsigned long>(fileLength - start), serial);
+      if(offset >= 0)
+        return offset;
+
+      if(start == firstOffset)
+        return -1;
+    }
+
+    // Otherwise other streams are chained after this one.  The pages of a
+    // chained stream are all before those of the next, so bisect for the
+    // window where they end.
+
+    long long low  = firstOffset;
+    long long high = start;
+
+    while(high - low > ProbeSize) {
+      const long long middle = low + (high - low) / 2;
+
+      if(findLastPage(file, middle, ProbeSize, serial) >= 0)
+        low = middle;
+      else
+        high = middle;
+    }
+
+    return findLastPage(file, low, static_cast<unsigned long>(high - low + MaxPageSize), serial);
+  }
 }
 
 class Ogg::File::FilePrivate
 {
 public:
   FilePrivate() :
+    firstPageOffset(-1),
     firstPageHeader(0),
     lastPageHeader(0)
   {
@@ -64,9 +252,11 @@ public:
 
   unsigned int streamSerialNumber;
   List<Page *> pages;
+  long long firstPageOffset;
   PageHeader *firstPageHeader;
   PageHeader *lastPageHeader;
   Map<unsigned int, ByteVector> dirtyPackets;
+  List<unsigned int> paddablePackets;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -100,23 +290,74 @@ ByteVector Ogg::File::packet(unsigned int i)
   while((*it)->containsPacket(i) == Page::DoesNotContainPacket)
     ++it;
 
-  // If the packet is completely contained in the first page that it's in.
-
   // If the packet is *not* completely contained in the first page that it's a
-  // part of then that packet trails off the end of the page.  Continue appending
-  // the pages' packet data until we hit a page that either does not end with the
-  // packet that we're fetching or where the last packet is complete.
+  // part of then that packet trails off the end of the page.  It goes on at
+  // the start of the following pages until one that either does not end with
+  // the packet or where the last packet is complete.
+
+  // Find the size of the packet from the page headers first, so that its
+  // parts are read straight into a buffer of that size, without the other
+  // packets of the pages.
 
-  ByteVector packet = (*it)->packets()[i - (*it)->firstPacketIndex()];
+  const List<Page *>::ConstIterator first = it;
 
+  unsigned int size = (*it)->header()->packetSizes()[i - (*it)->firstPacketIndex()];
   while(nextPacketIndex(*it) <= i) {
     ++it;
-    packet.append((*it)->packets().front());
+    size += (*it)->header()->packetSizes().front();
+  }
+
+  ByteVector packet(size, 0);
+  unsigned int pos = 0;
+
+  it = first;
+  long long offset = packetOffset(*it, i - (*it)->firstPacketIndex());
+  unsigned int partSize = (*it)->header()->packetSizes()[i - (*it)->firstPacketIndex()];
+
+  while(true) {
+    const ByteVector part = readAt(offset, partSize);
+    std::copy(part.begin(), part.end(), packet.begin() + pos);
+    pos += part.size();
+
+    if(part.size() != partSize || nextPacketIndex(*it) > i)
+      break;
+
+    ++it;
+    offset = packetOffset(*it, 0);
+    partSize = (*it)->header()->packetSizes().front();
+  }
+
+  if(pos != size) {
+    debug("Ogg::File::packet() -- Could not read all of the requested packet.");
+    packet.resize(pos);
   }
 
   return packet;
 }
 
+ByteVector Ogg::File::packetStart(unsigned int i, unsigned int length)
+{
+  if(d->dirtyPackets.contains(i))
+    return d->dirtyPackets[i].mid(0, length);
+
+  if(!readPages(i)) {
+    debug("Ogg::File::packetStart() -- Could not find the requested packet.");
+    return ByteVector();
+  }
+
+  List<Page *>::ConstIterator it = d->pages.begin();
+  while((*it)->containsPacket(i) == Page::DoesNotContainPacket)
+    ++it;
+
+  // Read the part of the packet in its first page directly from the file,
+  // without the other packets of the page.
+
+  const unsigned int index = i - (*it)->firstPacketIndex();
+  const unsigned int size = (*it)->header()->packetSizes()[index];
+
+  return readAt(packetOffset(*it, index), std::min<unsigned int>(length, size));
+}
+
 void Ogg::File::setPacket(unsigned int i, const ByteVector &p)
 {
   if(!readPages(i)) {
@@ -130,11 +371,11 @@ void Ogg::File::setPacket(unsigned int i, const ByteVector &p)
 const Ogg::PageHeader *Ogg::File::firstPageHeader()
 {
   if(!d->firstPageHeader) {
-    const long firstPageHeaderOffset = find("OggS");
-    if(firstPageHeaderOffset < 0)
+    d->firstPageOffset = find("OggS");
+    if(d->firstPageOffset < 0)
       return 0;
 
-    d->firstPageHeader = new PageHeader(this, firstPageHeaderOffset);
+    d->firstPageHeader = new PageHeader(this, static_cast<long>(d->firstPageOffset));
   }
 
   return d->firstPageHeader->isValid() ? d->firstPageHeader : 0;
@@ -143,11 +384,27 @@ const Ogg::PageHeader *Ogg::File::firstPageHeader()
 const Ogg::PageHeader *Ogg::File::lastPageHeader()
 {
   if(!d->lastPageHeader) {
-    const long lastPageHeaderOffset = rfind("OggS");
-    if(lastPageHeaderOffset < 0)
+    const PageHeader *first = firstPageHeader();
+    if(!first)
       return 0;
 
-    d->lastPageHeader = new PageHeader(this, lastPageHeaderOffset);
+    // The last page is that of the stream of the first page, which may be
+    // followed or interleaved with pages of other streams.
+
+    long long lastPageHeaderOffset
+      = findLastPageOfStream(this, d->firstPageOffset, first->streamSerialNumber());
+
+    // Fall back to the last page of any stream, even with a wrong checksum.
+
+    if(lastPageHeaderOffset < 0) {
+      debug("Ogg::File::lastPageHeader() -- Could not find a valid last page of the stream.");
+
+      lastPageHeaderOffset = rfind("OggS");
+      if(lastPageHeaderOffset < 0)
+        return 0;
+    }
+
+    d->lastPageHeader = new PageHeader(this, static_cast<long>(lastPageHeaderOffset));
   }
 
   return d->lastPageHeader->isValid() ? d->lastPageHeader : 0;
@@ -165,6 +422,7 @@ bool Ogg::File::save()
     writePacket(it->first, it->second);
 
   d->dirtyPackets.clear();
+  d->paddablePackets.clear();
 
   return true;
 }
@@ -185,6 +443,14 @@ Ogg::File::File(IOStream *stream) :
 {
 }
 
+void Ogg::File::setPaddablePacket(unsigned int i, const ByteVector &p)
+{
+  setPacket(i, p);
+
+  if(d->dirtyPackets.contains(i) && !d->paddablePackets.contains(i))
+    d->paddablePackets.append(i);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
@@ -259,33 +525,59 @@ void Ogg::File::writePacket(unsigned int i, const ByteVector &packet)
     packets.append(lastPagePackets);
   }
 
-  // TODO: This pagination method isn't accurate for what's being done here.
-  // This should account for real possibilities like non-aligned packets and such.
-
-  List<Page *> pages = Page::paginate(packets,
-                                      Page::SinglePagePerGroup,
-                                      firstPage->header()->streamSerialNumber(),
-                                      firstPage->pageSequenceNumber(),
-                                      firstPage->header()->firstPacketContinued(),
-                                      lastPage->header()->lastPacketCompleted());
+  List<Page *> pages = paginate(packets, firstPage, lastPage);
   pages.setAutoDelete(true);
 
-  // Write the pages.
-
-  ByteVector data;
-  for(it = pages.begin(); it != pages.end(); ++it)
-    data.append((*it)->render());
+  ByteVector data = render(pages);
 
   const unsigned long originalOffset = firstPage->fileOffset();
   const unsigned long originalLength = lastPage->fileOffset() + lastPage->size() - originalOffset;
 
+  int numberOfNewPages
+    = pages.back()->pageSequenceNumber() - lastPage->pageSequenceNumber();
+
+  // A packet which may be padded is padded to fill the pages it was on, so
+  // that only they are written, unless that would waste too much space.
+  // Otherwise it is given some padding for the next time.
+
+  if(d->paddablePackets.contains(i) && (numberOfNewPages != 0 || data.size() != originalLength)) {
+    long maxPadding = length() / 100;
+    maxPadding = std::max(maxPadding, MinPaddingSize);
+    maxPadding = std::min(maxPadding, MaxPaddingSize);
+
+    const unsigned int pageCount
+      = lastPage->pageSequenceNumber() - firstPage->pageSequenceNumber() + 1;
+
+    const ByteVector paddedData
+      = renderPadded(packets, i - firstPage->firstPacketIndex(), firstPage, lastPage,
+                     originalLength, pageCount, data.size(), maxPadding);
+
+    if(!paddedData.isEmpty()) {
+      data = paddedData;
+      numberOfNewPages = 0;
+    }
+    else {
+
+      // The rest of the file has to be moved anyway, so leave room for the
+      // packet to grow or shrink by half the padding allowed the next time.
+
+      ByteVector &paddedPacket = packets[i - firstPage->firstPacketIndex()];
+      paddedPacket.resize(paddedPacket.size() + static_cast<unsigned int>(maxPadding / 2), '\0');
+
+      pages = paginate(packets, firstPage, lastPage);
+      pages.setAutoDelete(true);
+
+      data = render(pages);
+      numberOfNewPages = pages.back()->pageSequenceNumber() - lastPage->pageSequenceNumber();
+    }
+  }
+
+  // Write the pages.
+
   insert(data, originalOffset, originalLength);
 
   // Renumber the following pages if the pages have been split or merged.
 
-  const int numberOfNewPages
-    = pages.back()->pageSequenceNumber() - lastPage->pageSequenceNumber();
-
   if(numberOfNewPages != 0) {
     long pageOffset = originalOffset + data.size();
 
@@ -61,6 +61,16 @@ namespace TagLib {
        */
       ByteVector packet(unsigned int i);
 
+      /*!
+       * Returns at most the first \a length bytes of the i-th packet (starting
+       * from zero) in the Ogg bitstream.  Only the page in which the packet
+       * starts is read, so this is much cheaper than packet() for checking the
+       * type of a large packet.
+       *
+       * \see packet()
+       */
+      ByteVector packetStart(unsigned int i, unsigned int length);
+
       /*!
        * Sets the packet with index \a i to the value \a p.
        */
@@ -102,6 +112,16 @@ namespace TagLib {
        */
       File(IOStream *stream);
 
+      /*!
+       * Sets the packet with index \a i to the value \a p, like setPacket(),
+       * for a packet which may end with any number of zeros, such as the
+       * comment header of Vorbis or Opus.  When the file is saved, zeros are
+       * appended to the packet if that keeps the size and number of the pages
+       * it is on, so that the rest of the file is neither moved nor
+       * renumbered.
+       */
+      void setPaddablePacket(unsigned int i, const ByteVector &p);
+
     private:
       File(const File &);
       File &operator=(const File &);
@@ -146,13 +146,19 @@ ByteVectorList Ogg::Page::packets() const
 
   if(d->file && d->header.isValid()) {
 
-    d->file->seek(d->fileOffset + d->header.size());
+    // Read the data of the page at once and split it into the packets.
+
+    const ByteVector data =
+      d->file->readAt(d->fileOffset + d->header.size(), d->header.dataSize());
 
     List<int> packetSizes = d->header.packetSizes();
 
+    unsigned int offset = 0;
     List<int>::ConstIterator it = packetSizes.begin();
-    for(; it != packetSizes.end(); ++it)
-      l.append(d->file->readBlock(*it));
+    for(; it != packetSizes.end(); ++it) {
+      l.append(data.mid(offset, *it));
+      offset += *it;
+    }
   }
   else
     debug("Ogg::Page::packets() -- attempting to read packets from an invalid page.");
@@ -173,8 +179,7 @@ ByteVector Ogg::Page::render() const
 
   if(d->packets.isEmpty()) {
     if(d->file) {
-      d->file->seek(d->fileOffset + d->header.size());
-      data.append(d->file->readBlock(d->header.dataSize()));
+      data.append(d->file->readAt(d->fileOffset + d->header.size(), d->header.dataSize()));
     }
     else
       debug("Ogg::Page::render() -- this page is empty!");
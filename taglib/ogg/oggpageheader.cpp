@@ -227,17 +227,15 @@ ByteVector Ogg::PageHeader::render() const
 
 void Ogg::PageHeader::read(Ogg::File *file, long pageOffset)
 {
-  file->seek(pageOffset);
+  // An Ogg page header is 27 bytes followed by up to 255 lacing values, so
+  // read enough for the largest header at once.
 
-  // An Ogg page header is at least 27 bytes, so we'll go ahead and read that
-  // much and then get the rest when we're ready for it.
-
-  const ByteVector data = file->readBlock(27);
+  const ByteVector data = file->readAt(pageOffset, 27 + 255);
 
   // Sanity check -- make sure that we were in fact able to read as much data as
   // we asked for and that the page begins with "OggS".
 
-  if(data.size() != 27 || !data.startsWith("OggS")) {
+  if(data.size() < 27 || !data.startsWith("OggS")) {
     debug("Ogg::PageHeader::read() -- error reading page header");
     return;
   }
@@ -258,7 +256,7 @@ void Ogg::PageHeader::read(Ogg::File *file, long pageOffset)
 
   int pageSegmentCount = static_cast<unsigned char>(data[26]);
 
-  const ByteVector pageSegments = file->readBlock(pageSegmentCount);
+  const ByteVector pageSegments = data.mid(27, pageSegmentCount);
 
   // Another sanity check.
 
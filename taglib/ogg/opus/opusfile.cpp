@@ -86,6 +86,15 @@ Opus::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
     read(readProperties);
 }
 
+Opus::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  Ogg::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 Opus::File::~File()
 {
   delete d;
@@ -116,7 +125,8 @@ bool Opus::File::save()
   if(!d->comment)
     d->comment = new Ogg::XiphComment();
 
-  setPacket(1, ByteVector("OpusTags", 8) + d->comment->render(false));
+  // The comment header may end with zeros as padding (RFC 7845, 5.2).
+  setPaddablePacket(1, ByteVector("OpusTags", 8) + d->comment->render(false));
 
   return Ogg::File::save();
 }
@@ -135,7 +145,9 @@ void Opus::File::read(bool readProperties)
     return;
   }
 
-  ByteVector commentHeaderData = packet(1);
+  const bool readComment = (readOptions() & (ReadTags | ReadPictures | ReadChapters)) != 0;
+
+  ByteVector commentHeaderData = readComment ? packet(1) : packetStart(1, 8);
 
   if(!commentHeaderData.startsWith("OpusTags")) {
     setValid(false);
@@ -143,7 +155,10 @@ void Opus::File::read(bool readProperties)
     return;
   }
 
-  d->comment = new Ogg::XiphComment(commentHeaderData.mid(8));
+  if(readComment)
+    d->comment = new Ogg::XiphComment(commentHeaderData.mid(8), readOptions());
+  else
+    d->comment = new Ogg::XiphComment();
 
   if(readProperties)
     d->properties = new Properties(this);
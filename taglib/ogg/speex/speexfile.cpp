@@ -86,6 +86,15 @@ Speex::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle)
     read(readProperties);
 }
 
+Speex::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  Ogg::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 Speex::File::~File()
 {
   delete d;
@@ -134,9 +143,10 @@ void Speex::File::read(bool readProperties)
     return;
   }
 
-  ByteVector commentHeaderData = packet(1);
-
-  d->comment = new Ogg::XiphComment(commentHeaderData);
+  if(readOptions() & (ReadTags | ReadPictures | ReadChapters))
+    d->comment = new Ogg::XiphComment(packet(1), readOptions());
+  else
+    d->comment = new Ogg::XiphComment();
 
   if(readProperties)
     d->properties = new Properties(this);
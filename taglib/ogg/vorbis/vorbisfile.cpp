@@ -91,6 +91,15 @@ Vorbis::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle)
     read(readProperties);
 }
 
+Vorbis::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  Ogg::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 Vorbis::File::~File()
 {
   delete d;
@@ -124,7 +133,8 @@ bool Vorbis::File::save()
     d->comment = new Ogg::XiphComment();
   v.append(d->comment->render());
 
-  setPacket(1, v);
+  // Decoders ignore anything after the framing bit.
+  setPaddablePacket(1, v);
 
   return Ogg::File::save();
 }
@@ -135,7 +145,12 @@ bool Vorbis::File::save()
 
 void Vorbis::File::read(bool readProperties)
 {
-  ByteVector commentHeaderData = packet(1);
+  // The comment header may hold large pictures, so only its ID is read
+  // unless some of its fields are wanted.
+
+  const bool readComment = (readOptions() & (ReadTags | ReadPictures | ReadChapters)) != 0;
+
+  ByteVector commentHeaderData = readComment ? packet(1) : packetStart(1, 7);
 
   if(commentHeaderData.mid(0, 7) != vorbisCommentHeaderID) {
     debug("Vorbis::File::read() - Could not find the Vorbis comment header.");
@@ -143,7 +158,10 @@ void Vorbis::File::read(bool readProperties)
     return;
   }
 
-  d->comment = new Ogg::XiphComment(commentHeaderData.mid(7));
+  if(readComment)
+    d->comment = new Ogg::XiphComment(commentHeaderData.mid(7), readOptions());
+  else
+    d->comment = new Ogg::XiphComment();
 
   if(readProperties)
     d->properties = new Properties(this);
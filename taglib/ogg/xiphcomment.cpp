@@ -25,6 +25,7 @@
 
 #include <tbytevector.h>
 #include <tdebug.h>
+#include <tfile.h>
 
 #include <flacpicture.h>
 #include <xiphcomment.h>
@@ -40,12 +41,106 @@ namespace
   typedef List<FLAC::Picture *> PictureList;
   typedef PictureList::Iterator PictureIterator;
   typedef PictureList::Iterator PictureConstIterator;
+
+  const int fieldReadOptions = File::ReadTags | File::ReadPictures | File::ReadChapters;
+
+  // Returns whether a field with the upper case key \a key is one of the
+  // parts of the file given by the read options.
+
+  bool isFieldWanted(const String &key, int options)
+  {
+    if((options & fieldReadOptions) == fieldReadOptions)
+      return true;
+
+    if(key == "METADATA_BLOCK_PICTURE" || key == "COVERART" || key == "COVERARTMIME")
+      return (options & File::ReadPictures) != 0;
+
+    if(key.startsWith("CHAPTER"))
+      return (options & File::ReadChapters) != 0;
+
+    if(key == "TITLE" || key == "ARTIST" || key == "ALBUM" || key == "DESCRIPTION" ||
+       key == "COMMENT" || key == "GENRE" || key == "DATE" || key == "TRACKNUMBER")
+      return (options & File::ReadBasicTags) != 0;
+
+    return (options & File::ReadExtendedTags) != 0;
+  }
+
+  // The base64 text of a picture field which has not been decoded yet.  It is
+  // either a FLAC picture block (METADATA_BLOCK_PICTURE) or the data of an
+  // image file (COVERART).
+
+  struct PictureField
+  {
+    PictureField(const ByteVector &d, bool c) : data(d), coverArt(c) {}
+
+    ByteVector data;
+    bool coverArt;
+  };
+
+  typedef List<PictureField> PictureFieldList;
+
+  // Checks that the base64 text would decode to some data, without decoding
+  // it.
+
+  bool isBase64(const ByteVector &text)
+  {
+    const unsigned int size = text.size();
+    if(size == 0 || size % 4 != 0)
+      return false;
+
+    const char *data = text.data();
+    for(unsigned int i = 0; i < size; ++i) {
+      const char c = data[i];
+      if((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+         c == '+' || c == '/')
+        continue;
+
+      // Padding may only end the text.
+
+      if(c == '=' && (i == size - 1 || (i == size - 2 && data[size - 1] == '=')))
+        continue;
+
+      return false;
+    }
+
+    return true;
+  }
+
+  // Decodes a picture field.  Returns null if it is not valid.
+
+  FLAC::Picture *parsePicture(const PictureField &field)
+  {
+    const ByteVector data = ByteVector::fromBase64(field.data);
+    if(data.isEmpty()) {
+      debug("Ogg::XiphComment::parsePicture() - Discarding a field. Invalid base64 data");
+      return 0;
+    }
+
+    FLAC::Picture *picture = new FLAC::Picture();
+
+    if(field.coverArt) {
+
+      // Assume it's some type of image file
+
+      picture->setData(data);
+      picture->setMimeType("image/");
+      picture->setType(FLAC::Picture::Other);
+    }
+    else if(!picture->parse(data)) {
+      delete picture;
+      debug("Ogg::XiphComment::parsePicture() - Failed to decode FLAC Picture block");
+      return 0;
+    }
+
+    return picture;
+  }
 }
 
 class Ogg::XiphComment::XiphCommentPrivate
 {
 public:
-  XiphCommentPrivate()
+  XiphCommentPrivate() :
+    readOptions(File::ReadEverything)
   {
     pictureList.setAutoDelete(true);
   }
@@ -54,6 +149,8 @@ public:
   String vendorID;
   String commentField;
   PictureList pictureList;
+  PictureFieldList pictureFields;
+  int readOptions;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -73,6 +170,14 @@ Ogg::XiphComment::XiphComment(const ByteVector &data) :
   parse(data);
 }
 
+Ogg::XiphComment::XiphComment(const ByteVector &data, int readOptions) :
+  TagLib::Tag(),
+  d(new XiphCommentPrivate())
+{
+  d->readOptions = readOptions;
+  parse(data);
+}
+
 Ogg::XiphComment::~XiphComment()
 {
   delete d;
@@ -206,6 +311,7 @@ unsigned int Ogg::XiphComment::fieldCount() const
   for(FieldConstIterator it = d->fieldListMap.begin(); it != d->fieldListMap.end(); ++it)
     count += (*it).second.size();
 
+  count += d->pictureFields.size();
   count += d->pictureList.size();
 
   return count;
@@ -339,6 +445,7 @@ void Ogg::XiphComment::removePicture(FLAC::Picture *picture, bool del)
 
 void Ogg::XiphComment::removeAllPictures()
 {
+  d->pictureFields.clear();
   d->pictureList.clear();
 }
 
@@ -349,6 +456,21 @@ void Ogg::XiphComment::addPicture(FLAC::Picture * picture)
 
 List<FLAC::Picture *> Ogg::XiphComment::pictureList()
 {
+  // Decode the pictures read from the comment, which come before any added
+  // since.
+
+  if(!d->pictureFields.isEmpty()) {
+    const PictureIterator first = d->pictureList.begin();
+
+    for(PictureFieldList::ConstIterator it = d->pictureFields.begin(); it != d->pictureFields.end(); ++it) {
+      FLAC::Picture *picture = parsePicture(*it);
+      if(picture)
+        d->pictureList.insert(first, picture);
+    }
+
+    d->pictureFields.clear();
+  }
+
   return d->pictureList;
 }
 
@@ -398,6 +520,21 @@ ByteVector Ogg::XiphComment::render(bool addFramingBit) const
     }
   }
 
+  // The FLAC picture blocks which have not been decoded are written as they
+  // were read.  COVERART fields are converted, as they always have been.
+
+  for(PictureFieldList::ConstIterator it = d->pictureFields.begin(); it != d->pictureFields.end(); ++it) {
+    ByteVector picture = it->data;
+    if(it->coverArt) {
+      const FLAC::Picture *coverArt = parsePicture(*it);
+      picture = coverArt->render().toBase64();
+      delete coverArt;
+    }
+    data.append(ByteVector::fromUInt(picture.size() + 23, false));
+    data.append("METADATA_BLOCK_PICTURE=");
+    data.append(picture);
+  }
+
   for(PictureConstIterator it = d->pictureList.begin(); it != d->pictureList.end(); ++it) {
     ByteVector picture = (*it)->render().toBase64();
     data.append(ByteVector::fromUInt(picture.size() + 23, false));
@@ -471,39 +608,22 @@ void Ogg::XiphComment::parse(const ByteVector &data)
       continue;
     }
 
+    if(!isFieldWanted(key, d->readOptions))
+      continue;
+
     if(key == "METADATA_BLOCK_PICTURE" || key == "COVERART") {
 
-      // Handle Pictures separately
+      // Keep the encoded picture until pictureList() is called, so that the
+      // pictures of a comment which is only read for its text are never
+      // decoded.  Only the base64 text is checked here.
 
-      const ByteVector picturedata = ByteVector::fromBase64(entry.mid(sep + 1));
-      if(picturedata.isEmpty()) {
+      const ByteVector text = entry.mid(sep + 1);
+      if(!isBase64(text)) {
         debug("Ogg::XiphComment::parse() - Discarding a field. Invalid base64 data");
         continue;
       }
 
-      if(key[0] == L'M') {
-
-        // Decode FLAC Picture
-
-        FLAC::Picture * picture = new FLAC::Picture();
-        if(picture->parse(picturedata)) {
-          d->pictureList.append(picture);
-        }
-        else {
-          delete picture;
-          debug("Ogg::XiphComment::parse() - Failed to decode FLAC Picture block");
-        }
-      }
-      else {
-
-        // Assume it's some type of image file
-
-        FLAC::Picture * picture = new FLAC::Picture();
-        picture->setData(picturedata);
-        picture->setMimeType("image/");
-        picture->setType(FLAC::Picture::Other);
-        d->pictureList.append(picture);
-      }
+      d->pictureFields.append(PictureField(text, key[0] == L'C'));
     }
     else {
 
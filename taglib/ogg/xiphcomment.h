@@ -75,6 +75,12 @@ namespace TagLib {
        */
       XiphComment(const ByteVector &data);
 
+      /*!
+       * Constructs a Vorbis comment from \a data, keeping only the fields
+       * given by \a readOptions, a combination of File::ReadOptions.
+       */
+      XiphComment(const ByteVector &data, int readOptions);
+
       /*!
        * Destroys this instance of the XiphComment.
        */
@@ -233,6 +239,13 @@ namespace TagLib {
 
       /*!
        * Returns a list of pictures attached to the xiph comment.
+       *
+       * \note The pictures read from the comment are decoded by the first
+       * call, not when the comment is parsed, and keep the order they had in
+       * the comment.  Until then fieldCount() counts them and render() writes
+       * them back as they were read, including a METADATA_BLOCK_PICTURE field
+       * which is valid base64 but not a valid picture block; this call drops
+       * such fields, as parsing the comment used to.
        */
       List<FLAC::Picture *> pictureList();
 
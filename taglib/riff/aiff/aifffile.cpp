@@ -86,6 +86,15 @@ RIFF::AIFF::File::File(IOStream *stream, bool readProperties, Properties::ReadSt
     read(readProperties);
 }
 
+RIFF::AIFF::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  RIFF::File(stream, BigEndian),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 RIFF::AIFF::File::~File()
 {
   delete d;
@@ -26,6 +26,7 @@
 #include <tbytevector.h>
 #include <tdebug.h>
 #include <tagutils.h>
+#include <tpropertymap.h>
 
 #include "avifile.h"
 #include "infotag.h"
@@ -53,20 +54,29 @@ public:
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-RIFF::AVI::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+RIFF::AVI::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   RIFF::File(file, LittleEndian),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-RIFF::AVI::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+RIFF::AVI::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   RIFF::File(stream, LittleEndian),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
+}
+
+RIFF::AVI::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle propertiesStyle) :
+  RIFF::File(stream, LittleEndian),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0, propertiesStyle);
 }
 
 RIFF::AVI::File::~File()
@@ -79,6 +89,20 @@ RIFF::Info::Tag *RIFF::AVI::File::tag() const
   return d->tag;
 }
 
+PropertyMap RIFF::AVI::File::properties() const
+{
+  if(!d->tag)
+    return PropertyMap();
+  return d->tag->properties();
+}
+
+PropertyMap RIFF::AVI::File::setProperties(const PropertyMap &properties)
+{
+  if(!d->tag)
+    return properties;
+  return d->tag->setProperties(properties);
+}
+
 bool RIFF::AVI::File::save()
 {
   // STUB!
@@ -94,12 +118,12 @@ RIFF::AVI::Properties *RIFF::AVI::File::audioProperties() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void RIFF::AVI::File::read(bool readProperties)
+void RIFF::AVI::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   for(unsigned int i = 0; i < chunkCount(); ++i) {
     const ByteVector name = chunkName(i);
 
-    if(name == "LIST") {
+    if(name == "LIST" && (readOptions() & ReadTags)) {
         const ByteVector &data = chunkData(i);
         if(data.startsWith("INFO")) {
             d->tag = new RIFF::Info::Tag(data);
@@ -108,5 +132,5 @@ void RIFF::AVI::File::read(bool readProperties)
   }
 
   if(readProperties)
-    d->properties = new Properties(this, Properties::Average);
+    d->properties = new Properties(this, propertiesStyle);
 }
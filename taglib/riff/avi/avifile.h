@@ -58,13 +58,25 @@ namespace TagLib {
          * Constructs a AVI file from \a file.  If \a readProperties is true the
          * file's audio properties will also be read.
          *
-         * \note In the current implementation, \a propertiesStyle is ignored.
+         * \note The properties are read from the stream headers only, which is
+         * the same for every \a propertiesStyle.
          */
         File(FileName file, bool readProperties = true,
              Properties::ReadStyle propertiesStyle = Properties::Average);
 
         File(IOStream* stream, bool readProperties = true,
              Properties::ReadStyle propertiesStyle = Properties::Average);
+
+        /*!
+         * Constructs a AVI file from \a stream, reading only the parts of it
+         * given by \a readOptions, a combination of TagLib::File::ReadOptions.
+         *
+         * \note The properties are read from the stream headers only, which is
+         * the same for every \a propertiesStyle.
+         */
+        File(IOStream *stream, ReadOptions readOptions,
+             Properties::ReadStyle propertiesStyle);
+
         /*!
          * Destroys this instance of the File.
          */
@@ -81,6 +93,21 @@ namespace TagLib {
          */
         Info::Tag *tag() const;
 
+        /*!
+         * Implements the unified property interface -- export function.
+         * This method forwards to the RIFF INFO tag, and returns an empty map
+         * if the file has none.
+         */
+        PropertyMap properties() const;
+
+        /*!
+         * Implements the unified property interface -- import function.
+         * This method forwards to the RIFF INFO tag.  As save() is not
+         * implemented, the properties are only set in memory, and all of them
+         * are returned if the file has no tag.
+         */
+        PropertyMap setProperties(const PropertyMap &);
+
         /*!
          * \warning STUB! Not implemented.
          */
@@ -96,7 +123,7 @@ namespace TagLib {
         File(const File &);
         File &operator=(const File &);
 
-        void read(bool readProperties);
+        void read(bool readProperties, Properties::ReadStyle propertiesStyle);
 
         friend class Properties;
 
@@ -146,8 +146,7 @@ ByteVector RIFF::File::chunkData(unsigned int i)
     return ByteVector();
   }
 
-  seek(d->chunks[i].offset);
-  return readBlock(d->chunks[i].size);
+  return readAt(d->chunks[i].offset, d->chunks[i].size);
 }
 
 void RIFF::File::setChunkData(unsigned int i, const ByteVector &data)
@@ -283,23 +282,23 @@ void RIFF::File::removeChunk(const ByteVector &name)
 void RIFF::File::read()
 {
   const bool bigEndian = (d->endianness == BigEndian);
+  const long long fileLength = length();
 
   long offset = tell();
 
   offset += 4;
   d->sizeOffset = offset;
 
-  seek(offset);
-  d->size = readBlock(4).toUInt(bigEndian);
+  d->size = readAt(offset, 4).toUInt(bigEndian);
 
   offset += 8;
 
   // + 8: chunk header at least, fix for additional junk bytes
-  while(offset + 8 <= length()) {
+  while(offset + 8 <= fileLength) {
 
-    seek(offset);
-    const ByteVector   chunkName = readBlock(4);
-    const unsigned int chunkSize = readBlock(4).toUInt(bigEndian);
+    const ByteVector   header    = readAt(offset, 8);
+    const ByteVector   chunkName = header.mid(0, 4);
+    const unsigned int chunkSize = header.toUInt(4U, bigEndian);
 
     if(!isValidChunkName(chunkName)) {
       lastError = ERROR_INVALID_CHUNK_NAME;
@@ -308,7 +307,7 @@ void RIFF::File::read()
       break;
     }
 
-    if(static_cast<long long>(offset) + 8 + chunkSize > length()) {
+    if(static_cast<long long>(offset) + 8 + chunkSize > fileLength) {
       lastError = ERROR_INVALID_CHUNK_SIZE;
       debug("RIFF::File::read() -- Chunk '" + chunkName + "' has invalid size (larger than the file size)");
       setValid(false);
@@ -326,8 +325,7 @@ void RIFF::File::read()
     // Check padding
 
     if(offset & 1) {
-      seek(offset);
-      const ByteVector iByte = readBlock(1);
+      const ByteVector iByte = readAt(offset, 1);
       if(iByte.size() == 1 && iByte[0] == '\0') {
         chunk.padding = 1;
         offset++;
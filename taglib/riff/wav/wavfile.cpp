@@ -39,6 +39,24 @@ using namespace TagLib;
 namespace
 {
   enum { ID3v2Index = 0, InfoIndex = 1 };
+
+  // Removes the fields of an INFO tag which are not wanted by the read
+  // options.  The tag is small, so it is read as a whole anyway.
+
+  void removeUnwantedFields(RIFF::Info::Tag *tag, int options)
+  {
+    if((options & File::ReadTags) == File::ReadTags)
+      return;
+
+    const RIFF::Info::FieldListMap fields = tag->fieldListMap();
+    for(RIFF::Info::FieldListMap::ConstIterator it = fields.begin(); it != fields.end(); ++it) {
+      const ByteVector &id = it->first;
+      const bool basic = id == "INAM" || id == "IART" || id == "IPRD" || id == "ICMT" ||
+                         id == "IGNR" || id == "ICRD" || id == "IPRT";
+      if(!(options & (basic ? File::ReadBasicTags : File::ReadExtendedTags)))
+        tag->removeField(id);
+    }
+  }
 }
 
 class RIFF::WAV::File::FilePrivate
@@ -93,6 +111,15 @@ RIFF::WAV::File::File(IOStream *stream, bool readProperties, Properties::ReadSty
     read(readProperties);
 }
 
+RIFF::WAV::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  RIFF::File(stream, LittleEndian),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 RIFF::WAV::File::~File()
 {
   delete d;
@@ -213,11 +240,13 @@ void RIFF::WAV::File::read(bool readProperties)
         debug("RIFF::WAV::File::read() - Duplicate ID3v2 tag found.");
       }
     }
-    else if(name == "LIST") {
+    else if(name == "LIST" && (readOptions() & ReadTags)) {
       const ByteVector data = chunkData(i);
       if(data.startsWith("INFO")) {
         if(!d->tag[InfoIndex]) {
-          d->tag.set(InfoIndex, new RIFF::Info::Tag(data));
+          RIFF::Info::Tag *infoTag = new RIFF::Info::Tag(data);
+          removeUnwantedFields(infoTag, readOptions());
+          d->tag.set(InfoIndex, infoTag);
           d->hasInfo = true;
         }
         else {
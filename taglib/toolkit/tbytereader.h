@@ -0,0 +1,187 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_TBYTEREADER_H
+#define TAGLIB_TBYTEREADER_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include <cstring>
+
+#include <tbytevector.h>
+#include "tutils.h"
+
+namespace TagLib
+{
+  namespace Utils
+  {
+    namespace
+    {
+      template <class T>
+      T readNumber(const char *data, bool mostSignificantByteFirst)
+      {
+        // Uses memcpy instead of reinterpret_cast to avoid an alignment exception.
+        T value;
+        ::memcpy(&value, data, sizeof(T));
+
+        if(mostSignificantByteFirst != (systemByteOrder() == BigEndian))
+          return byteSwap(value);
+        else
+          return value;
+      }
+
+      /*!
+       * Decodes the EBML variable length integer at \a data, which holds
+       * \a size bytes, into \a value.  If \a keepMarker is true the length
+       * marker bit is kept, as it is for element IDs.
+       *
+       * Returns the length of the integer in bytes, or 0 if the first byte is
+       * zero or \a data is too short.
+       */
+      inline unsigned int decodeVInt(const char *data, unsigned int size,
+                                     unsigned long long &value, bool keepMarker = false)
+      {
+        if(size == 0)
+          return 0;
+
+        const unsigned char first = static_cast<unsigned char>(data[0]);
+        if(first == 0)
+          return 0;
+
+        unsigned int length = 1;
+        while(!(first & (0x80 >> (length - 1))))
+          ++length;
+
+        if(length > size)
+          return 0;
+
+        const unsigned long long marker = keepMarker ? 0 : 1ULL << (length * 7);
+
+        if(size >= 8) {
+          // Load all eight bytes at once and drop the ones past the integer.
+          value = readNumber<unsigned long long>(data, true) >> ((8 - length) * 8);
+        }
+        else {
+          value = 0;
+          for(unsigned int i = 0; i < length; ++i)
+            value = (value << 8) | static_cast<unsigned char>(data[i]);
+        }
+
+        value &= ~marker;
+        return length;
+      }
+
+      /*!
+       * A cursor over the contents of a ByteVector, for parsing fixed layout
+       * headers without creating a temporary ByteVector for every field.
+       *
+       * The reader refers to the data of the vector it was created from, which
+       * therefore must not be modified or destroyed while the reader is in use.
+       * Each read function returns false, and leaves the position unchanged, if
+       * there is not enough data left.
+       */
+      class ByteReader
+      {
+      public:
+        explicit ByteReader(const ByteVector &data, unsigned int offset = 0) :
+          m_data(data.data()),
+          m_size(data.size()),
+          m_position(offset < data.size() ? offset : data.size()) {}
+
+        unsigned int position() const { return m_position; }
+        unsigned int remaining() const { return m_size - m_position; }
+        bool atEnd() const { return m_position == m_size; }
+
+        bool skip(unsigned int count)
+        {
+          if(count > remaining())
+            return false;
+          m_position += count;
+          return true;
+        }
+
+        bool readByte(unsigned char &value)
+        {
+          if(atEnd())
+            return false;
+          value = static_cast<unsigned char>(m_data[m_position++]);
+          return true;
+        }
+
+        bool readShort(unsigned short &value, bool mostSignificantByteFirst = true)
+        {
+          return readFixed(value, mostSignificantByteFirst);
+        }
+
+        bool readUInt(unsigned int &value, bool mostSignificantByteFirst = true)
+        {
+          return readFixed(value, mostSignificantByteFirst);
+        }
+
+        bool readLongLong(unsigned long long &value, bool mostSignificantByteFirst = true)
+        {
+          return readFixed(value, mostSignificantByteFirst);
+        }
+
+        bool readVInt(unsigned long long &value, unsigned int &length, bool keepMarker = false)
+        {
+          length = decodeVInt(m_data + m_position, remaining(), value, keepMarker);
+          m_position += length;
+          return length != 0;
+        }
+
+        bool readBytes(ByteVector &value, unsigned int count)
+        {
+          if(count > remaining())
+            return false;
+          value = ByteVector(m_data + m_position, count);
+          m_position += count;
+          return true;
+        }
+
+      private:
+        template <class T>
+        bool readFixed(T &value, bool mostSignificantByteFirst)
+        {
+          if(sizeof(T) > remaining())
+            return false;
+          value = readNumber<T>(m_data + m_position, mostSignificantByteFirst);
+          m_position += sizeof(T);
+          return true;
+        }
+
+        const char *m_data;
+        unsigned int m_size;
+        unsigned int m_position;
+      };
+    }
+  }
+}
+
+#endif
+
+#endif
@@ -37,6 +37,14 @@
 
 #include "tbytevector.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define TAGLIB_BASE64_SSE2
+# include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+# define TAGLIB_BASE64_NEON
+# include <arm_neon.h>
+#endif
+
 // This is a bit ugly to keep writing over and over again.
 
 // A rather obscure feature of the C++ spec that I hadn't thought of that makes
@@ -121,6 +129,29 @@ T toNumber(const ByteVector &v, size_t offset, size_t length, bool mostSignifica
 
   length = std::min(length, v.size() - offset);
 
+  if(length == 0)
+    return 0;
+
+  if(length <= sizeof(T) && offset + sizeof(T) <= v.size()) {
+    // Load a whole number of type T, as below, and drop the bytes past the
+    // requested length instead of shifting in one byte at a time.
+    const bool isBigEndian = (Utils::systemByteOrder() == Utils::BigEndian);
+    const bool swap = (mostSignificantByteFirst != isBigEndian);
+
+    T tmp;
+    ::memcpy(&tmp, v.data() + offset, sizeof(T));
+
+    if(swap)
+      tmp = Utils::byteSwap(tmp);
+
+    if(length == sizeof(T))
+      return tmp;
+    else if(mostSignificantByteFirst)
+      return tmp >> ((sizeof(T) - length) * 8);
+    else
+      return tmp & ((static_cast<T>(1) << (length * 8)) - 1);
+  }
+
   T sum = 0;
   for(size_t i = 0; i < length; i++) {
     const size_t shift = (mostSignificantByteFirst ? length - 1 - i : i) * 8;
@@ -252,6 +283,298 @@ long double toFloat80(const ByteVector &v, size_t offset)
     return val;
 }
 
+namespace
+{
+  const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  const unsigned char base64Values[256] = {
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x3e,0x80,0x80,0x80,0x3f,
+    0x34,0x35,0x36,0x37,0x38,0x39,0x3a,0x3b,0x3c,0x3d,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,
+    0x0f,0x10,0x11,0x12,0x13,0x14,0x15,0x16,0x17,0x18,0x19,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x1a,0x1b,0x1c,0x1d,0x1e,0x1f,0x20,0x21,0x22,0x23,0x24,0x25,0x26,0x27,0x28,
+    0x29,0x2a,0x2b,0x2c,0x2d,0x2e,0x2f,0x30,0x31,0x32,0x33,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80
+  };
+
+#if defined(TAGLIB_BASE64_SSE2)
+
+  // Each call handles 12 bytes of binary data and 16 characters of text.
+
+  const size_t Base64BlockBytes = 12;
+  const size_t Base64BlockChars = 16;
+
+  inline __m128i inRange(__m128i v, char lo, char hi)
+  {
+    // Bytes above 0x7F are negative, so they never match a range.
+
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+  }
+
+  inline void encodeBase64Block(const unsigned char *src, char *dst)
+  {
+    // Spread the four 24-bit groups into 32-bit lanes and split them into
+    // 6-bit indices, one per byte.
+
+    const __m128i groups = _mm_setr_epi32(
+      (src[0] << 16) | (src[1]  << 8) | src[2],
+      (src[3] << 16) | (src[4]  << 8) | src[5],
+      (src[6] << 16) | (src[7]  << 8) | src[8],
+      (src[9] << 16) | (src[10] << 8) | src[11]);
+
+    const __m128i mask = _mm_set1_epi32(0x3F);
+    __m128i idx = _mm_and_si128(_mm_srli_epi32(groups, 18), mask);
+    idx = _mm_or_si128(idx, _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(groups, 12), mask), 8));
+    idx = _mm_or_si128(idx, _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(groups, 6),  mask), 16));
+    idx = _mm_or_si128(idx, _mm_slli_epi32(_mm_and_si128(groups, mask), 24));
+
+    // Map the indices to the alphabet by adding a per-range offset.
+
+    __m128i offset = _mm_set1_epi8('A');
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(idx, _mm_set1_epi8(25)), _mm_set1_epi8('a' - 26 - 'A')));
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(idx, _mm_set1_epi8(51)), _mm_set1_epi8('0' - 52 - 'a' + 26)));
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(idx, _mm_set1_epi8(61)), _mm_set1_epi8('+' - 62 - '0' + 52)));
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(idx, _mm_set1_epi8(62)), _mm_set1_epi8('/' - 63 - '+' + 62)));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_add_epi8(idx, offset));
+  }
+
+  inline bool decodeBase64Block(const unsigned char *src, unsigned char *dst)
+  {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+
+    const __m128i upper = inRange(in, 'A', 'Z');
+    const __m128i lower = inRange(in, 'a', 'z');
+    const __m128i digit = inRange(in, '0', '9');
+    const __m128i plus  = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                       _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+    if(_mm_movemask_epi8(valid) != 0xFFFF)
+      return false;
+
+    __m128i offset = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+    offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    offset = _mm_or_si128(offset, _mm_and_si128(plus,  _mm_set1_epi8(62 - '+')));
+    offset = _mm_or_si128(offset, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+
+    const __m128i values = _mm_add_epi8(in, offset);
+
+    // Merge the four 6-bit values of each lane into a 24-bit group and store
+    // it most significant byte first.
+
+    const __m128i mask = _mm_set1_epi32(0x3F);
+    __m128i groups = _mm_slli_epi32(_mm_and_si128(values, mask), 18);
+    groups = _mm_or_si128(groups, _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(values, 8),  mask), 12));
+    groups = _mm_or_si128(groups, _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(values, 16), mask), 6));
+    groups = _mm_or_si128(groups, _mm_srli_epi32(values, 24));
+
+    unsigned int out[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), groups);
+
+    for(int i = 0; i < 4; ++i) {
+      dst[i * 3 + 0] = static_cast<unsigned char>(out[i] >> 16);
+      dst[i * 3 + 1] = static_cast<unsigned char>(out[i] >> 8);
+      dst[i * 3 + 2] = static_cast<unsigned char>(out[i]);
+    }
+
+    return true;
+  }
+
+#elif defined(TAGLIB_BASE64_NEON)
+
+  // Each call handles 48 bytes of binary data and 64 characters of text.
+
+  const size_t Base64BlockBytes = 48;
+  const size_t Base64BlockChars = 64;
+
+  inline void encodeBase64Block(const unsigned char *src, char *dst)
+  {
+    const uint8x16x3_t in = vld3q_u8(src);
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+
+    uint8x16x4_t table;
+    for(int i = 0; i < 4; ++i)
+      table.val[i] = vld1q_u8(reinterpret_cast<const uint8_t *>(base64Alphabet) + i * 16);
+
+    uint8x16x4_t out;
+    out.val[0] = vshrq_n_u8(in.val[0], 2);
+    out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+    out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+    out.val[3] = vandq_u8(in.val[2], mask);
+
+    for(int i = 0; i < 4; ++i)
+      out.val[i] = vqtbl4q_u8(table, out.val[i]);
+
+    vst4q_u8(reinterpret_cast<uint8_t *>(dst), out);
+  }
+
+  inline uint8x16_t inRange(uint8x16_t v, unsigned char lo, unsigned char hi)
+  {
+    return vandq_u8(vcgeq_u8(v, vdupq_n_u8(lo)), vcleq_u8(v, vdupq_n_u8(hi)));
+  }
+
+  inline uint8x16_t decodeBase64Lane(uint8x16_t in, uint8x16_t &invalid)
+  {
+    const uint8x16_t upper = inRange(in, 'A', 'Z');
+    const uint8x16_t lower = inRange(in, 'a', 'z');
+    const uint8x16_t digit = inRange(in, '0', '9');
+    const uint8x16_t plus  = vceqq_u8(in, vdupq_n_u8('+'));
+    const uint8x16_t slash = vceqq_u8(in, vdupq_n_u8('/'));
+
+    const uint8x16_t valid = vorrq_u8(vorrq_u8(upper, lower),
+                                      vorrq_u8(digit, vorrq_u8(plus, slash)));
+    invalid = vorrq_u8(invalid, vmvnq_u8(valid));
+
+    uint8x16_t offset = vandq_u8(upper, vdupq_n_u8(static_cast<unsigned char>(-'A')));
+    offset = vorrq_u8(offset, vandq_u8(lower, vdupq_n_u8(static_cast<unsigned char>(26 - 'a'))));
+    offset = vorrq_u8(offset, vandq_u8(digit, vdupq_n_u8(static_cast<unsigned char>(52 - '0'))));
+    offset = vorrq_u8(offset, vandq_u8(plus,  vdupq_n_u8(static_cast<unsigned char>(62 - '+'))));
+    offset = vorrq_u8(offset, vandq_u8(slash, vdupq_n_u8(static_cast<unsigned char>(63 - '/'))));
+
+    return vaddq_u8(in, offset);
+  }
+
+  inline bool decodeBase64Block(const unsigned char *src, unsigned char *dst)
+  {
+    const uint8x16x4_t in = vld4q_u8(src);
+
+    uint8x16_t invalid = vdupq_n_u8(0);
+    const uint8x16_t a = decodeBase64Lane(in.val[0], invalid);
+    const uint8x16_t b = decodeBase64Lane(in.val[1], invalid);
+    const uint8x16_t c = decodeBase64Lane(in.val[2], invalid);
+    const uint8x16_t d = decodeBase64Lane(in.val[3], invalid);
+
+    if(vmaxvq_u8(invalid) != 0)
+      return false;
+
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+    out.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+    vst3q_u8(dst, out);
+
+    return true;
+  }
+
+#endif
+
+  void encodeBase64(const unsigned char *src, size_t len, char *dst)
+  {
+#if defined(TAGLIB_BASE64_SSE2) || defined(TAGLIB_BASE64_NEON)
+
+    while(len >= Base64BlockBytes) {
+      encodeBase64Block(src, dst);
+      src += Base64BlockBytes;
+      dst += Base64BlockChars;
+      len -= Base64BlockBytes;
+    }
+
+#endif
+
+    while(len >= 3) {
+      const unsigned int group = (src[0] << 16) | (src[1] << 8) | src[2];
+      dst[0] = base64Alphabet[(group >> 18) & 0x3f];
+      dst[1] = base64Alphabet[(group >> 12) & 0x3f];
+      dst[2] = base64Alphabet[(group >>  6) & 0x3f];
+      dst[3] = base64Alphabet[group & 0x3f];
+      src += 3;
+      dst += 4;
+      len -= 3;
+    }
+
+    if(len) {
+      dst[0] = base64Alphabet[(src[0] >> 2) & 0x3f];
+      if(len > 1) {
+        dst[1] = base64Alphabet[((src[0] & 0x03) << 4) | ((src[1] >> 4) & 0x0f)];
+        dst[2] = base64Alphabet[((src[1] & 0x0f) << 2)];
+      }
+      else {
+        dst[1] = base64Alphabet[(src[0] & 0x03) << 4];
+        dst[2] = '=';
+      }
+      dst[3] = '=';
+    }
+  }
+
+  // Returns the number of bytes written to dst, or -1 if src contains an
+  // invalid character or the length is not a multiple of 4.  Padding ends the
+  // data, so it must be in the last group.
+
+  int decodeBase64(const unsigned char *src, size_t len, unsigned char *dst)
+  {
+    unsigned char *const begin = dst;
+
+#if defined(TAGLIB_BASE64_SSE2) || defined(TAGLIB_BASE64_NEON)
+
+    // Blocks containing padding or invalid characters are left to the scalar
+    // loop below, which knows how to handle them.
+
+    while(len >= Base64BlockChars && decodeBase64Block(src, dst)) {
+      src += Base64BlockChars;
+      dst += Base64BlockBytes;
+      len -= Base64BlockChars;
+    }
+
+#endif
+
+    while(len >= 4) {
+      const unsigned char v0 = base64Values[src[0]];
+      const unsigned char v1 = base64Values[src[1]];
+      const unsigned char v2 = base64Values[src[2]];
+      const unsigned char v3 = base64Values[src[3]];
+
+      if(((v0 | v1 | v2 | v3) & 0x80) == 0) {
+        const unsigned int group = (v0 << 18) | (v1 << 12) | (v2 << 6) | v3;
+        dst[0] = static_cast<unsigned char>(group >> 16);
+        dst[1] = static_cast<unsigned char>(group >> 8);
+        dst[2] = static_cast<unsigned char>(group);
+        src += 4;
+        dst += 3;
+        len -= 4;
+        continue;
+      }
+
+      // Either an invalid character or padding, which marks the end of data.
+
+      if((v0 | v1) & 0x80)
+        return -1;
+
+      *dst++ = static_cast<unsigned char>((v0 << 2) | (v1 >> 4));
+
+      if(src[2] != '=') {
+        if(v2 & 0x80)
+          return -1;
+
+        *dst++ = static_cast<unsigned char>((v1 << 4) | (v2 >> 2));
+
+        if(src[3] != '=')
+          return -1;
+      }
+
+      len -= 4;
+      break;
+    }
+
+    if(len != 0)
+      return -1;
+
+    return static_cast<int>(dst - begin);
+  }
+}
+
 class ByteVector::ByteVectorPrivate
 {
 public:
@@ -900,120 +1223,36 @@ ByteVector ByteVector::toHex() const
   return encoded;
 }
 
-ByteVector ByteVector::fromBase64(const ByteVector & input)
+ByteVector ByteVector::fromBase64(const ByteVector &input)
 {
-  static const unsigned char base64[256] = {
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x3e,0x80,0x80,0x80,0x3f,
-    0x34,0x35,0x36,0x37,0x38,0x39,0x3a,0x3b,0x3c,0x3d,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,
-    0x0f,0x10,0x11,0x12,0x13,0x14,0x15,0x16,0x17,0x18,0x19,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x1a,0x1b,0x1c,0x1d,0x1e,0x1f,0x20,0x21,0x22,0x23,0x24,0x25,0x26,0x27,0x28,
-    0x29,0x2a,0x2b,0x2c,0x2d,0x2e,0x2f,0x30,0x31,0x32,0x33,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-    0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80
-  };
-
-  unsigned int len = input.size();
-
-  ByteVector output(len);
-
-  const unsigned char * src = (const unsigned char*) input.data();
-  unsigned char *       dst = (unsigned char*) output.data();
-
-  while(4 <= len) {
-
-    // Check invalid character
-    if(base64[src[0]] == 0x80)
-      break;
-
-    // Check invalid character
-    if(base64[src[1]] == 0x80)
-      break;
+  ByteVector output(input.size() / 4 * 3);
 
-    // Decode first byte
-    *dst++ = ((base64[src[0]] << 2) & 0xfc) | ((base64[src[1]] >> 4) & 0x03);
+  const int length = fromBase64(input.data(), input.size(), output.data());
+  if(length < 0)
+    return ByteVector();
 
-    if(src[2] != '=') {
-
-      // Check invalid character
-      if(base64[src[2]] == 0x80)
-        break;
-
-      // Decode second byte
-      *dst++ = ((base64[src[1]] & 0x0f) << 4) | ((base64[src[2]] >> 2) & 0x0f);
-
-      if(src[3] != '=') {
-
-        // Check invalid character
-        if(base64[src[3]] == 0x80)
-          break;
+  output.resize(static_cast<unsigned int>(length));
+  return output;
+}
 
-        // Decode third byte
-        *dst++ = ((base64[src[2]] & 0x03) << 6) | (base64[src[3]] & 0x3f);
-      }
-      else {
-        // assume end of data
-        len -= 4;
-        break;
-      }
-    }
-    else {
-      // assume end of data
-      len -= 4;
-      break;
-    }
-    src += 4;
-    len -= 4;
-  }
+int ByteVector::fromBase64(const char *input, unsigned int length, char *output)
+{
+  if(length == 0)
+    return 0;
 
-  // Only return output if we processed all bytes
-  if(len == 0) {
-    output.resize(static_cast<unsigned int>(dst - (unsigned char*) output.data()));
-    return output;
-  }
-  return ByteVector();
+  return decodeBase64(reinterpret_cast<const unsigned char *>(input), length,
+                      reinterpret_cast<unsigned char *>(output));
 }
 
 ByteVector ByteVector::toBase64() const
 {
-  static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  if(!isEmpty()) {
-    unsigned int len = size();
-    ByteVector output(4 * ((len - 1) / 3 + 1)); // note roundup
-
-    const char * src = data();
-    char * dst = output.data();
-    while(3 <= len) {
-      *dst++ = alphabet[(src[0] >> 2) & 0x3f];
-      *dst++ = alphabet[((src[0] & 0x03) << 4) | ((src[1] >> 4) & 0x0f)];
-      *dst++ = alphabet[((src[1] & 0x0f) << 2) | ((src[2] >> 6) & 0x03)];
-      *dst++ = alphabet[src[2] & 0x3f];
-      src += 3;
-      len -= 3;
-    }
-    if(len) {
-      *dst++ = alphabet[(src[0] >> 2) & 0x3f];
-      if(len>1) {
-        *dst++ = alphabet[((src[0] & 0x03) << 4) | ((src[1] >> 4) & 0x0f)];
-        *dst++ = alphabet[((src[1] & 0x0f) << 2)];
-      }
-      else {
-        *dst++ = alphabet[(src[0] & 0x03) << 4];
-        *dst++ = '=';
-      }
-    *dst++ = '=';
-    }
-    return output;
-  }
-  return ByteVector();
+  if(isEmpty())
+    return ByteVector();
+
+  ByteVector output(4 * ((size() - 1) / 3 + 1)); // note roundup
+  encodeBase64(reinterpret_cast<const unsigned char *>(data()), size(), output.data());
+
+  return output;
 }
 
 
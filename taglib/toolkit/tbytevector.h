@@ -612,6 +612,17 @@ namespace TagLib {
      */
     static ByteVector fromBase64(const ByteVector &);
 
+    /*!
+     * Decodes \a length bytes of base64 encoded \a input into \a output, which
+     * must provide room for at least (\a length / 4) * 3 bytes.  Returns the
+     * number of bytes written, or -1 if \a input is not valid base64.
+     *
+     * Since the data is decoded in groups of four characters, a long input can
+     * be decoded in consecutive chunks whose lengths are multiples of four,
+     * provided that only the last chunk contains padding.
+     */
+    static int fromBase64(const char *input, unsigned int length, char *output);
+
   protected:
     /*
      * If this ByteVector is being shared via implicit sharing, do a deep copy
@@ -78,6 +78,14 @@ ByteVector ByteVectorStream::readBlock(unsigned long length)
   return v;
 }
 
+ByteVector ByteVectorStream::readAt(long long offset, unsigned long length)
+{
+  if(length == 0 || offset < 0 || offset >= d->data.size())
+    return ByteVector();
+
+  return d->data.mid(static_cast<unsigned int>(offset), static_cast<unsigned int>(length));
+}
+
 void ByteVectorStream::writeBlock(const ByteVector &data)
 {
   unsigned int size = data.size();
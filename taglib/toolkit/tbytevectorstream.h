@@ -63,6 +63,12 @@ namespace TagLib {
      */
     ByteVector readBlock(unsigned long length);
 
+    /*!
+     * Reads a block of size \a length at \a offset, leaving the get pointer
+     * where it was.
+     */
+    ByteVector readAt(long long offset, unsigned long length);
+
     /*!
      * Attempts to write the block \a data at the current get pointer.  If the
      * file is currently only opened read only -- i.e. readOnly() returns true --
@@ -28,6 +28,7 @@
 #include "tstring.h"
 #include "tdebug.h"
 #include "tpropertymap.h"
+#include "tlist.h"
 
 #ifdef _WIN32
 # include <windows.h>
@@ -65,16 +66,115 @@
 #include "mp4file.h"
 #include "dsffile.h"
 #include "dsdifffile.h"
+#include "matroska/matroskafile.h"
+#include "avi/avifile.h"
+#include "mpeg_video/mpegvideofile.h"
+
+#include <typeinfo>
 
 using namespace TagLib;
 
+namespace
+{
+  // Until properties(), setProperties() and removeUnsupportedProperties()
+  // are virtual, File dispatches to the implementations of its subclasses
+  // through this table.  It is looked up by the dynamic type of the file,
+  // which costs a comparison of type_info per entry rather than a
+  // dynamic_cast, and falls back to dynamic_cast for classes derived from
+  // those in the table.
+
+  struct PropertyHandlers
+  {
+    const std::type_info *type;
+    bool (*isA)(const File *);
+    PropertyMap (*properties)(const File *);
+    PropertyMap (*setProperties)(File *, const PropertyMap &);
+    void (*removeUnsupportedProperties)(File *, const StringList &);
+  };
+
+  template <class T>
+  bool isA(const File *file)
+  {
+    return dynamic_cast<const T *>(file) != 0;
+  }
+
+  template <class T>
+  PropertyMap propertiesOf(const File *file)
+  {
+    return static_cast<const T *>(file)->properties();
+  }
+
+  template <class T>
+  PropertyMap setPropertiesOf(File *file, const PropertyMap &properties)
+  {
+    return static_cast<T *>(file)->setProperties(properties);
+  }
+
+  template <class T>
+  void removeUnsupportedPropertiesOf(File *file, const StringList &properties)
+  {
+    static_cast<T *>(file)->removeUnsupportedProperties(properties);
+  }
+
+#define PROPERTY_HANDLERS(T) \
+  { &typeid(T), isA<T>, propertiesOf<T>, setPropertiesOf<T>, removeUnsupportedPropertiesOf<T> }
+#define PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(T) \
+  { &typeid(T), isA<T>, propertiesOf<T>, setPropertiesOf<T>, 0 }
+
+  const PropertyHandlers propertyHandlers[] = {
+    PROPERTY_HANDLERS(MPEG::File),
+    PROPERTY_HANDLERS(FLAC::File),
+    PROPERTY_HANDLERS(MP4::File),
+    PROPERTY_HANDLERS(Ogg::Vorbis::File),
+    PROPERTY_HANDLERS(APE::File),
+    PROPERTY_HANDLERS(MPC::File),
+    PROPERTY_HANDLERS(RIFF::AIFF::File),
+    PROPERTY_HANDLERS(RIFF::WAV::File),
+    PROPERTY_HANDLERS(TrueAudio::File),
+    PROPERTY_HANDLERS(WavPack::File),
+    PROPERTY_HANDLERS(ASF::File),
+    PROPERTY_HANDLERS(DSF::File),
+    PROPERTY_HANDLERS(DSDIFF::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(Ogg::FLAC::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(Ogg::Speex::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(Ogg::Opus::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(IT::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(Mod::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(S3M::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(XM::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(Matroska::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(RIFF::AVI::File),
+    PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED(MPEG_VIDEO::File)
+  };
+
+#undef PROPERTY_HANDLERS
+#undef PROPERTY_HANDLERS_WITHOUT_UNSUPPORTED
+
+  const size_t propertyHandlersSize = sizeof(propertyHandlers) / sizeof(propertyHandlers[0]);
+
+  const PropertyHandlers *findPropertyHandlers(const File *file)
+  {
+    const std::type_info &type = typeid(*file);
+    for(size_t i = 0; i < propertyHandlersSize; ++i) {
+      if(*propertyHandlers[i].type == type)
+        return &propertyHandlers[i];
+    }
+    for(size_t i = 0; i < propertyHandlersSize; ++i) {
+      if(propertyHandlers[i].isA(file))
+        return &propertyHandlers[i];
+    }
+    return 0;
+  }
+}
+
 class File::FilePrivate
 {
 public:
   FilePrivate(IOStream *stream, bool owner) :
     stream(stream),
     streamOwner(owner),
-    valid(true) {}
+    valid(true),
+    readOptions(ReadEverything) {}
 
   ~FilePrivate()
   {
@@ -82,11 +182,35 @@ public:
       delete stream;
   }
 
+  // Tells the deferred readers that the file is about to change.
+
+  void readDeferred()
+  {
+    if(deferredReaders.isEmpty())
+      return;
+
+    const List<DeferredReader *> readers = deferredReaders;
+    deferredReaders.clear();
+
+    for(List<DeferredReader *>::ConstIterator it = readers.begin(); it != readers.end(); ++it)
+      (*it)->readDeferred();
+  }
+
   IOStream *stream;
   bool streamOwner;
   bool valid;
+  int readOptions;
+  List<DeferredReader *> deferredReaders;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// DeferredReader public members
+////////////////////////////////////////////////////////////////////////////////
+
+File::DeferredReader::~DeferredReader()
+{
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,129 +236,40 @@ FileName File::name() const
 }
 
 PropertyMap File::properties() const
+{
+  const PropertyHandlers *handlers = findPropertyHandlers(this);
+  if(handlers)
+    return handlers->properties(this);
+  return tag()->properties();
+}
+
+PictureHandleList File::pictureHandles() const
 {
   // ugly workaround until this method is virtual
-  if(dynamic_cast<const APE::File* >(this))
-    return dynamic_cast<const APE::File* >(this)->properties();
-  if(dynamic_cast<const FLAC::File* >(this))
-    return dynamic_cast<const FLAC::File* >(this)->properties();
-  if(dynamic_cast<const IT::File* >(this))
-    return dynamic_cast<const IT::File* >(this)->properties();
-  if(dynamic_cast<const Mod::File* >(this))
-    return dynamic_cast<const Mod::File* >(this)->properties();
-  if(dynamic_cast<const MPC::File* >(this))
-    return dynamic_cast<const MPC::File* >(this)->properties();
   if(dynamic_cast<const MPEG::File* >(this))
-    return dynamic_cast<const MPEG::File* >(this)->properties();
-  if(dynamic_cast<const Ogg::FLAC::File* >(this))
-    return dynamic_cast<const Ogg::FLAC::File* >(this)->properties();
-  if(dynamic_cast<const Ogg::Speex::File* >(this))
-    return dynamic_cast<const Ogg::Speex::File* >(this)->properties();
-  if(dynamic_cast<const Ogg::Opus::File* >(this))
-    return dynamic_cast<const Ogg::Opus::File* >(this)->properties();
-  if(dynamic_cast<const Ogg::Vorbis::File* >(this))
-    return dynamic_cast<const Ogg::Vorbis::File* >(this)->properties();
-  if(dynamic_cast<const RIFF::AIFF::File* >(this))
-    return dynamic_cast<const RIFF::AIFF::File* >(this)->properties();
-  if(dynamic_cast<const RIFF::WAV::File* >(this))
-    return dynamic_cast<const RIFF::WAV::File* >(this)->properties();
-  if(dynamic_cast<const S3M::File* >(this))
-    return dynamic_cast<const S3M::File* >(this)->properties();
-  if(dynamic_cast<const TrueAudio::File* >(this))
-    return dynamic_cast<const TrueAudio::File* >(this)->properties();
-  if(dynamic_cast<const WavPack::File* >(this))
-    return dynamic_cast<const WavPack::File* >(this)->properties();
-  if(dynamic_cast<const XM::File* >(this))
-    return dynamic_cast<const XM::File* >(this)->properties();
+    return dynamic_cast<const MPEG::File* >(this)->pictureHandles();
+  if(dynamic_cast<const FLAC::File* >(this))
+    return dynamic_cast<const FLAC::File* >(this)->pictureHandles();
   if(dynamic_cast<const MP4::File* >(this))
-    return dynamic_cast<const MP4::File* >(this)->properties();
-  if(dynamic_cast<const ASF::File* >(this))
-    return dynamic_cast<const ASF::File* >(this)->properties();
-  if(dynamic_cast<const DSF::File* >(this))
-    return dynamic_cast<const DSF::File* >(this)->properties();
-  if(dynamic_cast<const DSDIFF::File* >(this))
-    return dynamic_cast<const DSDIFF::File* >(this)->properties();
-  return tag()->properties();
+    return dynamic_cast<const MP4::File* >(this)->pictureHandles();
+  return PictureHandleList();
 }
 
 void File::removeUnsupportedProperties(const StringList &properties)
 {
-  // here we only consider those formats that could possibly contain
-  // unsupported properties
-  if(dynamic_cast<APE::File* >(this))
-    dynamic_cast<APE::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<FLAC::File* >(this))
-    dynamic_cast<FLAC::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<MPC::File* >(this))
-    dynamic_cast<MPC::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<MPEG::File* >(this))
-    dynamic_cast<MPEG::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<Ogg::Vorbis::File* >(this))
-    dynamic_cast<Ogg::Vorbis::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<RIFF::AIFF::File* >(this))
-    dynamic_cast<RIFF::AIFF::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<RIFF::WAV::File* >(this))
-    dynamic_cast<RIFF::WAV::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<TrueAudio::File* >(this))
-    dynamic_cast<TrueAudio::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<WavPack::File* >(this))
-    dynamic_cast<WavPack::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<MP4::File* >(this))
-    dynamic_cast<MP4::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<ASF::File* >(this))
-    dynamic_cast<ASF::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<DSF::File* >(this))
-    dynamic_cast<DSF::File* >(this)->removeUnsupportedProperties(properties);
-  else if(dynamic_cast<DSDIFF::File* >(this))
-    dynamic_cast<DSDIFF::File* >(this)->removeUnsupportedProperties(properties);
-  else
+  const PropertyHandlers *handlers = findPropertyHandlers(this);
+  if(handlers && handlers->removeUnsupportedProperties)
+    handlers->removeUnsupportedProperties(this, properties);
+  else if(tag())
     tag()->removeUnsupportedProperties(properties);
 }
 
 PropertyMap File::setProperties(const PropertyMap &properties)
 {
-  if(dynamic_cast<APE::File* >(this))
-    return dynamic_cast<APE::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<FLAC::File* >(this))
-    return dynamic_cast<FLAC::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<IT::File* >(this))
-    return dynamic_cast<IT::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<Mod::File* >(this))
-    return dynamic_cast<Mod::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<MPC::File* >(this))
-    return dynamic_cast<MPC::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<MPEG::File* >(this))
-    return dynamic_cast<MPEG::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<Ogg::FLAC::File* >(this))
-    return dynamic_cast<Ogg::FLAC::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<Ogg::Speex::File* >(this))
-    return dynamic_cast<Ogg::Speex::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<Ogg::Opus::File* >(this))
-    return dynamic_cast<Ogg::Opus::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<Ogg::Vorbis::File* >(this))
-    return dynamic_cast<Ogg::Vorbis::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<RIFF::AIFF::File* >(this))
-    return dynamic_cast<RIFF::AIFF::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<RIFF::WAV::File* >(this))
-    return dynamic_cast<RIFF::WAV::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<S3M::File* >(this))
-    return dynamic_cast<S3M::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<TrueAudio::File* >(this))
-    return dynamic_cast<TrueAudio::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<WavPack::File* >(this))
-    return dynamic_cast<WavPack::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<XM::File* >(this))
-    return dynamic_cast<XM::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<MP4::File* >(this))
-    return dynamic_cast<MP4::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<ASF::File* >(this))
-    return dynamic_cast<ASF::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<DSF::File* >(this))
-    return dynamic_cast<DSF::File* >(this)->setProperties(properties);
-  else if(dynamic_cast<DSDIFF::File* >(this))
-    return dynamic_cast<DSDIFF::File* >(this)->setProperties(properties);
-  else
-    return tag()->setProperties(properties);
+  const PropertyHandlers *handlers = findPropertyHandlers(this);
+  if(handlers)
+    return handlers->setProperties(this, properties);
+  return tag()->setProperties(properties);
 }
 
 ByteVector File::readBlock(unsigned long length)
@@ -242,8 +277,14 @@ ByteVector File::readBlock(unsigned long length)
   return d->stream->readBlock(length);
 }
 
+ByteVector File::readAt(long long offset, unsigned long length)
+{
+  return d->stream->readAt(offset, length);
+}
+
 void File::writeBlock(const ByteVector &data)
 {
+  d->readDeferred();
   d->stream->writeBlock(data);
 }
 
@@ -419,17 +460,25 @@ long long File::rfind(const ByteVector &pattern, long long fromOffset, const Byt
 
 void File::insert(const ByteVector &data, unsigned long start, unsigned long replace)
 {
+  d->readDeferred();
   d->stream->insert(data, start, replace);
 }
 
 void File::removeBlock(unsigned long start, unsigned long length)
 {
+  d->readDeferred();
   d->stream->removeBlock(start, length);
 }
 
 bool File::readOnly() const
 {
-  return d->stream->readOnly();
+  const int allMetadata = ReadTags | ReadPictures | ReadChapters;
+  return d->stream->readOnly() || (d->readOptions & allMetadata) != allMetadata;
+}
+
+int File::readOptions() const
+{
+  return d->readOptions;
 }
 
 bool File::isOpen() const
@@ -449,6 +498,7 @@ void File::seek(long long offset, Position p)
 
 void File::truncate(long length)
 {
+  d->readDeferred();
   d->stream->truncate(length);
 }
 
@@ -497,6 +547,19 @@ bool File::isWritable(const char *file)
 
 }
 
+void File::addDeferredReader(DeferredReader *reader)
+{
+  if(d->deferredReaders.find(reader) == d->deferredReaders.end())
+    d->deferredReaders.append(reader);
+}
+
+void File::removeDeferredReader(DeferredReader *reader)
+{
+  const List<DeferredReader *>::Iterator it = d->deferredReaders.find(reader);
+  if(it != d->deferredReaders.end())
+    d->deferredReaders.erase(it);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // protected members
 ////////////////////////////////////////////////////////////////////////////////
@@ -511,3 +574,8 @@ void File::setValid(bool valid)
   d->valid = valid;
 }
 
+void File::setReadOptions(int options)
+{
+  d->readOptions = options;
+}
+
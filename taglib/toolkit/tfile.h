@@ -31,6 +31,7 @@
 #include "tag.h"
 #include "tbytevector.h"
 #include "tiostream.h"
+#include "tpicturehandle.h"
 
 namespace TagLib {
 
@@ -62,6 +63,64 @@ namespace TagLib {
       End
     };
 
+    /*!
+     * The parts of a file that are read when it is opened.  These can be
+     * combined with a bitwise or and passed to the constructors of the file
+     * types which take \a readOptions, so that files can be scanned without
+     * reading (or even seeking over) the data which is not needed.
+     *
+     * A file which is opened without ReadTags, ReadPictures and ReadChapters
+     * does not know all of its metadata, so it is treated as read only.
+     *
+     * \see readOptions()
+     */
+    enum ReadOptions {
+      //! Read nothing but what is needed to recognise the file
+      ReadNothing         = 0x0000,
+      //! Read the fields exposed by Tag: title, artist, album, comment, genre,
+      //! year and track
+      ReadBasicTags       = 0x0001,
+      //! Read the other text and data fields of the tags
+      ReadExtendedTags    = 0x0002,
+      //! Read all the fields of the tags, except pictures and chapters
+      ReadTags            = 0x0003,
+      //! Read embedded pictures
+      ReadPictures        = 0x0004,
+      //! Read chapters
+      ReadChapters        = 0x0008,
+      //! Read the audio properties
+      ReadAudioProperties = 0x0010,
+      //! Read everything, which is what the other constructors do
+      ReadEverything      = 0x001F,
+      //! Instead of reading embedded pictures, only locate them so that
+      //! pictureHandles() can read their data when it is needed
+      ReadPictureHandles  = 0x0020,
+      //! Only index the large frames of ID3v2 tags, such as pictures and
+      //! chapters, and parse them when they are first accessed
+      ReadFramesOnDemand  = 0x0040
+    };
+
+    //! Something which reads parts of the file when they are first needed
+
+    /*!
+     * A deferred reader, such as an ID3v2 tag with frames which are parsed on
+     * demand, keeps offsets into the file rather than the data.  It is told
+     * before the file is first changed, so that it can read what it still
+     * needs while the data is where it was.
+     *
+     * \see addDeferredReader()
+     */
+    class TAGLIB_EXPORT DeferredReader
+    {
+    public:
+      virtual ~DeferredReader();
+
+      /*!
+       * Reads everything which is still to be read from the file.
+       */
+      virtual void readDeferred() = 0;
+    };
+
     /*!
      * Destroys this File instance.
      */
@@ -116,6 +175,18 @@ namespace TagLib {
      */
     PropertyMap setProperties(const PropertyMap &properties);
 
+    /*!
+     * Returns handles to the pictures embedded in the file.  If the file was
+     * opened with ReadPictureHandles rather than ReadPictures, the picture data
+     * has not been read and is only read by PictureHandle::data().
+     *
+     * This is supported for the ID3v2 tags of MPEG files, FLAC picture blocks
+     * and MP4 cover art.  Other files return an empty list.
+     *
+     * BIC: Will be made virtual in future releases.
+     */
+    PictureHandleList pictureHandles() const;
+
     /*!
      * Returns a pointer to this file's audio properties.  This should be
      * reimplemented in the concrete subclasses.  If no audio properties were
@@ -140,6 +211,15 @@ namespace TagLib {
      */
     ByteVector readBlock(unsigned long length);
 
+    /*!
+     * Reads a block of size \a length at \a offset.  This is a single read
+     * for the streams which support positional reads, which leave the get
+     * pointer where it was; with others it is moved.
+     *
+     * \see IOStream::readAt()
+     */
+    ByteVector readAt(long long offset, unsigned long length);
+
     /*!
      * Attempts to write the block \a data at the current get pointer.  If the
      * file is currently only opened read only -- i.e. readOnly() returns true --
@@ -203,9 +283,19 @@ namespace TagLib {
 
     /*!
      * Returns true if the file is read only (or if the file can not be opened).
+     * This is also true if the file was opened with read options which
+     * leave out part of its metadata, since saving it would lose that part.
+     *
+     * \see ReadOptions
      */
     bool readOnly() const;
 
+    /*!
+     * Returns the parts of the file that were read when it was opened, as a
+     * combination of ReadOptions.
+     */
+    int readOptions() const;
+
     /*!
      * Since the file can currently only be opened as an argument to the
      * constructor (sort-of by design), this returns if that open succeeded.
@@ -255,6 +345,21 @@ namespace TagLib {
      */
     static bool isWritable(const char *name);
 
+    /*!
+     * Registers \a reader, which is told once, before the file is first
+     * changed by writeBlock(), insert(), removeBlock() or truncate(), and then
+     * forgotten.  The file does not take ownership of the reader.
+     *
+     * \see removeDeferredReader()
+     */
+    void addDeferredReader(DeferredReader *reader);
+
+    /*!
+     * Removes \a reader, which has to be done if it is deleted or has nothing
+     * left to read before the file is changed.
+     */
+    void removeDeferredReader(DeferredReader *reader);
+
   protected:
     /*!
      * Construct a File object and opens the \a file.  \a file should be a
@@ -283,6 +388,14 @@ namespace TagLib {
      */
     void setValid(bool valid);
 
+    /*!
+     * Sets the parts of the file to be read.  This has to be called by the
+     * constructors of subclasses before they read the file.
+     *
+     * \see ReadOptions
+     */
+    void setReadOptions(int options);
+
     /*!
      * Truncates the file to a \a length.
      */
@@ -301,6 +414,32 @@ namespace TagLib {
     FilePrivate *d;
   };
 
+  /*!
+   * Combines the read options \a a and \a b.  The result keeps the type
+   * File::ReadOptions, so that it binds to the constructors which take read
+   * options rather than to those which take a bool.
+   */
+  inline File::ReadOptions operator|(File::ReadOptions a, File::ReadOptions b)
+  {
+    return static_cast<File::ReadOptions>(static_cast<int>(a) | static_cast<int>(b));
+  }
+
+  /*!
+   * Returns the read options which are set in both \a a and \a b.
+   */
+  inline File::ReadOptions operator&(File::ReadOptions a, File::ReadOptions b)
+  {
+    return static_cast<File::ReadOptions>(static_cast<int>(a) & static_cast<int>(b));
+  }
+
+  /*!
+   * Returns all the read options which are not set in \a a.
+   */
+  inline File::ReadOptions operator~(File::ReadOptions a)
+  {
+    return static_cast<File::ReadOptions>(~static_cast<int>(a) & 0x007F);
+  }
+
 }
 
 #endif
@@ -23,6 +23,8 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include "tfilestream.h"
 #include "tstring.h"
 #include "tdebug.h"
@@ -82,6 +84,32 @@ namespace
       return 0;
   }
 
+  size_t readFileAt(FileHandle file, ByteVector &buffer, long long offset)
+  {
+    // A synchronous handle moves its file pointer even with an offset given,
+    // so it is put back where it was after the read.
+
+    LARGE_INTEGER zero = {};
+    LARGE_INTEGER position;
+    if(!SetFilePointerEx(file, zero, &position, FILE_CURRENT))
+      return 0;
+
+    OVERLAPPED overlapped = {};
+    overlapped.Offset     = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD length;
+    const BOOL result = ReadFile(file, buffer.data(), static_cast<DWORD>(buffer.size()),
+                                 &length, &overlapped);
+
+    SetFilePointerEx(file, position, NULL, FILE_BEGIN);
+
+    if(result)
+      return static_cast<size_t>(length);
+    else
+      return 0;
+  }
+
   size_t writeFile(FileHandle file, const ByteVector &buffer)
   {
     DWORD length;
@@ -133,6 +161,11 @@ namespace
     return read(file, buffer.data(), buffer.size());
   }
 
+  ssize_t readFileAt(FileHandle file, ByteVector &buffer, long long offset)
+  {
+    return pread(file, buffer.data(), buffer.size(), offset);
+  }
+
   ssize_t writeFile(FileHandle file, const ByteVector &buffer)
   {
     return write(file, buffer.data(), buffer.size());
@@ -233,6 +266,32 @@ ByteVector FileStream::readBlock(unsigned long length)
   return buffer;
 }
 
+ByteVector FileStream::readAt(long long offset, unsigned long length)
+{
+  if(!isOpen()) {
+    debug("FileStream::readAt() -- invalid file.");
+    return ByteVector();
+  }
+
+  if(length == 0 || offset < 0)
+    return ByteVector();
+
+  if(length > bufferSize()) {
+    const long long available = FileStream::length() - offset;
+    if(available <= 0)
+      return ByteVector();
+    if(static_cast<long long>(length) > available)
+      length = static_cast<unsigned long>(available);
+  }
+
+  ByteVector buffer(static_cast<unsigned int>(length));
+
+  const long long count = readFileAt(d->file, buffer, offset);
+  buffer.resize(static_cast<unsigned int>(std::max<long long>(count, 0)));
+
+  return buffer;
+}
+
 void FileStream::writeBlock(const ByteVector &data)
 {
   if(!isOpen()) {
@@ -476,6 +535,13 @@ long long FileStream::length()
 
 #else
 
+  // The size of a regular file is known without moving the file offset,
+  // which readAt() may be relying on from other threads.
+
+  struct stat st;
+  if(fstat(d->file, &st) == 0 && S_ISREG(st.st_mode))
+    return st.st_size;
+
   const long long curpos = tell();
 
   seek(0, End);
@@ -74,6 +74,18 @@ namespace TagLib {
      */
     ByteVector readBlock(unsigned long length);
 
+    /*!
+     * Reads a block of size \a length at \a offset with a single positional
+     * read, leaving the get pointer where it was.
+     *
+     * \note On Windows the read moves the file pointer, which is put back
+     * afterwards.  The data is right when several threads read at once, but
+     * the get pointer may then be left at the end of one of their reads.
+     * The same goes for reads of more than bufferSize() bytes from a stream
+     * which is not a regular file, as length() has to seek to its end.
+     */
+    ByteVector readAt(long long offset, unsigned long length);
+
     /*!
      * Attempts to write the block \a data at the current get pointer.  If the
      * file is currently only opened read only -- i.e. readOnly() returns true --
@@ -23,12 +23,24 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
 #ifdef _WIN32
 # include <windows.h>
 # include <tstring.h>
 #endif
 
+#include <typeinfo>
+
 #include "tiostream.h"
+#include "tfilestream.h"
+#include "tbytevectorstream.h"
+
+#ifdef TAGLIB_WITH_PREFETCH
+# include "tprefetchedfilestream.h"
+#endif
 
 using namespace TagLib;
 
@@ -112,3 +124,21 @@ void IOStream::clear()
 {
 }
 
+ByteVector IOStream::readAt(long long offset, unsigned long length)
+{
+  // Only the exact types are known to read without the get pointer; a
+  // subclass may have overridden readBlock().
+
+  const std::type_info &type = typeid(*this);
+  if(type == typeid(FileStream))
+    return static_cast<FileStream *>(this)->readAt(offset, length);
+  if(type == typeid(ByteVectorStream))
+    return static_cast<ByteVectorStream *>(this)->readAt(offset, length);
+#ifdef TAGLIB_WITH_PREFETCH
+  if(type == typeid(PrefetchedFileStream))
+    return static_cast<PrefetchedFileStream *>(this)->readAt(offset, length);
+#endif
+
+  seek(offset);
+  return readBlock(length);
+}
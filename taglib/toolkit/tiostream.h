@@ -91,6 +91,22 @@ namespace TagLib {
      */
     virtual ByteVector readBlock(unsigned long length) = 0;
 
+    /*!
+     * Reads a block of size \a length at \a offset, without using the current
+     * get pointer.
+     *
+     * On POSIX systems FileStream reads with pread(), and ByteVectorStream
+     * copies from memory; both leave the get pointer where it was, so several
+     * threads may read one of them at the same time as long as none of them
+     * writes or seeks.  On Windows FileStream restores the get pointer after
+     * each read, which only keeps it in place for one thread at a time.
+     * Other streams seek to \a offset and use readBlock(), which moves the
+     * get pointer.
+     *
+     * BIC: Will be made virtual in future releases.
+     */
+    ByteVector readAt(long long offset, unsigned long length);
+
     /*!
      * Attempts to write the block \a data at the current get pointer.  If the
      * file is currently only opened read only -- i.e. readOnly() returns true --
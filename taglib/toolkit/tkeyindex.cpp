@@ -0,0 +1,128 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <cstring>
+
+#include "tkeyindex.h"
+
+using namespace TagLib;
+using namespace Utils;
+
+namespace
+{
+  inline unsigned int code(char c)
+  {
+    return static_cast<unsigned char>(c);
+  }
+
+  inline unsigned int code(wchar_t c)
+  {
+    return static_cast<unsigned int>(c);
+  }
+
+  inline unsigned int foldCase(unsigned int c)
+  {
+    return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+  }
+
+  // FNV-1a over case-folded characters.
+
+  const unsigned int hashBasis = 2166136261U;
+
+  inline unsigned int hashStep(unsigned int hash, unsigned int c)
+  {
+    return (hash ^ foldCase(c)) * 16777619U;
+  }
+
+  template <class Iterator>
+  unsigned int hashKey(Iterator begin, Iterator end)
+  {
+    unsigned int hash = hashBasis;
+    for(Iterator it = begin; it != end; ++it)
+      hash = hashStep(hash, code(*it));
+    return hash;
+  }
+}
+
+KeyIndex::KeyIndex(const char *const (*table)[2], size_t size, size_t column) :
+  m_table(table),
+  m_column(column),
+  m_hashes(size)
+{
+  // Keep the load factor at or below one half so that probe sequences
+  // stay short.
+
+  size_t slotCount = 8;
+  while(slotCount < size * 2)
+    slotCount *= 2;
+
+  m_slots.assign(slotCount, -1);
+
+  for(size_t row = 0; row < size; ++row) {
+    const char *key = m_table[row][m_column];
+    m_hashes[row] = hashKey(key, key + ::strlen(key));
+
+    size_t slot = m_hashes[row] & (slotCount - 1);
+    while(m_slots[slot] != -1)
+      slot = (slot + 1) & (slotCount - 1);
+    m_slots[slot] = static_cast<int>(row);
+  }
+}
+
+int KeyIndex::find(const String &key) const
+{
+  const unsigned int hash = hashKey(key.begin(), key.end());
+  const size_t mask = m_slots.size() - 1;
+
+  for(size_t slot = hash & mask; m_slots[slot] != -1; slot = (slot + 1) & mask) {
+    const int row = m_slots[slot];
+    if(m_hashes[row] != hash)
+      continue;
+
+    const char *s = m_table[row][m_column];
+    String::ConstIterator it = key.begin();
+    for(; it != key.end() && *s != '\0'; ++it, ++s) {
+      if(foldCase(code(*it)) != foldCase(code(*s)))
+        break;
+    }
+    if(it == key.end() && *s == '\0')
+      return row;
+  }
+
+  return -1;
+}
+
+int KeyIndex::find(const ByteVector &key) const
+{
+  const unsigned int hash = hashKey(key.begin(), key.end());
+  const size_t mask = m_slots.size() - 1;
+
+  for(size_t slot = hash & mask; m_slots[slot] != -1; slot = (slot + 1) & mask) {
+    const int row = m_slots[slot];
+    if(m_hashes[row] == hash && key == m_table[row][m_column])
+      return row;
+  }
+
+  return -1;
+}
@@ -0,0 +1,79 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_TKEYINDEX_H
+#define TAGLIB_TKEYINDEX_H
+
+#include <vector>
+
+#include <tbytevector.h>
+#include <tstring.h>
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  namespace Utils {
+
+    /*!
+     * An open addressing hash index over one column of a static translation
+     * table such as { { "TIT2", "TITLE" }, ... }.  The hashes of the table
+     * keys are computed once, case-folded to upper case ASCII, so that a
+     * String can be looked up case-insensitively without building an upper
+     * case copy of it.
+     *
+     * The index is immutable once constructed and may be shared between
+     * threads.
+     */
+    class KeyIndex
+    {
+    public:
+      KeyIndex(const char *const (*table)[2], size_t size, size_t column);
+
+      /*!
+       * Returns the row of the table whose key equals \a key ignoring ASCII
+       * case, or -1 if there is none.
+       */
+      int find(const String &key) const;
+
+      /*!
+       * Returns the row of the table whose key equals \a key byte for byte,
+       * or -1 if there is none.
+       */
+      int find(const ByteVector &key) const;
+
+    private:
+      const char *const (*m_table)[2];
+      size_t m_column;
+      std::vector<unsigned int> m_hashes;
+      std::vector<int> m_slots;
+    };
+  }
+}
+
+#endif
+
+#endif
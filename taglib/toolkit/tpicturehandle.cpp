@@ -0,0 +1,158 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tdebug.h"
+#include "tfile.h"
+#include "trefcounter.h"
+#include "tpicturehandle.h"
+
+using namespace TagLib;
+
+class PictureHandle::PictureHandlePrivate : public RefCounter
+{
+public:
+  PictureHandlePrivate() :
+    RefCounter(),
+    file(0),
+    offset(-1),
+    size(0),
+    type(0) {}
+
+  File *file;
+  long long offset;
+  unsigned int size;
+  ByteVector data;
+  String mimeType;
+  int type;
+  String description;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+PictureHandle::PictureHandle() :
+  d(new PictureHandlePrivate())
+{
+}
+
+PictureHandle::PictureHandle(File *file, long long offset, unsigned int size,
+                             const String &mimeType, int type, const String &description) :
+  d(new PictureHandlePrivate())
+{
+  d->file = file;
+  d->offset = offset;
+  d->size = size;
+  d->mimeType = mimeType;
+  d->type = type;
+  d->description = description;
+}
+
+PictureHandle::PictureHandle(const ByteVector &data,
+                             const String &mimeType, int type, const String &description) :
+  d(new PictureHandlePrivate())
+{
+  d->size = data.size();
+  d->data = data;
+  d->mimeType = mimeType;
+  d->type = type;
+  d->description = description;
+}
+
+PictureHandle::PictureHandle(const PictureHandle &handle) :
+  d(handle.d)
+{
+  d->ref();
+}
+
+PictureHandle::~PictureHandle()
+{
+  if(d->deref())
+    delete d;
+}
+
+PictureHandle &PictureHandle::operator=(const PictureHandle &handle)
+{
+  PictureHandle(handle).swap(*this);
+  return *this;
+}
+
+void PictureHandle::swap(PictureHandle &handle)
+{
+  using std::swap;
+
+  swap(d, handle.d);
+}
+
+bool PictureHandle::isNull() const
+{
+  return !d->file && d->data.isEmpty();
+}
+
+String PictureHandle::mimeType() const
+{
+  return d->mimeType;
+}
+
+int PictureHandle::type() const
+{
+  return d->type;
+}
+
+String PictureHandle::description() const
+{
+  return d->description;
+}
+
+long long PictureHandle::offset() const
+{
+  return d->offset;
+}
+
+unsigned int PictureHandle::size() const
+{
+  return d->size;
+}
+
+ByteVector PictureHandle::data() const
+{
+  if(!d->file)
+    return d->data;
+
+  if(!d->file->isOpen()) {
+    debug("PictureHandle::data() -- The file is not open.");
+    return ByteVector();
+  }
+
+  const long long position = d->file->tell();
+  d->file->seek(d->offset);
+  const ByteVector data = d->file->readBlock(d->size);
+  d->file->seek(position);
+
+  if(data.size() != d->size)
+    debug("PictureHandle::data() -- Could not read the picture data.");
+
+  return data;
+}
@@ -0,0 +1,149 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_PICTUREHANDLE_H
+#define TAGLIB_PICTUREHANDLE_H
+
+#include "taglib_export.h"
+#include "tbytevector.h"
+#include "tstring.h"
+#include "tlist.h"
+
+namespace TagLib {
+
+  class File;
+
+  //! A picture of a file whose data is read only when it is asked for
+
+  /*!
+   * This describes a picture embedded in the metadata of a file, such as an
+   * ID3v2 APIC frame, a FLAC picture block or MP4 cover art, by its MIME
+   * type, picture type and description and the position of its data in the
+   * file.  The data itself is only read by data(), so that a file with large
+   * pictures can be kept open at little cost by an application which does not
+   * display them.
+   *
+   * Handles to pictures which were read along with the tag hold their data
+   * instead, which is then shared with the tag rather than copied.
+   *
+   * \note A handle to data in the file refers to the File it was taken from,
+   * and data() may only be called as long as that File exists.  It reads the
+   * data as it is in the file, so the handle is outdated once the file has
+   * been saved.
+   *
+   * \see File::ReadPictureHandles
+   */
+
+  class TAGLIB_EXPORT PictureHandle
+  {
+  public:
+    /*!
+     * Constructs a null handle.
+     */
+    PictureHandle();
+
+    /*!
+     * Constructs a handle to the \a size bytes of picture data at \a offset
+     * of \a file.
+     */
+    PictureHandle(File *file, long long offset, unsigned int size,
+                  const String &mimeType, int type, const String &description);
+
+    /*!
+     * Constructs a handle holding the picture data \a data.
+     */
+    PictureHandle(const ByteVector &data,
+                  const String &mimeType, int type, const String &description);
+
+    /*!
+     * Makes a copy of \a handle.
+     */
+    PictureHandle(const PictureHandle &handle);
+
+    /*!
+     * Destroys this handle.
+     */
+    ~PictureHandle();
+
+    /*!
+     * Copies the contents of \a handle into this handle.
+     */
+    PictureHandle &operator=(const PictureHandle &handle);
+
+    /*!
+     * Exchanges the content of this handle by the content of \a handle.
+     */
+    void swap(PictureHandle &handle);
+
+    /*!
+     * Returns true if the handle does not refer to a picture.
+     */
+    bool isNull() const;
+
+    /*!
+     * Returns the MIME type of the picture, which is empty if the format does
+     * not give one and the image format is unknown.
+     */
+    String mimeType() const;
+
+    /*!
+     * Returns the type of the picture, as enumerated by
+     * ID3v2::AttachedPictureFrame::Type and FLAC::Picture::Type.  MP4 cover
+     * art has no type and is reported as a front cover.
+     */
+    int type() const;
+
+    /*!
+     * Returns the description of the picture.
+     */
+    String description() const;
+
+    /*!
+     * Returns the offset of the picture data in the file, or -1 if the handle
+     * holds the data.
+     */
+    long long offset() const;
+
+    /*!
+     * Returns the size of the picture data in bytes.
+     */
+    unsigned int size() const;
+
+    /*!
+     * Returns the picture data, reading it from the file if the handle does
+     * not hold it.  The data is not kept by the handle.
+     */
+    ByteVector data() const;
+
+  private:
+    class PictureHandlePrivate;
+    PictureHandlePrivate *d;
+  };
+
+  typedef List<PictureHandle> PictureHandleList;
+
+}
+
+#endif
@@ -0,0 +1,778 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAVE_LINUX_IO_URING
+# include <linux/io_uring.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+#endif
+
+#include "tdebug.h"
+#include "tstring.h"
+#include "tprefetchedfilestream.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // The file being prefetched and what has been read of it.
+
+  struct Prefetch
+  {
+    Prefetch() :
+      fd(-1),
+      length(-1) {}
+
+    std::string name;
+    int fd;
+    long long length;
+    ByteVector head;
+    ByteVector tail;
+  };
+
+  // Reads the rest of data, of which the first done bytes have been read,
+  // from offset in the file.  The data is cut short at the end of the file or
+  // at an error.
+
+  void readRemaining(int fd, ByteVector &data, long long offset, size_t done = 0)
+  {
+    while(done < data.size()) {
+      const ssize_t count = ::pread(fd, data.data() + done, data.size() - done,
+                                    static_cast<off_t>(offset + done));
+      if(count < 0 && errno == EINTR)
+        continue;
+      if(count <= 0)
+        break;
+      done += count;
+    }
+
+    data.resize(static_cast<unsigned int>(done));
+  }
+
+  // Opens the file and makes room for its head and tail, which are read
+  // afterwards.  Only regular files can be read at an offset.
+
+  void openFile(Prefetch &file, unsigned int headSize, unsigned int tailSize)
+  {
+    file.fd = ::open(file.name.c_str(), O_RDONLY | O_CLOEXEC);
+    if(file.fd < 0) {
+      debug("FilePrefetcher::open() -- Could not open file '" + String(file.name) + "'");
+      return;
+    }
+
+    struct stat st;
+    if(::fstat(file.fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      debug("FilePrefetcher::open() -- '" + String(file.name) + "' is not a regular file.");
+      ::close(file.fd);
+      file.fd = -1;
+      return;
+    }
+
+    file.length = st.st_size;
+
+    const long long headLength = std::min<long long>(headSize, file.length);
+    const long long tailLength = std::min<long long>(tailSize, file.length - headLength);
+    file.head.resize(static_cast<unsigned int>(headLength));
+    file.tail.resize(static_cast<unsigned int>(tailLength));
+  }
+
+  void closeFile(Prefetch &file)
+  {
+    if(file.fd >= 0) {
+      ::close(file.fd);
+      file.fd = -1;
+    }
+  }
+
+  long long tailOffset(const Prefetch &file)
+  {
+    return file.length - file.tail.size();
+  }
+
+  // What the threads of a ThreadPool prefetch share.
+
+  struct PoolState
+  {
+    PoolState(std::vector<Prefetch> &prefetches, unsigned int head, unsigned int tail) :
+      files(prefetches),
+      headSize(head),
+      tailSize(tail),
+      next(0) {}
+
+    std::vector<Prefetch> &files;
+    const unsigned int headSize;
+    const unsigned int tailSize;
+    std::atomic<size_t> next;
+  };
+
+  void poolWork(PoolState *state)
+  {
+    size_t i;
+    while((i = state->next++) < state->files.size()) {
+      Prefetch &file = state->files[i];
+      openFile(file, state->headSize, state->tailSize);
+      if(file.fd >= 0) {
+        readRemaining(file.fd, file.head, 0);
+        readRemaining(file.fd, file.tail, tailOffset(file));
+        closeFile(file);
+      }
+    }
+  }
+
+  void prefetchWithThreads(std::vector<Prefetch> &files, size_t first,
+                           unsigned int headSize, unsigned int tailSize,
+                           unsigned int queueDepth)
+  {
+    PoolState state(files, headSize, tailSize);
+    state.next = first;
+
+    const unsigned int threads = static_cast<unsigned int>(
+      std::min<size_t>(std::max(queueDepth, 1U), files.size() - first));
+
+    std::vector<std::thread> pool;
+    for(unsigned int i = 1; i < threads; ++i)
+      pool.push_back(std::thread(poolWork, &state));
+
+    poolWork(&state);
+
+    for(std::vector<std::thread>::iterator it = pool.begin(); it != pool.end(); ++it)
+      it->join();
+  }
+
+#ifdef HAVE_LINUX_IO_URING
+
+  // A minimal io_uring, mapped with the raw system calls so that liburing is
+  // not needed.  This thread is the only one to submit and to reap, so the
+  // only synchronization needed is with the kernel.
+
+  class Ring
+  {
+  public:
+    Ring() :
+      fd(-1),
+      sqRing(MAP_FAILED),
+      cqRing(MAP_FAILED),
+      sqes(static_cast<io_uring_sqe *>(MAP_FAILED)),
+      sqRingSize(0),
+      cqRingSize(0),
+      sqesSize(0),
+      sqEntries(0),
+      sqHead(0),
+      sqTail(0),
+      sqMask(0),
+      sqArray(0),
+      cqHead(0),
+      cqTail(0),
+      cqMask(0),
+      cqes(0),
+      pending(0) {}
+
+    ~Ring()
+    {
+      if(sqes != MAP_FAILED)
+        ::munmap(sqes, sqesSize);
+      if(cqRing != MAP_FAILED && cqRing != sqRing)
+        ::munmap(cqRing, cqRingSize);
+      if(sqRing != MAP_FAILED)
+        ::munmap(sqRing, sqRingSize);
+      if(fd >= 0)
+        ::close(fd);
+    }
+
+    bool setup(unsigned int entries)
+    {
+      io_uring_params params;
+      ::memset(&params, 0, sizeof(params));
+
+      fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+      if(fd < 0)
+        return false;
+
+      sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+      cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+      const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+      if(singleMap)
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+      sqRing = ::mmap(0, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQ_RING);
+      if(sqRing == MAP_FAILED)
+        return false;
+
+      if(singleMap)
+        cqRing = sqRing;
+      else {
+        cqRing = ::mmap(0, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd, IORING_OFF_CQ_RING);
+        if(cqRing == MAP_FAILED)
+          return false;
+      }
+
+      sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+      sqes = static_cast<io_uring_sqe *>(
+        ::mmap(0, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+               fd, IORING_OFF_SQES));
+      if(sqes == MAP_FAILED)
+        return false;
+
+      char *sq = static_cast<char *>(sqRing);
+      sqEntries = params.sq_entries;
+      sqHead  = reinterpret_cast<unsigned int *>(sq + params.sq_off.head);
+      sqTail  = reinterpret_cast<unsigned int *>(sq + params.sq_off.tail);
+      sqMask  = reinterpret_cast<unsigned int *>(sq + params.sq_off.ring_mask);
+      sqArray = reinterpret_cast<unsigned int *>(sq + params.sq_off.array);
+
+      char *cq = static_cast<char *>(cqRing);
+      cqHead = reinterpret_cast<unsigned int *>(cq + params.cq_off.head);
+      cqTail = reinterpret_cast<unsigned int *>(cq + params.cq_off.tail);
+      cqMask = reinterpret_cast<unsigned int *>(cq + params.cq_off.ring_mask);
+      cqes   = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+      return true;
+    }
+
+    // Queues a read, which is submitted by the next enter().  Returns false
+    // if the submission queue is full.
+
+    bool prepareRead(int fileFd, char *buffer, unsigned int length,
+                     long long offset, unsigned long long userData)
+    {
+      const unsigned int tail = *sqTail;
+      if(tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+        return false;
+
+      const unsigned int index = tail & *sqMask;
+      io_uring_sqe *sqe = &sqes[index];
+      ::memset(sqe, 0, sizeof(io_uring_sqe));
+      sqe->opcode    = IORING_OP_READ;
+      sqe->fd        = fileFd;
+      sqe->addr      = reinterpret_cast<unsigned long long>(buffer);
+      sqe->len       = length;
+      sqe->off       = static_cast<unsigned long long>(offset);
+      sqe->user_data = userData;
+
+      sqArray[index] = index;
+      __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+      ++pending;
+      return true;
+    }
+
+    // Queues the cancellation of the read with the given user data.  Its own
+    // completion carries cancelId.
+
+    bool prepareCancel(unsigned long long readUserData, unsigned long long cancelId)
+    {
+      const unsigned int tail = *sqTail;
+      if(tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+        return false;
+
+      const unsigned int index = tail & *sqMask;
+      io_uring_sqe *sqe = &sqes[index];
+      ::memset(sqe, 0, sizeof(io_uring_sqe));
+      sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+      sqe->fd        = -1;
+      sqe->addr      = readUserData;
+      sqe->user_data = cancelId;
+
+      sqArray[index] = index;
+      __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+      ++pending;
+      return true;
+    }
+
+    // Takes back the entries which were queued but not submitted, so that
+    // they never run.  Returns how many there were.
+
+    unsigned int discardPending()
+    {
+      const unsigned int discarded = pending;
+      __atomic_store_n(sqTail, *sqTail - discarded, __ATOMIC_RELEASE);
+      pending = 0;
+      return discarded;
+    }
+
+    // Submits the queued reads and waits for at least waitFor of them to
+    // complete.
+
+    bool enter(unsigned int waitFor)
+    {
+      for(;;) {
+        const long submitted = ::syscall(__NR_io_uring_enter, fd, pending, waitFor,
+                                         waitFor > 0 ? IORING_ENTER_GETEVENTS : 0, 0, 0);
+        if(submitted >= 0) {
+          pending -= static_cast<unsigned int>(submitted);
+          return true;
+        }
+        if(errno != EINTR && errno != EAGAIN && errno != EBUSY)
+          return false;
+      }
+    }
+
+    // Takes the next completion if there is one.
+
+    bool complete(unsigned long long &userData, int &result)
+    {
+      const unsigned int head = *cqHead;
+      if(head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+        return false;
+
+      const io_uring_cqe &cqe = cqes[head & *cqMask];
+      userData = cqe.user_data;
+      result = cqe.res;
+      __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+      return true;
+    }
+
+  private:
+    int fd;
+    void *sqRing;
+    void *cqRing;
+    io_uring_sqe *sqes;
+    size_t sqRingSize;
+    size_t cqRingSize;
+    size_t sqesSize;
+    unsigned int sqEntries;
+    unsigned int *sqHead;
+    unsigned int *sqTail;
+    unsigned int *sqMask;
+    unsigned int *sqArray;
+    unsigned int *cqHead;
+    unsigned int *cqTail;
+    unsigned int *cqMask;
+    io_uring_cqe *cqes;
+    unsigned int pending;
+  };
+
+  // The user data of a read: the index of the file and whether it is the
+  // read of the tail.
+
+  unsigned long long readId(size_t file, bool tail)
+  {
+    return (static_cast<unsigned long long>(file) << 1) | (tail ? 1 : 0);
+  }
+
+  // The user data of the cancellations, which no read has.
+
+  const unsigned long long cancelId = ~0ULL;
+
+  // Prefetches the files in batches of queueDepth.  Returns the index of the
+  // first file which has not been prefetched, which is less than the number
+  // of files if the ring stopped working.
+
+  size_t prefetchWithRing(std::vector<Prefetch> &files,
+                          unsigned int headSize, unsigned int tailSize,
+                          unsigned int queueDepth)
+  {
+    Ring ring;
+    if(!ring.setup(queueDepth * 2)) {
+      debug("FilePrefetcher::open() -- io_uring is not available.");
+      return 0;
+    }
+
+    for(size_t first = 0; first < files.size(); first += queueDepth) {
+      const size_t last = std::min<size_t>(first + queueDepth, files.size());
+
+      std::vector<char> done((last - first) * 2, 1);
+      unsigned int inFlight = 0;
+
+      for(size_t i = first; i < last; ++i) {
+        Prefetch &file = files[i];
+        openFile(file, headSize, tailSize);
+        if(file.fd < 0)
+          continue;
+
+        for(int part = 0; part < 2; ++part) {
+          ByteVector &data = part == 0 ? file.head : file.tail;
+          if(data.isEmpty())
+            continue;
+
+          const long long offset = part == 0 ? 0 : tailOffset(file);
+          if(ring.prepareRead(file.fd, data.data(), data.size(), offset, readId(i, part != 0))) {
+            done[(i - first) * 2 + part] = 0;
+            ++inFlight;
+          }
+          else
+            readRemaining(file.fd, data, offset);
+        }
+      }
+
+      bool failed = false;
+      while(inFlight > 0) {
+        unsigned long long userData;
+        int result;
+        if(!ring.complete(userData, result)) {
+          if(!ring.enter(1)) {
+            failed = true;
+            break;
+          }
+          continue;
+        }
+
+        --inFlight;
+
+        Prefetch &file = files[userData >> 1];
+        const bool tail = (userData & 1) != 0;
+        ByteVector &data = tail ? file.tail : file.head;
+        done[(static_cast<size_t>(userData >> 1) - first) * 2 + (tail ? 1 : 0)] = 1;
+
+        // Older kernels do not know IORING_OP_READ and reads may come back
+        // short, so whatever is missing is read directly.
+
+        const size_t count = result > 0 ? static_cast<size_t>(result) : 0;
+        if(count < data.size())
+          readRemaining(file.fd, data, tail ? tailOffset(file) : 0, count);
+      }
+
+      // The reads which were submitted but have not completed may still
+      // write to their buffers, even after the ring is closed.  Those which
+      // were never submitted are taken back, the others are cancelled, and
+      // their completions are waited for before the data is read again into
+      // the same buffers.
+
+      if(failed) {
+        debug("FilePrefetcher::open() -- io_uring stopped working.");
+
+        inFlight -= ring.discardPending();
+
+        for(size_t i = first; i < last && inFlight > 0; ++i) {
+          for(int part = 0; part < 2; ++part) {
+            if(!done[(i - first) * 2 + part])
+              ring.prepareCancel(readId(i, part != 0), cancelId);
+          }
+        }
+
+        while(inFlight > 0) {
+          unsigned long long userData;
+          int result;
+          if(ring.complete(userData, result)) {
+            if(userData != cancelId)
+              --inFlight;
+          }
+          else if(!ring.enter(1)) {
+
+            // The completions are still posted without entering the ring.
+
+            ring.discardPending();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+        }
+
+        for(size_t i = first; i < last; ++i) {
+          Prefetch &file = files[i];
+          if(file.fd < 0)
+            continue;
+
+          for(int part = 0; part < 2; ++part) {
+            if(!done[(i - first) * 2 + part]) {
+              ByteVector &data = part == 0 ? file.head : file.tail;
+              readRemaining(file.fd, data, part == 0 ? 0 : tailOffset(file));
+            }
+          }
+        }
+      }
+
+      for(size_t i = first; i < last; ++i)
+        closeFile(files[i]);
+
+      if(failed)
+        return last;
+    }
+
+    return files.size();
+  }
+
+#endif
+}
+
+class PrefetchedFileStream::PrefetchedFileStreamPrivate
+{
+public:
+  PrefetchedFileStreamPrivate(FileName fileName, long long fileLength,
+                              const ByteVector &headData, const ByteVector &tailData) :
+    name(fileName),
+    length(fileLength),
+    head(headData),
+    tail(tailData),
+    position(0),
+    fd(-1),
+    missedReads(0) {}
+
+  ~PrefetchedFileStreamPrivate()
+  {
+    if(fd >= 0)
+      ::close(fd);
+  }
+
+  const std::string name;
+  const long long length;
+  const ByteVector head;
+  const ByteVector tail;
+  long long position;
+  int fd;
+  unsigned int missedReads;
+};
+
+class FilePrefetcher::FilePrefetcherPrivate
+{
+public:
+  FilePrefetcherPrivate() :
+    headSize(64 * 1024),
+    tailSize(16 * 1024),
+    queueDepth(64),
+    backend(Automatic) {}
+
+  unsigned int headSize;
+  unsigned int tailSize;
+  unsigned int queueDepth;
+  Backend backend;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// PrefetchedFileStream public members
+////////////////////////////////////////////////////////////////////////////////
+
+PrefetchedFileStream::PrefetchedFileStream(FileName fileName, long long length,
+                                           const ByteVector &head, const ByteVector &tail) :
+  d(new PrefetchedFileStreamPrivate(fileName, length, head, tail))
+{
+}
+
+PrefetchedFileStream::~PrefetchedFileStream()
+{
+  delete d;
+}
+
+FileName PrefetchedFileStream::name() const
+{
+  return d->name.c_str();
+}
+
+ByteVector PrefetchedFileStream::readBlock(unsigned long length)
+{
+  const ByteVector data = readAt(d->position, length);
+  d->position += data.size();
+  return data;
+}
+
+ByteVector PrefetchedFileStream::readAt(long long offset, unsigned long length)
+{
+  if(length == 0 || offset < 0 || offset >= d->length)
+    return ByteVector();
+
+  const long long size = std::min<long long>(length, d->length - offset);
+  const long long tailStart = d->length - d->tail.size();
+
+  ByteVector data;
+  if(offset + size <= d->head.size()) {
+    data = d->head.mid(static_cast<unsigned int>(offset),
+                       static_cast<unsigned int>(size));
+  }
+  else if(offset >= tailStart) {
+    data = d->tail.mid(static_cast<unsigned int>(offset - tailStart),
+                       static_cast<unsigned int>(size));
+  }
+  else {
+    ++d->missedReads;
+
+    if(d->fd < 0) {
+      d->fd = ::open(d->name.c_str(), O_RDONLY | O_CLOEXEC);
+      if(d->fd < 0) {
+        debug("PrefetchedFileStream::readBlock() -- Could not reopen the file.");
+        return ByteVector();
+      }
+    }
+
+    data.resize(static_cast<unsigned int>(size));
+    readRemaining(d->fd, data, offset);
+  }
+
+  return data;
+}
+
+void PrefetchedFileStream::writeBlock(const ByteVector &)
+{
+  debug("PrefetchedFileStream::writeBlock() -- The stream is read only.");
+}
+
+void PrefetchedFileStream::insert(const ByteVector &, unsigned long, unsigned long)
+{
+  debug("PrefetchedFileStream::insert() -- The stream is read only.");
+}
+
+void PrefetchedFileStream::removeBlock(unsigned long, unsigned long)
+{
+  debug("PrefetchedFileStream::removeBlock() -- The stream is read only.");
+}
+
+bool PrefetchedFileStream::readOnly() const
+{
+  return true;
+}
+
+bool PrefetchedFileStream::isOpen() const
+{
+  return d->length >= 0;
+}
+
+void PrefetchedFileStream::seek(long long offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = d->length + offset;
+    break;
+  }
+}
+
+long long PrefetchedFileStream::tell() const
+{
+  return d->position;
+}
+
+long long PrefetchedFileStream::length()
+{
+  return std::max<long long>(d->length, 0);
+}
+
+void PrefetchedFileStream::truncate(long)
+{
+  debug("PrefetchedFileStream::truncate() -- The stream is read only.");
+}
+
+unsigned int PrefetchedFileStream::missedReads() const
+{
+  return d->missedReads;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FilePrefetcher public members
+////////////////////////////////////////////////////////////////////////////////
+
+FilePrefetcher::FilePrefetcher() :
+  d(new FilePrefetcherPrivate())
+{
+}
+
+FilePrefetcher::~FilePrefetcher()
+{
+  delete d;
+}
+
+void FilePrefetcher::setHeadSize(unsigned int size)
+{
+  d->headSize = size;
+}
+
+unsigned int FilePrefetcher::headSize() const
+{
+  return d->headSize;
+}
+
+void FilePrefetcher::setTailSize(unsigned int size)
+{
+  d->tailSize = size;
+}
+
+unsigned int FilePrefetcher::tailSize() const
+{
+  return d->tailSize;
+}
+
+void FilePrefetcher::setQueueDepth(unsigned int depth)
+{
+  d->queueDepth = std::max(depth, 1U);
+}
+
+unsigned int FilePrefetcher::queueDepth() const
+{
+  return d->queueDepth;
+}
+
+void FilePrefetcher::setBackend(Backend backend)
+{
+  d->backend = backend;
+}
+
+FilePrefetcher::Backend FilePrefetcher::backend() const
+{
+  return d->backend;
+}
+
+bool FilePrefetcher::isIOUringAvailable()
+{
+#ifdef HAVE_LINUX_IO_URING
+  Ring ring;
+  return ring.setup(1);
+#else
+  return false;
+#endif
+}
+
+List<PrefetchedFileStream *> FilePrefetcher::open(const StringList &paths) const
+{
+  std::vector<Prefetch> files(paths.size());
+
+  size_t i = 0;
+  for(StringList::ConstIterator it = paths.begin(); it != paths.end(); ++it, ++i)
+    files[i].name = it->to8Bit(true);
+
+  size_t prefetched = 0;
+
+#ifdef HAVE_LINUX_IO_URING
+  if(d->backend != ThreadPool && !files.empty())
+    prefetched = prefetchWithRing(files, d->headSize, d->tailSize, d->queueDepth);
+#endif
+
+  if(prefetched < files.size())
+    prefetchWithThreads(files, prefetched, d->headSize, d->tailSize, d->queueDepth);
+
+  List<PrefetchedFileStream *> streams;
+  for(std::vector<Prefetch>::const_iterator it = files.begin(); it != files.end(); ++it)
+    streams.append(new PrefetchedFileStream(it->name.c_str(), it->length, it->head, it->tail));
+
+  return streams;
+}
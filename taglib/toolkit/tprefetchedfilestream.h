@@ -0,0 +1,270 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_PREFETCHEDFILESTREAM_H
+#define TAGLIB_PREFETCHEDFILESTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tiostream.h"
+#include "tlist.h"
+#include "tstringlist.h"
+
+namespace TagLib {
+
+  //! A read only file stream whose head and tail have been read ahead
+
+  /*!
+   * Most formats keep their headers and tags at the start or the end of the
+   * file.  PrefetchedFileStream serves reads of these from memory and only
+   * goes to the file, with pread(), for the rest.  The streams are made by
+   * FilePrefetcher, which reads the heads and tails of many files at once.
+   *
+   * The stream is read only; writeBlock(), insert(), removeBlock() and
+   * truncate() do nothing.
+   *
+   * \note This is only available on POSIX systems.
+   *
+   * \see FilePrefetcher
+   */
+
+  class TAGLIB_EXPORT PrefetchedFileStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a stream for the file \a fileName of \a length bytes, whose
+     * first bytes are \a head and whose last bytes are \a tail.  If \a length
+     * is negative the file could not be opened and isOpen() returns false.
+     */
+    PrefetchedFileStream(FileName fileName, long long length,
+                         const ByteVector &head, const ByteVector &tail);
+
+    /*!
+     * Destroys this PrefetchedFileStream instance.
+     */
+    virtual ~PrefetchedFileStream();
+
+    /*!
+     * Returns the file name in the local file system encoding.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Reads a block of size \a length at \a offset, leaving the get pointer
+     * where it was.
+     */
+    ByteVector readAt(long long offset, unsigned long length);
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Returns true.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true if the file could be opened by the FilePrefetcher.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the file from position \a p.  This
+     * defaults to seeking from the beginning of the file.
+     *
+     * \see Position
+     */
+    void seek(long long offset, Position p = Beginning);
+
+    /*!
+     * Returns the current offset within the file.
+     */
+    long long tell() const;
+
+    /*!
+     * Returns the length of the file.
+     */
+    long long length();
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void truncate(long length);
+
+    /*!
+     * Returns the number of reads which had to go to the file
+     * rather than from the prefetched head and tail.
+     */
+    unsigned int missedReads() const;
+
+  private:
+    PrefetchedFileStream(const PrefetchedFileStream &);
+    PrefetchedFileStream &operator=(const PrefetchedFileStream &);
+
+    class PrefetchedFileStreamPrivate;
+    PrefetchedFileStreamPrivate *d;
+  };
+
+  //! Opens many files at once, reading their heads and tails ahead
+
+  /*!
+   * FilePrefetcher opens a list of files and reads the start and the end of
+   * each into a PrefetchedFileStream, which can then be passed to FileRef or
+   * to the constructors of the file types.  The reads of up to queueDepth()
+   * files are in flight at the same time, so their latencies overlap instead
+   * of adding up as they do with one FileStream after another.
+   *
+   * On Linux the reads are submitted together through io_uring.  Where it is
+   * not available, because of the kernel or a seccomp policy, a pool of
+   * threads reads the files instead.
+   *
+   * \code
+   *
+   * TagLib::FilePrefetcher prefetcher;
+   * TagLib::List<TagLib::PrefetchedFileStream *> streams = prefetcher.open(paths);
+   * streams.setAutoDelete(true);
+   *
+   * for(TagLib::List<TagLib::PrefetchedFileStream *>::ConstIterator it = streams.begin();
+   *     it != streams.end(); ++it) {
+   *   TagLib::FileRef f(*it);
+   *   ...
+   * }
+   *
+   * \endcode
+   *
+   * \note This is only available on POSIX systems.
+   */
+
+  class TAGLIB_EXPORT FilePrefetcher
+  {
+  public:
+    /*!
+     * The ways of reading the files.
+     */
+    enum Backend {
+      //! io_uring if it is available, threads otherwise
+      Automatic,
+      //! Submits the reads through io_uring
+      IOUring,
+      //! Reads the files on a pool of threads
+      ThreadPool
+    };
+
+    /*!
+     * Constructs a FilePrefetcher which reads the first 64 KiB and the last
+     * 16 KiB of the files, with up to 64 files in flight.
+     */
+    FilePrefetcher();
+
+    /*!
+     * Destroys this FilePrefetcher instance.
+     */
+    ~FilePrefetcher();
+
+    /*!
+     * Sets the number of bytes read from the start of each file to \a size.
+     */
+    void setHeadSize(unsigned int size);
+
+    /*!
+     * Returns the number of bytes read from the start of each file.
+     */
+    unsigned int headSize() const;
+
+    /*!
+     * Sets the number of bytes read from the end of each file to \a size.
+     */
+    void setTailSize(unsigned int size);
+
+    /*!
+     * Returns the number of bytes read from the end of each file.
+     */
+    unsigned int tailSize() const;
+
+    /*!
+     * Sets the number of files whose reads are in flight at the same time to
+     * \a depth, which is also the number of files open at the same time.
+     */
+    void setQueueDepth(unsigned int depth);
+
+    /*!
+     * Returns the number of files whose reads are in flight at the same time.
+     */
+    unsigned int queueDepth() const;
+
+    /*!
+     * Sets the way of reading the files to \a backend.  If IOUring is asked
+     * for but is not available, the thread pool is used.
+     */
+    void setBackend(Backend backend);
+
+    /*!
+     * Returns the way of reading the files that was asked for.
+     */
+    Backend backend() const;
+
+    /*!
+     * Returns true if io_uring can be used in this process.
+     */
+    static bool isIOUringAvailable();
+
+    /*!
+     * Opens the files \a paths and reads their heads and tails.  Returns a
+     * stream for each of the paths, in the same order.  The stream of a file
+     * which could not be opened is not open.
+     *
+     * \note The caller takes ownership of the streams, for example with
+     * List::setAutoDelete().
+     */
+    List<PrefetchedFileStream *> open(const StringList &paths) const;
+
+  private:
+    FilePrefetcher(const FilePrefetcher &);
+    FilePrefetcher &operator=(const FilePrefetcher &);
+
+    class FilePrefetcherPrivate;
+    FilePrefetcherPrivate *d;
+  };
+
+}
+
+#endif
@@ -58,7 +58,7 @@ bool PropertyMap::insert(const String &key, const StringList &values)
   if(result == end())
     SimplePropertyMap::insert(realKey, values);
   else
-    SimplePropertyMap::operator[](realKey).append(values);
+    result->second.append(values);
   return true;
 }
 
@@ -23,6 +23,7 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <atomic>
 #include <cerrno>
 #include <climits>
 
@@ -134,6 +135,50 @@ namespace
         data[i] = c;
     }
   }
+
+  // Converts UTF-16(without BOM/CPU byte order) into UTF-8.  The output is
+  // sized exactly, since it may be kept around as a cache.
+  ByteVector copyToUTF8(const std::wstring &data)
+  {
+    size_t length = 0;
+    for(std::wstring::const_iterator it = data.begin(); it != data.end(); ++it) {
+      if(*it < 0x80)
+        length += 1;
+      else if(*it < 0x800)
+        length += 2;
+      else if(*it >= 0xD800 && *it < 0xE000)
+        length += 2; // Half of a surrogate pair, which takes 4 bytes.
+      else
+        length += 3;
+    }
+
+    ByteVector v(static_cast<unsigned int>(length), 0);
+    if(length == 0)
+      return v;
+
+    if(length == data.size()) {
+
+      // Only ASCII characters.
+
+      char *p = v.data();
+      for(std::wstring::const_iterator it = data.begin(); it != data.end(); ++it)
+        *p++ = static_cast<char>(*it);
+
+      return v;
+    }
+
+    try {
+      const ByteVector::Iterator dstEnd = utf8::utf16to8(data.begin(), data.end(), v.begin());
+      v.resize(static_cast<unsigned int>(dstEnd - v.begin()));
+    }
+    catch(const utf8::exception &e) {
+      const String message(e.what());
+      debug("String::data() - UTF8-CPP error: " + message);
+      v.clear();
+    }
+
+    return v;
+  }
 }
 
 namespace TagLib {
@@ -142,7 +187,14 @@ class String::StringPrivate : public RefCounter
 {
 public:
   StringPrivate() :
-    RefCounter() {}
+    RefCounter(),
+    utf8(0),
+    cacheable(true) {}
+
+  ~StringPrivate()
+  {
+    delete utf8.load();
+  }
 
   /*!
    * Stores string in UTF-16. The byte order depends on the CPU endian.
@@ -153,6 +205,20 @@ public:
    * This is only used to hold the the most recent value of toCString().
    */
   std::string cstring;
+
+  /*!
+   * The UTF-8 representation of the string, created by the first call of
+   * data(UTF8) and discarded by detach().  Copies of the string share this
+   * object and may be read from several threads, so it is only ever set
+   * with a compare-and-swap.
+   */
+  std::atomic<ByteVector *> utf8;
+
+  /*!
+   * Cleared once an iterator or a reference which can write the string has
+   * been handed out, as the cache would not notice such writes.
+   */
+  bool cacheable;
 };
 
 String String::null;
@@ -304,6 +370,7 @@ const wchar_t *String::toCWString() const
 String::Iterator String::begin()
 {
   detach();
+  d->cacheable = false;
   return d->data.begin();
 }
 
@@ -315,6 +382,7 @@ String::ConstIterator String::begin() const
 String::Iterator String::end()
 {
   detach();
+  d->cacheable = false;
   return d->data.end();
 }
 
@@ -381,6 +449,15 @@ String & String::clear()
 
 String String::upper() const
 {
+  // Most keys are upper case already, in which case the data can be shared.
+
+  ConstIterator first = begin();
+  while(first != end() && !(*first >= 'a' && *first <= 'z'))
+    ++first;
+
+  if(first == end())
+    return *this;
+
   String s;
   s.d->data.reserve(size());
 
@@ -430,19 +507,22 @@ ByteVector String::data(Type t) const
     }
   case UTF8:
     {
-      ByteVector v(size() * 4, 0);
-
-      try {
-        const ByteVector::Iterator dstEnd = utf8::utf16to8(begin(), end(), v.begin());
-        v.resize(static_cast<unsigned int>(dstEnd - v.begin()));
-      }
-      catch(const utf8::exception &e) {
-        const String message(e.what());
-        debug("String::data() - UTF8-CPP error: " + message);
-        v.clear();
+      if(isEmpty())
+        return ByteVector();
+
+      if(!d->cacheable)
+        return copyToUTF8(d->data);
+
+      ByteVector *utf8 = d->utf8.load(std::memory_order_acquire);
+      if(!utf8) {
+        ByteVector *converted = new ByteVector(copyToUTF8(d->data));
+        if(d->utf8.compare_exchange_strong(utf8, converted, std::memory_order_acq_rel))
+          utf8 = converted;
+        else
+          delete converted;
       }
 
-      return v;
+      return *utf8;
     }
   case UTF16:
     {
@@ -552,6 +632,7 @@ String String::number(int n) // static
 wchar_t &String::operator[](int i)
 {
   detach();
+  d->cacheable = false;
   return d->data[i];
 }
 
@@ -703,8 +784,12 @@ bool String::operator<(const String &s) const
 
 void String::detach()
 {
-  if(d->count() > 1)
+  if(d->count() > 1) {
     String(d->data.c_str()).swap(*this);
+  }
+  else {
+    delete d->utf8.exchange(0);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
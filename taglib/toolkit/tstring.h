@@ -351,6 +351,11 @@ namespace TagLib {
      * format and has a BOM.
      *
      * \note The returned data is not null terminated.
+     *
+     * \note The UTF8 representation is computed on first use and kept with the
+     * string until it is modified, so repeated calls for UTF8, as well as
+     * to8Bit(true) and toCString(true), do not convert the string again.  It
+     * is not kept once a non-const iterator or reference has been taken.
      */
     ByteVector data(Type t) const;
 
@@ -33,6 +33,9 @@
 # include <tdebug.h>
 #endif
 
+#include <algorithm>
+#include <limits>
+
 #include "tzlib.h"
 
 using namespace TagLib;
@@ -51,6 +54,12 @@ bool zlib::isAvailable()
 }
 
 ByteVector zlib::decompress(const ByteVector &data)
+{
+  return decompress(data, 0, std::numeric_limits<unsigned int>::max());
+}
+
+ByteVector zlib::decompress(const ByteVector &data, unsigned int sizeHint,
+                            unsigned int maxSize)
 {
 #ifdef HAVE_ZLIB
 
@@ -61,21 +70,42 @@ ByteVector zlib::decompress(const ByteVector &data)
     return ByteVector();
   }
 
-  ByteVector inData = data;
+  // zlib does not write to the input, so it is not copied.
+
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_in  = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+
+  const unsigned int minChunkSize = 1024;
+
+  // The hint may come from the file, so the first buffer is no larger than
+  // the data can inflate to.  Deflate expands by at most 1032:1.
 
-  stream.avail_in = static_cast<uInt>(inData.size());
-  stream.next_in  = reinterpret_cast<Bytef *>(inData.data());
+  const unsigned long long maxExpansion = 1032ULL * data.size();
+  if(sizeHint > maxExpansion)
+    sizeHint = static_cast<unsigned int>(maxExpansion);
 
-  const unsigned int chunkSize = 1024;
+  ByteVector outData(std::min(std::max(sizeHint, minChunkSize), maxSize), 0);
+  unsigned int outSize = 0;
 
-  ByteVector outData;
+  while(true) {
 
-  do {
-    const size_t offset = outData.size();
-    outData.resize(outData.size() + chunkSize);
+    // The buffer is doubled when it is full, so that large data is not
+    // copied over and over.
 
-    stream.avail_out = static_cast<uInt>(chunkSize);
-    stream.next_out  = reinterpret_cast<Bytef *>(outData.data() + offset);
+    if(outSize == outData.size()) {
+      if(outSize >= maxSize) {
+        inflateEnd(&stream);
+
+        debug("zlib::decompress() - The decompressed data is too large.");
+        return ByteVector();
+      }
+
+      const unsigned int growth = std::max(outSize, minChunkSize);
+      outData.resize(outSize + std::min(growth, maxSize - outSize));
+    }
+
+    stream.avail_out = static_cast<uInt>(outData.size() - outSize);
+    stream.next_out  = reinterpret_cast<Bytef *>(outData.data() + outSize);
 
     const int result = inflate(&stream, Z_NO_FLUSH);
 
@@ -91,11 +121,15 @@ ByteVector zlib::decompress(const ByteVector &data)
       return ByteVector();
     }
 
-    outData.resize(outData.size() - stream.avail_out);
-  } while(stream.avail_out == 0);
+    outSize = outData.size() - stream.avail_out;
+
+    if(result == Z_STREAM_END || stream.avail_out != 0)
+      break;
+  }
 
   inflateEnd(&stream);
 
+  outData.resize(outSize);
   return outData;
 
 #else
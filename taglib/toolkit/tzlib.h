@@ -46,6 +46,15 @@ namespace TagLib {
       */
      ByteVector decompress(const ByteVector &data);
 
+     /*!
+      * Decompress \a data by zlib, into a buffer of \a sizeHint bytes, which
+      * is grown if the data turns out to be larger.  The first buffer is no
+      * larger than \a data can inflate to, whatever the hint.  Returns an empty
+      * ByteVector if the decompressed data would be larger than \a maxSize.
+      */
+     ByteVector decompress(const ByteVector &data, unsigned int sizeHint,
+                           unsigned int maxSize);
+
   }
 }
 
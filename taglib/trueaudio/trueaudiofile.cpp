@@ -114,6 +114,15 @@ TrueAudio::File::File(IOStream *stream, bool readProperties, Properties::ReadSty
     read(readProperties);
 }
 
+TrueAudio::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 TrueAudio::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
                       bool readProperties, Properties::ReadStyle) :
   TagLib::File(stream),
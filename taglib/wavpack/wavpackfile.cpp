@@ -103,6 +103,15 @@ WavPack::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle
     read(readProperties);
 }
 
+WavPack::File::File(IOStream *stream, ReadOptions readOptions, Properties::ReadStyle) :
+  TagLib::File(stream),
+  d(new FilePrivate())
+{
+  setReadOptions(readOptions);
+  if(isOpen())
+    read((readOptions & ReadAudioProperties) != 0);
+}
+
 WavPack::File::~File()
 {
   delete d;
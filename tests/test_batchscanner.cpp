@@ -0,0 +1,175 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <set>
+#include <batchscanner.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  class RecordingListener : public BatchScanner::Listener
+  {
+  public:
+    virtual void fileScanned(const BatchScanner::Result &result)
+    {
+      results.append(result);
+    }
+
+    List<BatchScanner::Result> results;
+  };
+
+  StringList testFiles()
+  {
+    StringList paths;
+    paths.append(TEST_FILE_PATH_C("silence-44-s.flac"));
+    paths.append(TEST_FILE_PATH_C("no-such-file.mp3"));
+    paths.append(TEST_FILE_PATH_C("has-tags.m4a"));
+    paths.append(TEST_FILE_PATH_C("unsupported-extension.xx"));
+    paths.append(TEST_FILE_PATH_C("lame_cbr.mp3"));
+    paths.append(TEST_FILE_PATH_C("empty.ogg"));
+    return paths;
+  }
+}
+
+class TestBatchScanner : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestBatchScanner);
+  CPPUNIT_TEST(testDefaults);
+  CPPUNIT_TEST(testResults);
+  CPPUNIT_TEST(testListener);
+  CPPUNIT_TEST(testNoAudioProperties);
+  CPPUNIT_TEST(testEmpty);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testDefaults()
+  {
+    BatchScanner scanner;
+    CPPUNIT_ASSERT(scanner.threadCount() >= 1);
+    CPPUNIT_ASSERT_EQUAL(scanner.threadCount(), scanner.maxOpenFiles());
+
+    scanner.setThreadCount(3);
+    CPPUNIT_ASSERT_EQUAL(3U, scanner.threadCount());
+    CPPUNIT_ASSERT_EQUAL(3U, scanner.maxOpenFiles());
+
+    scanner.setMaxOpenFiles(1);
+    CPPUNIT_ASSERT_EQUAL(1U, scanner.maxOpenFiles());
+  }
+
+  void testResults()
+  {
+    const StringList paths = testFiles();
+
+    BatchScanner scanner;
+    scanner.setThreadCount(4);
+    scanner.setMaxOpenFiles(2);
+    const List<BatchScanner::Result> results = scanner.scan(paths);
+
+    CPPUNIT_ASSERT_EQUAL(paths.size(), results.size());
+    for(unsigned int i = 0; i < results.size(); ++i) {
+      CPPUNIT_ASSERT_EQUAL(i, results[i].index());
+      CPPUNIT_ASSERT_EQUAL(paths[i], results[i].path());
+    }
+
+    CPPUNIT_ASSERT(results[0].isValid());
+    CPPUNIT_ASSERT(results[0].errorMessage().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(String("Silence"), results[0].properties()["TITLE"].front());
+    CPPUNIT_ASSERT_EQUAL(44100, results[0].sampleRate());
+    CPPUNIT_ASSERT_EQUAL(2, results[0].channels());
+    CPPUNIT_ASSERT(results[0].lengthInMilliseconds() > 0);
+
+    CPPUNIT_ASSERT(!results[1].isValid());
+    CPPUNIT_ASSERT_EQUAL(String("Could not open the file"), results[1].errorMessage());
+    CPPUNIT_ASSERT(results[1].properties().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0, results[1].sampleRate());
+
+    CPPUNIT_ASSERT(results[2].isValid());
+    CPPUNIT_ASSERT_EQUAL(44100, results[2].sampleRate());
+
+    CPPUNIT_ASSERT(!results[3].isValid());
+    CPPUNIT_ASSERT_EQUAL(String("Unsupported file type or invalid file"), results[3].errorMessage());
+
+    CPPUNIT_ASSERT(results[4].isValid());
+    CPPUNIT_ASSERT_EQUAL(1, results[4].channels());
+    CPPUNIT_ASSERT_EQUAL(64, results[4].bitrate());
+
+    CPPUNIT_ASSERT(results[5].isValid());
+    CPPUNIT_ASSERT_EQUAL(44100, results[5].sampleRate());
+  }
+
+  void testListener()
+  {
+    const StringList paths = testFiles();
+
+    BatchScanner scanner;
+    scanner.setThreadCount(3);
+    RecordingListener listener;
+    scanner.scan(paths, &listener);
+
+    CPPUNIT_ASSERT_EQUAL(paths.size(), listener.results.size());
+
+    set<unsigned int> indices;
+    for(List<BatchScanner::Result>::ConstIterator it = listener.results.begin();
+        it != listener.results.end(); ++it) {
+      CPPUNIT_ASSERT_EQUAL(paths[it->index()], it->path());
+      CPPUNIT_ASSERT(it->scanTimeInMicroseconds() >= 0);
+      indices.insert(it->index());
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(paths.size()), indices.size());
+  }
+
+  void testNoAudioProperties()
+  {
+    StringList paths;
+    paths.append(TEST_FILE_PATH_C("silence-44-s.flac"));
+
+    BatchScanner scanner;
+    scanner.setReadAudioProperties(false);
+    const List<BatchScanner::Result> results = scanner.scan(paths);
+
+    CPPUNIT_ASSERT_EQUAL(1U, results.size());
+    CPPUNIT_ASSERT(results[0].isValid());
+    CPPUNIT_ASSERT_EQUAL(String("Silence"), results[0].properties()["TITLE"].front());
+    CPPUNIT_ASSERT_EQUAL(0, results[0].sampleRate());
+    CPPUNIT_ASSERT_EQUAL(0, results[0].lengthInMilliseconds());
+  }
+
+  void testEmpty()
+  {
+    BatchScanner scanner;
+    RecordingListener listener;
+    scanner.scan(StringList(), &listener);
+    CPPUNIT_ASSERT(listener.results.isEmpty());
+    CPPUNIT_ASSERT(scanner.scan(StringList()).isEmpty());
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestBatchScanner);
@@ -24,9 +24,11 @@
  ***************************************************************************/
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 #include <tbytevector.h>
 #include <tbytevectorlist.h>
+#include <tbytereader.h>
 #include <cppunit/extensions/HelperMacros.h>
 
 using namespace std;
@@ -52,6 +54,11 @@ class TestByteVector : public CppUnit::TestFixture
   CPPUNIT_TEST(testAppend1);
   CPPUNIT_TEST(testAppend2);
   CPPUNIT_TEST(testBase64);
+  CPPUNIT_TEST(testBase64Long);
+  CPPUNIT_TEST(testBase64Chunked);
+  CPPUNIT_TEST(testPartialNumbers);
+  CPPUNIT_TEST(testByteReader);
+  CPPUNIT_TEST(testVInt);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -594,6 +601,149 @@ public:
 
   }
 
+  void testBase64Long()
+  {
+    // Long enough to go through the block-wise code paths.
+
+    for(unsigned int size = 0; size < 200; ++size) {
+      ByteVector data(size);
+      for(unsigned int i = 0; i < size; ++i)
+        data[i] = static_cast<char>(i * 7 + size);
+
+      const ByteVector encoded = data.toBase64();
+      CPPUNIT_ASSERT_EQUAL((size + 2) / 3 * 4, encoded.size());
+      CPPUNIT_ASSERT_EQUAL(data, ByteVector::fromBase64(encoded));
+    }
+
+    ByteVector data(1000U);
+    for(unsigned int i = 0; i < data.size(); ++i)
+      data[i] = static_cast<char>(i);
+
+    const ByteVector encoded = data.toBase64();
+    CPPUNIT_ASSERT(encoded.startsWith("AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygpKissLS4v"));
+
+    // Invalid characters and misplaced padding in the middle of the data.
+
+    const char invalid[] = { '=', '!', '\n', '\x80', '\xff', '-', '_' };
+    for(unsigned int i = 0; i < sizeof(invalid); ++i) {
+      for(unsigned int pos = 0; pos < 100; pos += 13) {
+        ByteVector broken = encoded;
+        broken[pos] = invalid[i];
+        CPPUNIT_ASSERT_EQUAL(ByteVector(), ByteVector::fromBase64(broken));
+      }
+    }
+  }
+
+  void testBase64Chunked()
+  {
+    ByteVector data(500U);
+    for(unsigned int i = 0; i < data.size(); ++i)
+      data[i] = static_cast<char>(i * 3);
+
+    const ByteVector encoded = data.toBase64();
+
+    ByteVector decoded(encoded.size() / 4 * 3);
+    int length = 0;
+    for(unsigned int offset = 0; offset < encoded.size(); offset += 64) {
+      const unsigned int chunk = std::min(64U, encoded.size() - offset);
+      const int n = ByteVector::fromBase64(encoded.data() + offset, chunk, decoded.data() + length);
+      CPPUNIT_ASSERT(n >= 0);
+      length += n;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(500, length);
+    CPPUNIT_ASSERT_EQUAL(data, decoded.mid(0, length));
+
+    char output[3];
+    CPPUNIT_ASSERT_EQUAL(0, ByteVector::fromBase64("", 0, output));
+    CPPUNIT_ASSERT_EQUAL(-1, ByteVector::fromBase64("YQ=", 3, output));
+    CPPUNIT_ASSERT_EQUAL(1, ByteVector::fromBase64("YQ==", 4, output));
+    CPPUNIT_ASSERT_EQUAL('a', output[0]);
+  }
+
+  void testPartialNumbers()
+  {
+    const ByteVector data("\x01\x02\x03\x04\x05", 5);
+
+    CPPUNIT_ASSERT_EQUAL(0x010203U, data.toUInt(0U, 3U));
+    CPPUNIT_ASSERT_EQUAL(0x030201U, data.toUInt(0U, 3U, false));
+    CPPUNIT_ASSERT_EQUAL(0x0405U, data.toUInt(3U, 4U));
+    CPPUNIT_ASSERT_EQUAL(0x0504U, data.toUInt(3U, 4U, false));
+    CPPUNIT_ASSERT_EQUAL(0x05U, data.toUInt(4U, 1U));
+    CPPUNIT_ASSERT_EQUAL(0U, data.toUInt(0U, 0U));
+    CPPUNIT_ASSERT_EQUAL(0U, data.toUInt(1U, 0U, false));
+    CPPUNIT_ASSERT_EQUAL(0x0405, static_cast<int>(data.toShort(3U)));
+    CPPUNIT_ASSERT_EQUAL(0x0102030405LL, data.toLongLong());
+    CPPUNIT_ASSERT_EQUAL(0x0504030201LL, data.toLongLong(false));
+  }
+
+  void testByteReader()
+  {
+    const ByteVector data("\x12\x34\x56\x78\x9a\xbc\xde\xf0\x01\x02\x03\x04\x05\x06\x07", 15);
+    Utils::ByteReader reader(data);
+
+    unsigned char byte = 0;
+    unsigned short s = 0;
+    unsigned int i = 0;
+    unsigned long long ll = 0;
+
+    CPPUNIT_ASSERT(reader.readByte(byte));
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(0x12), byte);
+    CPPUNIT_ASSERT(reader.readShort(s));
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(0x3456), s);
+    CPPUNIT_ASSERT(reader.readUInt(i, false));
+    CPPUNIT_ASSERT_EQUAL(0xdebc9a78U, i);
+    CPPUNIT_ASSERT(reader.readLongLong(ll));
+    CPPUNIT_ASSERT_EQUAL(0xf001020304050607ULL, ll);
+    CPPUNIT_ASSERT(reader.atEnd());
+    CPPUNIT_ASSERT(!reader.readByte(byte));
+
+    Utils::ByteReader tail(data, 12);
+    CPPUNIT_ASSERT_EQUAL(3U, tail.remaining());
+    CPPUNIT_ASSERT(!tail.readUInt(i));
+    CPPUNIT_ASSERT_EQUAL(12U, tail.position());
+    CPPUNIT_ASSERT(!tail.skip(4));
+    CPPUNIT_ASSERT(tail.skip(1));
+
+    ByteVector bytes;
+    CPPUNIT_ASSERT(!tail.readBytes(bytes, 3));
+    CPPUNIT_ASSERT(tail.readBytes(bytes, 2));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("\x06\x07", 2), bytes);
+  }
+
+  void testVInt()
+  {
+    unsigned long long value = 0;
+
+    CPPUNIT_ASSERT_EQUAL(1U, Utils::decodeVInt("\x81", 1, value));
+    CPPUNIT_ASSERT_EQUAL(1ULL, value);
+    CPPUNIT_ASSERT_EQUAL(1U, Utils::decodeVInt("\xff", 1, value));
+    CPPUNIT_ASSERT_EQUAL(0x7fULL, value);
+    CPPUNIT_ASSERT_EQUAL(2U, Utils::decodeVInt("\x40\x02", 2, value));
+    CPPUNIT_ASSERT_EQUAL(2ULL, value);
+    CPPUNIT_ASSERT_EQUAL(4U, Utils::decodeVInt("\x1a\x45\xdf\xa3", 4, value, true));
+    CPPUNIT_ASSERT_EQUAL(0x1a45dfa3ULL, value);
+    CPPUNIT_ASSERT_EQUAL(8U, Utils::decodeVInt("\x01\x00\x00\x00\x00\x00\x01\x23", 8, value));
+    CPPUNIT_ASSERT_EQUAL(0x123ULL, value);
+    CPPUNIT_ASSERT_EQUAL(3U, Utils::decodeVInt("\x20\x12\x34\xff\xff\xff\xff\xff\xff", 9, value));
+    CPPUNIT_ASSERT_EQUAL(0x1234ULL, value);
+
+    CPPUNIT_ASSERT_EQUAL(0U, Utils::decodeVInt("\x00\x81", 2, value));
+    CPPUNIT_ASSERT_EQUAL(0U, Utils::decodeVInt("\x40", 1, value));
+    CPPUNIT_ASSERT_EQUAL(0U, Utils::decodeVInt("", 0, value));
+
+    const ByteVector data("\x42\x86\x81\x01", 4);
+    Utils::ByteReader reader(data);
+    unsigned int length = 0;
+    CPPUNIT_ASSERT(reader.readVInt(value, length, true));
+    CPPUNIT_ASSERT_EQUAL(0x4286ULL, value);
+    CPPUNIT_ASSERT(reader.readVInt(value, length));
+    CPPUNIT_ASSERT_EQUAL(1ULL, value);
+    CPPUNIT_ASSERT_EQUAL(1U, length);
+    CPPUNIT_ASSERT(!reader.readVInt(value, length));
+    CPPUNIT_ASSERT_EQUAL(3U, reader.position());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestByteVector);
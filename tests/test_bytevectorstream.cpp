@@ -39,6 +39,7 @@ class TestByteVectorStream : public CppUnit::TestFixture
   CPPUNIT_TEST(testRemoveBlock);
   CPPUNIT_TEST(testInsert);
   CPPUNIT_TEST(testSeekEnd);
+  CPPUNIT_TEST(testReadAt);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -126,6 +127,23 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector("b"), stream.readBlock(1));
   }
 
+  void testReadAt()
+  {
+    ByteVector v("abcdefghijklmnopqrstuvwxyz");
+    ByteVectorStream stream(v);
+    stream.seek(3);
+
+    CPPUNIT_ASSERT_EQUAL(ByteVector("klm"), stream.readAt(10, 3));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("yz"), stream.readAt(24, 10));
+    CPPUNIT_ASSERT(stream.readAt(26, 1).isEmpty());
+    CPPUNIT_ASSERT(stream.readAt(-1, 1).isEmpty());
+    CPPUNIT_ASSERT_EQUAL(3LL, stream.tell());
+
+    IOStream &base = stream;
+    CPPUNIT_ASSERT_EQUAL(ByteVector("pq"), base.readAt(15, 2));
+    CPPUNIT_ASSERT_EQUAL(3LL, stream.tell());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestByteVectorStream);
@@ -24,6 +24,10 @@
  ***************************************************************************/
 
 #include <tfile.h>
+#include <tfilestream.h>
+#include <tpropertymap.h>
+#include <mpegfile.h>
+#include <id3v2tag.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -39,6 +43,20 @@ public:
   void truncate(long length) { File::truncate(length); }
 };
 
+// A stream subclass, whose readBlock() readAt() must not bypass
+class CountingFileStream : public FileStream {
+public:
+  CountingFileStream(FileName name) : FileStream(name, true), reads(0) { }
+  ByteVector readBlock(unsigned long length) { ++reads; return FileStream::readBlock(length); }
+  int reads;
+};
+
+// A subclass of a format, which File dispatches to by dynamic_cast
+class DerivedMPEGFile : public MPEG::File {
+public:
+  DerivedMPEGFile(FileName name) : MPEG::File(name) { }
+};
+
 class TestFile : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestFile);
@@ -46,10 +64,35 @@ class TestFile : public CppUnit::TestFixture
   CPPUNIT_TEST(testRFindInSmallFile);
   CPPUNIT_TEST(testSeek);
   CPPUNIT_TEST(testTruncate);
+  CPPUNIT_TEST(testReadAt);
+  CPPUNIT_TEST(testPropertiesDispatch);
   CPPUNIT_TEST_SUITE_END();
 
 public:
 
+  void testPropertiesDispatch()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    PropertyMap map;
+    map["TITLE"] = StringList("Title");
+    map["ARTIST"] = StringList("Artist");
+    {
+      MPEG::File mpegFile(copy.fileName().c_str());
+      File &file = mpegFile;
+      CPPUNIT_ASSERT(file.setProperties(map).isEmpty());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), file.properties()["TITLE"].front());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), mpegFile.ID3v2Tag()->title());
+    }
+    {
+      DerivedMPEGFile derivedFile(copy.fileName().c_str());
+      File &file = derivedFile;
+      map["ARTIST"] = StringList("Other Artist");
+      CPPUNIT_ASSERT(file.setProperties(map).isEmpty());
+      CPPUNIT_ASSERT_EQUAL(String("Other Artist"), file.properties()["ARTIST"].front());
+      CPPUNIT_ASSERT_EQUAL(String("Other Artist"), derivedFile.ID3v2Tag()->artist());
+    }
+  }
+
   void testFindInSmallFile()
   {
     ScopedFileCopy copy("empty", ".ogg");
@@ -148,6 +191,32 @@ public:
     }
   }
 
+  void testReadAt()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector expected;
+    {
+      PlainFile f(name.c_str());
+      f.seek(4000);
+      expected = f.readBlock(328);
+      f.seek(100);
+
+      CPPUNIT_ASSERT_EQUAL(expected, f.readAt(4000, 328));
+      CPPUNIT_ASSERT_EQUAL(expected.mid(300), f.readAt(4300, 1000));
+      CPPUNIT_ASSERT(f.readAt(4328, 1).isEmpty());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("OggS"), f.readAt(0, 4));
+      CPPUNIT_ASSERT_EQUAL(100LL, f.tell());
+    }
+    {
+      CountingFileStream stream(name.c_str());
+      CPPUNIT_ASSERT_EQUAL(expected, stream.IOStream::readAt(4000, 328));
+      CPPUNIT_ASSERT_EQUAL(1, stream.reads);
+      CPPUNIT_ASSERT_EQUAL(4328LL, stream.tell());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFile);
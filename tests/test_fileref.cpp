@@ -26,6 +26,7 @@
 #include <string>
 #include <stdio.h>
 #include <tag.h>
+#include <tpropertymap.h>
 #include <fileref.h>
 #include <oggflacfile.h>
 #include <vorbisfile.h>
@@ -41,6 +42,14 @@
 #include <aifffile.h>
 #include <dsffile.h>
 #include <dsdifffile.h>
+#include <matroska/matroskafile.h>
+#include <riff/avi/avifile.h>
+#include <mpeg_video/mpegvideofile.h>
+#include <flacpicture.h>
+#include <xiphcomment.h>
+#include <id3v2tag.h>
+#include <attachedpictureframe.h>
+#include <textidentificationframe.h>
 #include <tfilestream.h>
 #include <tbytevectorstream.h>
 #include <cppunit/extensions/HelperMacros.h>
@@ -59,6 +68,23 @@ namespace
       return new Ogg::Vorbis::File(fileName);
     }
   };
+
+  // Counts the bytes read from the file.
+
+  class CountingStream : public FileStream
+  {
+  public:
+    CountingStream(FileName fileName) : FileStream(fileName), bytesRead(0) {}
+
+    virtual ByteVector readBlock(unsigned long length)
+    {
+      const ByteVector data = FileStream::readBlock(length);
+      bytesRead += data.size();
+      return data;
+    }
+
+    unsigned long bytesRead;
+  };
 }
 
 class TestFileRef : public CppUnit::TestFixture
@@ -83,9 +109,17 @@ class TestFileRef : public CppUnit::TestFixture
   CPPUNIT_TEST(testAIFF_2);
   CPPUNIT_TEST(testDSF);
   CPPUNIT_TEST(testDSDIFF);
+  CPPUNIT_TEST(testMatroskaByContent);
+  CPPUNIT_TEST(testAVIByContent);
+  CPPUNIT_TEST(testMPEGVideoByContent);
+  CPPUNIT_TEST(testMP3ByContent);
+  CPPUNIT_TEST(testMatroskaReadStyle);
   CPPUNIT_TEST(testUnsupported);
   CPPUNIT_TEST(testCreate);
   CPPUNIT_TEST(testFileResolver);
+  CPPUNIT_TEST(testReadOptionsFLAC);
+  CPPUNIT_TEST(testReadOptionsMP3);
+  CPPUNIT_TEST(testReadAudioPropertiesFlag);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -303,6 +337,105 @@ public:
     fileRefSave<DSDIFF::File>("empty10ms",".dff");
   }
 
+  void testMatroskaByContent()
+  {
+    {
+      ByteVector data("\x1a\x45\xdf\xa3\x8b\x42\x82\x88\x6d\x61\x74\x72\x6f\x73"
+                      "\x6b\x61\x18\x53\x80\x67\x93\x15\x49\xa9\x66\x8e\x2a\xd7"
+                      "\xb1\x83\x0f\x42\x40\x44\x89\x84\x45\x9c\x40\x00", 40);
+      ByteVectorStream stream(data);
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(dynamic_cast<Matroska::File *>(f.file()));
+    }
+    {
+      ByteVector data("\x1a\x45\xdf\xa3\x87\x42\x82\x84\x77\x65\x62\x6d\x18\x53"
+                      "\x80\x67\x93\x15\x49\xa9\x66\x8e\x2a\xd7\xb1\x83\x0f\x42"
+                      "\x40\x44\x89\x84\x45\x9c\x40\x00", 36);
+      ByteVectorStream stream(data);
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(dynamic_cast<Matroska::File *>(f.file()));
+    }
+  }
+
+  void testAVIByContent()
+  {
+    ByteVector data("RIFF\x10\x00\x00\x00" "AVI "
+                    "LIST\x04\x00\x00\x00" "hdrl", 24);
+    ByteVectorStream stream(data);
+    FileRef f(&stream);
+    CPPUNIT_ASSERT(dynamic_cast<RIFF::AVI::File *>(f.file()));
+  }
+
+  void testMPEGVideoByContent()
+  {
+    // An MPEG-2 pack header and the end of the program stream.
+
+    ByteVector data("\x00\x00\x01\xba\x44\x00\x04\x00\x04\x01\x01\x89\xc3\xf8"
+                    "\x00\x00\x01\xb9", 18);
+    ByteVectorStream stream(data);
+    FileRef f(&stream);
+    CPPUNIT_ASSERT(dynamic_cast<MPEG_VIDEO::File *>(f.file()));
+  }
+
+  void testMP3ByContent()
+  {
+    // The ID3v2 tag of the first file is in the first read of the stream, that
+    // of the second one is not.
+
+    CPPUNIT_ASSERT(isMP3ByContent("lame_cbr"));
+    CPPUNIT_ASSERT(isMP3ByContent("lame_vbr"));
+  }
+
+  bool isMP3ByContent(const string &filename)
+  {
+    ScopedFileCopy copy(filename, ".mp3");
+    const string newname = copy.fileName() + ".bin";
+    rename(copy.fileName().c_str(), newname.c_str());
+
+    bool isMP3;
+    {
+      FileRef f(newname.c_str());
+      isMP3 = dynamic_cast<MPEG::File *>(f.file()) != 0;
+    }
+
+    rename(newname.c_str(), copy.fileName().c_str());
+    return isMP3;
+  }
+
+  void testMatroskaReadStyle()
+  {
+    // A Duration of 5 s, and a Cluster at 7 s with a block at 500 ms in it.
+
+    const ByteVector data("\x1a\x45\xdf\xa3\x8b\x42\x82\x88\x6d\x61\x74\x72\x6f\x73"
+                          "\x6b\x61\x18\x53\x80\x67\xa3\x15\x49\xa9\x66\x8e\x2a\xd7"
+                          "\xb1\x83\x0f\x42\x40\x44\x89\x84\x45\x9c\x40\x00\x1f\x43"
+                          "\xb6\x75\x8b\xe7\x82\x1b\x58\xa3\x85\x81\x01\xf4\x80\x00", 56);
+    {
+      ByteVectorStream stream(data);
+      Matroska::File f(&stream, true, AudioProperties::Average);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(5, f.audioProperties()->length());
+    }
+    {
+      ByteVectorStream stream(data);
+      Matroska::File f(&stream, true, AudioProperties::Accurate);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(7, f.audioProperties()->length());
+    }
+    {
+      ByteVectorStream stream(data);
+      Matroska::File f(&stream, false, AudioProperties::Accurate);
+      CPPUNIT_ASSERT(!f.audioProperties());
+
+      // There are no Tags, which File::properties() used to dereference.
+      File &file = f;
+      CPPUNIT_ASSERT(file.properties().isEmpty());
+      PropertyMap map;
+      map["TITLE"] = StringList("Title");
+      CPPUNIT_ASSERT_EQUAL(1U, file.setProperties(map).size());
+    }
+  }
+
   void testUnsupported()
   {
     FileRef f1(TEST_FILE_PATH_C("no-extension"));
@@ -341,6 +474,127 @@ public:
     }
   }
 
+  void testReadOptionsFLAC()
+  {
+    ScopedFileCopy copy("no-tags", ".flac");
+    string newname = copy.fileName();
+
+    {
+      FLAC::File f(newname.c_str());
+      f.xiphComment(true)->setTitle("Title");
+      f.xiphComment(true)->addField("COMPOSER", "Composer");
+      FLAC::Picture *picture = new FLAC::Picture();
+      picture->setMimeType("image/jpeg");
+      picture->setData(ByteVector(100000, 'x'));
+      f.addPicture(picture);
+      f.save();
+    }
+    {
+      CountingStream stream(newname.c_str());
+      FileRef f(&stream, File::ReadEverything, AudioProperties::Average);
+      FLAC::File *flac = dynamic_cast<FLAC::File *>(f.file());
+      CPPUNIT_ASSERT(flac);
+      CPPUNIT_ASSERT(!flac->readOnly());
+      CPPUNIT_ASSERT_EQUAL(1U, flac->pictureList().size());
+      CPPUNIT_ASSERT(stream.bytesRead > 100000);
+    }
+    {
+      CountingStream stream(newname.c_str());
+      FileRef f(&stream, File::ReadBasicTags, AudioProperties::Average);
+      FLAC::File *flac = dynamic_cast<FLAC::File *>(f.file());
+      CPPUNIT_ASSERT(flac);
+      CPPUNIT_ASSERT(flac->readOnly());
+      CPPUNIT_ASSERT(!f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+      CPPUNIT_ASSERT(!flac->xiphComment()->contains("COMPOSER"));
+      CPPUNIT_ASSERT(flac->pictureList().isEmpty());
+      CPPUNIT_ASSERT(stream.bytesRead < 10000);
+    }
+    {
+      CountingStream stream(newname.c_str());
+      FileRef f(&stream, File::ReadAudioProperties, AudioProperties::Average);
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+      CPPUNIT_ASSERT(f.tag()->title().isEmpty());
+      CPPUNIT_ASSERT(stream.bytesRead < 10000);
+    }
+  }
+
+  void testReadOptionsMP3()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    string newname = copy.fileName();
+
+    {
+      MPEG::File f(newname.c_str());
+      ID3v2::Tag *tag = f.ID3v2Tag(true);
+      tag->setTitle("Title");
+      ID3v2::TextIdentificationFrame *composer = new ID3v2::TextIdentificationFrame("TCOM");
+      composer->setText("Composer");
+      tag->addFrame(composer);
+      ID3v2::AttachedPictureFrame *picture = new ID3v2::AttachedPictureFrame();
+      picture->setMimeType("image/jpeg");
+      picture->setPicture(ByteVector(100000, 'x'));
+      tag->addFrame(picture);
+      f.save();
+    }
+    {
+      CountingStream stream(newname.c_str());
+      FileRef f(&stream, File::ReadBasicTags | File::ReadPictures, AudioProperties::Average);
+      MPEG::File *mpeg = dynamic_cast<MPEG::File *>(f.file());
+      CPPUNIT_ASSERT(mpeg);
+      CPPUNIT_ASSERT(mpeg->readOnly());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+      CPPUNIT_ASSERT(mpeg->ID3v2Tag()->frameListMap()["TCOM"].isEmpty());
+      CPPUNIT_ASSERT_EQUAL(1U, mpeg->ID3v2Tag()->frameListMap()["APIC"].size());
+      CPPUNIT_ASSERT(stream.bytesRead > 100000);
+    }
+    {
+      CountingStream stream(newname.c_str());
+      FileRef f(&stream, File::ReadBasicTags, AudioProperties::Average);
+      MPEG::File *mpeg = dynamic_cast<MPEG::File *>(f.file());
+      CPPUNIT_ASSERT(mpeg);
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+      CPPUNIT_ASSERT(mpeg->ID3v2Tag()->frameListMap()["APIC"].isEmpty());
+      CPPUNIT_ASSERT(stream.bytesRead < 20000);
+    }
+    {
+      CountingStream stream(newname.c_str());
+      FileRef f(&stream, File::ReadAudioProperties, AudioProperties::Average);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT(f.audioProperties()->lengthInMilliseconds() > 0);
+      CPPUNIT_ASSERT(f.tag()->title().isEmpty());
+      CPPUNIT_ASSERT(stream.bytesRead < 20000);
+    }
+  }
+
+  void testReadAudioPropertiesFlag()
+  {
+    // An int or bool still means whether to read the audio properties, and
+    // does not bind to the constructors which take File::ReadOptions.
+    {
+      FileStream stream(TEST_FILE_PATH_C("xing.mp3"));
+      FileRef f(&stream, 0, AudioProperties::Fast);
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT(!f.audioProperties());
+      CPPUNIT_ASSERT(!f.file()->readOnly());
+    }
+    {
+      FileStream stream(TEST_FILE_PATH_C("xing.mp3"));
+      FileRef f(&stream, 1, AudioProperties::Fast);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT(!f.file()->readOnly());
+    }
+    {
+      FileStream stream(TEST_FILE_PATH_C("xing.mp3"));
+      FileRef f(&stream, false, AudioProperties::Fast);
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT(!f.audioProperties());
+      CPPUNIT_ASSERT(!f.file()->readOnly());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFileRef);
@@ -33,18 +33,40 @@
 #include <xiphcomment.h>
 #include <id3v1tag.h>
 #include <id3v2tag.h>
+#include <tfilestream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
 using namespace std;
 using namespace TagLib;
 
+namespace
+{
+  class InsertRecordingStream : public FileStream
+  {
+  public:
+    InsertRecordingStream(FileName fileName) : FileStream(fileName), insertCount(0), insertStart(0) {}
+
+    virtual void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0)
+    {
+      if(insertCount++ == 0)
+        insertStart = start;
+      FileStream::insert(data, start, replace);
+    }
+
+    unsigned int insertCount;
+    unsigned long insertStart;
+  };
+}
+
 class TestFLAC : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestFLAC);
   CPPUNIT_TEST(testSignature);
   CPPUNIT_TEST(testMultipleCommentBlocks);
   CPPUNIT_TEST(testReadPicture);
+  CPPUNIT_TEST(testReadPictureHandles);
+  CPPUNIT_TEST(testPictureHandleLengthOverflow);
   CPPUNIT_TEST(testAddPicture);
   CPPUNIT_TEST(testReplacePicture);
   CPPUNIT_TEST(testRemoveAllPictures);
@@ -64,6 +86,9 @@ class TestFLAC : public CppUnit::TestFixture
   CPPUNIT_TEST(testStripTags);
   CPPUNIT_TEST(testRemoveXiphField);
   CPPUNIT_TEST(testEmptySeekTable);
+  CPPUNIT_TEST(testSaveInPlace);
+  CPPUNIT_TEST(testMoveUnparsedBlocks);
+  CPPUNIT_TEST(testTruncatedUnparsedBlock);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -113,6 +138,56 @@ public:
     CPPUNIT_ASSERT_EQUAL((unsigned int)150, pic->data().size());
   }
 
+  void testReadPictureHandles()
+  {
+    FLAC::File full(TEST_FILE_PATH_C("silence-44-s.flac"));
+    const PictureHandleList fullHandles = full.pictureHandles();
+    CPPUNIT_ASSERT_EQUAL(1U, fullHandles.size());
+    CPPUNIT_ASSERT_EQUAL(-1LL, fullHandles.front().offset());
+
+    FileStream stream(TEST_FILE_PATH_C("silence-44-s.flac"), true);
+    FLAC::File f(&stream, ID3v2::FrameFactory::instance(),
+                 TagLib::File::ReadTags | TagLib::File::ReadPictureHandles, FLAC::Properties::Average);
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT(f.pictureList().isEmpty());
+
+    const PictureHandleList handles = f.pictureHandles();
+    CPPUNIT_ASSERT_EQUAL(1U, handles.size());
+    const PictureHandle &picture = handles.front();
+    CPPUNIT_ASSERT(picture.offset() > 0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(FLAC::Picture::FrontCover), picture.type());
+    CPPUNIT_ASSERT_EQUAL(String("image/png"), picture.mimeType());
+    CPPUNIT_ASSERT_EQUAL(String("A pixel."), picture.description());
+    CPPUNIT_ASSERT_EQUAL(150U, picture.size());
+    CPPUNIT_ASSERT(picture.data() == full.pictureList().front()->data());
+    CPPUNIT_ASSERT(picture.data() == fullHandles.front().data());
+  }
+
+  void testPictureHandleLengthOverflow()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    string newname = copy.fileName();
+
+    {
+      // A MIME type length which wraps the position of the description
+      // length around to the picture type, so that the picture data length
+      // is taken from inside the description.
+
+      FileStream stream(newname.c_str());
+      const int mimeType = stream.readBlock(stream.length()).find("image/png");
+      CPPUNIT_ASSERT(mimeType > 0);
+      stream.seek(mimeType - 8);
+      stream.writeBlock(ByteVector::fromUInt(0U) + ByteVector::fromUInt(0xFFFFFFF8U) +
+                        ByteVector("image/png\0\0\0", 12) + ByteVector::fromUInt(5U));
+    }
+
+    FileStream stream(newname.c_str(), true);
+    FLAC::File f(&stream, ID3v2::FrameFactory::instance(),
+                 TagLib::File::ReadTags | TagLib::File::ReadPictureHandles, FLAC::Properties::Average);
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT(f.pictureHandles().isEmpty());
+  }
+
   void testAddPicture()
   {
     ScopedFileCopy copy("silence-44-s", ".flac");
@@ -535,6 +610,119 @@ public:
     }
   }
 
+  void testSaveInPlace()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    string newname = copy.fileName();
+
+    const ByteVector seekTable = readMetadataBlock(newname, FLAC::MetadataBlock::SeekTable);
+    const ByteVector cueSheet = readMetadataBlock(newname, FLAC::MetadataBlock::CueSheet);
+    CPPUNIT_ASSERT_EQUAL(108U, seekTable.size());
+    CPPUNIT_ASSERT_EQUAL(588U, cueSheet.size());
+
+    long long length = 0;
+    {
+      FLAC::File f(newname.c_str());
+      f.xiphComment()->setTitle("Title 1");
+      f.save();
+      length = f.length();
+    }
+    {
+      InsertRecordingStream stream(newname.c_str());
+      FLAC::File f(&stream, ID3v2::FrameFactory::instance());
+      f.xiphComment()->setTitle("Title 2");
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+      // The stream info, seek table, cue sheet and picture blocks are left
+      // as they are, and only the comment and the padding are written.
+
+      CPPUNIT_ASSERT_EQUAL(1U, stream.insertCount);
+      CPPUNIT_ASSERT_EQUAL(4UL + 38 + 112 + 592 + 203, stream.insertStart);
+    }
+    {
+      FLAC::File f(newname.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("Title 2"), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(1U, f.pictureList().size());
+    }
+    CPPUNIT_ASSERT_EQUAL(seekTable, readMetadataBlock(newname, FLAC::MetadataBlock::SeekTable));
+    CPPUNIT_ASSERT_EQUAL(cueSheet, readMetadataBlock(newname, FLAC::MetadataBlock::CueSheet));
+  }
+
+  void testMoveUnparsedBlocks()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    string newname = copy.fileName();
+
+    const ByteVector seekTable = readMetadataBlock(newname, FLAC::MetadataBlock::SeekTable);
+    const ByteVector cueSheet = readMetadataBlock(newname, FLAC::MetadataBlock::CueSheet);
+
+    {
+      // The second save shrinks the padding, so the blocks which were moved
+      // by the first save are read from where they are now.
+
+      FLAC::File f(newname.c_str());
+      f.ID3v2Tag(true)->setTitle("ID3v2 Title");
+      f.xiphComment()->setTitle(longText(8000));
+      f.save();
+      f.xiphComment()->setTitle("Title");
+      f.save();
+    }
+    {
+      FLAC::File f(newname.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.xiphComment()->title());
+      CPPUNIT_ASSERT_EQUAL(String("ID3v2 Title"), f.ID3v2Tag()->title());
+      CPPUNIT_ASSERT(f.length() < 50904 + 8000);
+    }
+    CPPUNIT_ASSERT_EQUAL(seekTable, readMetadataBlock(newname, FLAC::MetadataBlock::SeekTable));
+    CPPUNIT_ASSERT_EQUAL(cueSheet, readMetadataBlock(newname, FLAC::MetadataBlock::CueSheet));
+  }
+
+  void testTruncatedUnparsedBlock()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    string newname = copy.fileName();
+
+    {
+      // Make the seek table the last block, running past the end of the file.
+
+      FileStream stream(newname.c_str());
+      const ByteVector data = stream.readBlock(static_cast<unsigned long>(stream.length()));
+
+      unsigned int pos = data.find("fLaC") + 4;
+      while((data[pos] & 0x7F) != FLAC::MetadataBlock::SeekTable)
+        pos += 4 + data.toUInt(pos + 1, 3U);
+
+      stream.seek(pos);
+      stream.writeBlock(ByteVector("\x83\xFF\xFF\xF0", 4));
+    }
+    {
+      FLAC::File f(newname.c_str());
+      CPPUNIT_ASSERT(!f.isValid());
+    }
+  }
+
+private:
+  static ByteVector readMetadataBlock(const string &fileName, int code)
+  {
+    FileStream stream(fileName.c_str(), true);
+    const ByteVector data = stream.readBlock(static_cast<unsigned long>(stream.length()));
+
+    unsigned int pos = data.find("fLaC") + 4;
+    while(pos + 4 <= data.size()) {
+      const unsigned int length = data.toUInt(pos + 1, 3U);
+      if((data[pos] & 0x7F) == code)
+        return data.mid(pos + 4, length);
+      if(data[pos] & 0x80)
+        break;
+      pos += 4 + length;
+    }
+
+    return ByteVector();
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFLAC);
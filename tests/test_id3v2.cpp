@@ -45,6 +45,7 @@
 #include <tdebug.h>
 #include <tpropertymap.h>
 #include <tzlib.h>
+#include <tfilestream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -63,6 +64,15 @@ class PublicFrame : public ID3v2::Frame
     virtual ByteVector renderFields() const { return ByteVector(); }
 };
 
+class ReadCountingStream : public FileStream
+{
+  public:
+    ReadCountingStream(FileName fileName) : FileStream(fileName, true), readCount(0) {}
+    virtual ByteVector readBlock(unsigned long length)
+      { ++readCount; return FileStream::readBlock(length); }
+    unsigned int readCount;
+};
+
 class TestID3v2 : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestID3v2);
@@ -102,10 +112,16 @@ class TestID3v2 : public CppUnit::TestFixture
   CPPUNIT_TEST(testUpdateGenre23_1);
   CPPUNIT_TEST(testUpdateGenre23_2);
   CPPUNIT_TEST(testUpdateGenre24);
+  CPPUNIT_TEST(testUpdateFrameIDs22);
   CPPUNIT_TEST(testUpdateDate22);
   CPPUNIT_TEST(testDowngradeTo23);
   // CPPUNIT_TEST(testUpdateFullDate22); TODO TYE+TDA should be upgraded to TDRC together
   CPPUNIT_TEST(testCompressedFrameWithBrokenLength);
+  CPPUNIT_TEST(testDecompressSizeLimit);
+  CPPUNIT_TEST(testPictureHandles);
+  CPPUNIT_TEST(testFramesOnDemand);
+  CPPUNIT_TEST(testFramesOnDemandBeforeWrite);
+  CPPUNIT_TEST(testChapterIndex);
   CPPUNIT_TEST(testW000);
   CPPUNIT_TEST(testPropertyInterface);
   CPPUNIT_TEST(testPropertyInterface2);
@@ -120,6 +136,7 @@ class TestID3v2 : public CppUnit::TestFixture
   CPPUNIT_TEST(testEmptyFrame);
   CPPUNIT_TEST(testDuplicateTags);
   CPPUNIT_TEST(testParseTOCFrameWithManyChildren);
+  CPPUNIT_TEST(testKeyTranslation);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -694,6 +711,40 @@ public:
     CPPUNIT_ASSERT_EQUAL(String("Disco Eurodisco"), tag.genre());
   }
 
+  void testUpdateFrameIDs22()
+  {
+    // The first, the last and some of the nonstandard entries of the
+    // conversion table, and IDs which are not converted.
+
+    const char *const ids[][2] = {
+      { "BUF", "RBUF" }, { "WXX", "WXXX" }, { "MVN", "MVNM" },
+      { "TCT", "TCAT" }, { "WFD", "WFED" }, { "TZZ", "TZZ" }
+    };
+
+    ID3v2::FrameFactory *factory = ID3v2::FrameFactory::instance();
+    for(size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); ++i) {
+      ByteVector data(ids[i][0]);
+      data.append(ByteVector("\x00\x00\x05"  // Frame size
+                             "\x00"          // Encoding
+                             "Text", 8));
+      ID3v2::Frame *frame = factory->createFrame(data, 2U);
+      CPPUNIT_ASSERT(frame);
+      CPPUNIT_ASSERT_EQUAL(ByteVector(ids[i][1]), frame->frameID());
+      delete frame;
+    }
+
+    ByteVector data("MVN\x00\x00\x05\x00Text", 11);
+    ID3v2::Frame *frame = factory->createFrame(data, 2U);
+    CPPUNIT_ASSERT(dynamic_cast<ID3v2::TextIdentificationFrame *>(frame));
+    CPPUNIT_ASSERT_EQUAL(String("Text"), frame->toString());
+    delete frame;
+
+    ByteVector crm("CRM\x00\x00\x05\x00Text", 11);
+    frame = factory->createFrame(crm, 2U);
+    CPPUNIT_ASSERT(dynamic_cast<ID3v2::UnknownFrame *>(frame));
+    delete frame;
+  }
+
   void testUpdateGenre24()
   {
     ID3v2::FrameFactory *factory = ID3v2::FrameFactory::instance();
@@ -791,6 +842,276 @@ public:
 }
   }
 
+  void testDecompressSizeLimit()
+  {
+    if(!zlib::isAvailable())
+      return;
+
+    // The zlib stream of the APIC frame, after the tag header, the frame
+    // header and the data length indicator.
+
+    FileStream stream(TEST_FILE_PATH_C("compressed_id3_frame.mp3"), true);
+    const ByteVector data = stream.readAt(24, 4185);
+
+    CPPUNIT_ASSERT_EQUAL(86427U, zlib::decompress(data).size());
+    CPPUNIT_ASSERT_EQUAL(86427U, zlib::decompress(data, 155, 86427).size());
+    CPPUNIT_ASSERT_EQUAL(86427U, zlib::decompress(data, 100000, 100000).size());
+    CPPUNIT_ASSERT(zlib::decompress(data, 0, 86426).isEmpty());
+    CPPUNIT_ASSERT(zlib::decompress(data, 86427, 50000).isEmpty());
+    CPPUNIT_ASSERT(zlib::decompress(data.mid(0, 100), 86427, 86427).size() < 86427);
+
+    // A tiny frame whose data length indicator is far larger than its data
+    // can inflate to.
+
+    const ByteVector frameData(
+      "TIT2\x00\x00\x00\x15\x00\x09\x7F\x7F\x7F\x7F"
+      "\x78\x01\x01\x06\x00\xF9\xFF\x03\x54\x69\x74\x6C\x65\x05\xF9\x02\x06", 31);
+
+    ID3v2::Frame *frame = ID3v2::FrameFactory::instance()->createFrame(frameData, 4U);
+    CPPUNIT_ASSERT(dynamic_cast<ID3v2::TextIdentificationFrame *>(frame));
+    CPPUNIT_ASSERT_EQUAL(String("Title"), frame->toString());
+    delete frame;
+
+    CPPUNIT_ASSERT_EQUAL(ByteVector("\x03Title", 6),
+                         zlib::decompress(frameData.mid(14), 0x0FFFFFFF, 0x10000000));
+  }
+
+  void testPictureHandles()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    string newname = copy.fileName();
+
+    {
+      MPEG::File f(newname.c_str());
+      f.ID3v2Tag(true)->setTitle("Title");
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setTextEncoding(String::UTF16);
+      frame->setMimeType("image/png");
+      frame->setType(ID3v2::AttachedPictureFrame::BackCover);
+      frame->setDescription("Description");
+      frame->setPicture(ByteVector(5000, 'x'));
+      f.ID3v2Tag()->addFrame(frame);
+      f.save();
+    }
+    {
+      FileStream stream(newname.c_str(), true);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(),
+                   TagLib::File::ReadBasicTags | TagLib::File::ReadPictureHandles,
+                   MPEG::Properties::Average);
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+      CPPUNIT_ASSERT(!f.ID3v2Tag()->frameListMap().contains("APIC"));
+
+      const PictureHandleList handles = f.pictureHandles();
+      CPPUNIT_ASSERT_EQUAL(1U, handles.size());
+      CPPUNIT_ASSERT(handles[0].offset() > 0);
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), handles[0].mimeType());
+      CPPUNIT_ASSERT_EQUAL(static_cast<int>(ID3v2::AttachedPictureFrame::BackCover), handles[0].type());
+      CPPUNIT_ASSERT_EQUAL(String("Description"), handles[0].description());
+      CPPUNIT_ASSERT_EQUAL(5000U, handles[0].size());
+      CPPUNIT_ASSERT(handles[0].data() == ByteVector(5000, 'x'));
+    }
+    if(zlib::isAvailable()) {
+      // A compressed picture is read along with the tag.
+
+      FileStream stream(TEST_FILE_PATH_C("compressed_id3_frame.mp3"), true);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(),
+                   TagLib::File::ReadPictureHandles, MPEG::Properties::Average);
+      const PictureHandleList handles = f.pictureHandles();
+      CPPUNIT_ASSERT_EQUAL(1U, handles.size());
+      CPPUNIT_ASSERT_EQUAL(-1LL, handles[0].offset());
+      CPPUNIT_ASSERT_EQUAL(String("image/bmp"), handles[0].mimeType());
+      CPPUNIT_ASSERT_EQUAL(86414U, handles[0].data().size());
+    }
+  }
+
+  void testFramesOnDemand()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    string newname = copy.fileName();
+
+    {
+      MPEG::File f(newname.c_str());
+      f.ID3v2Tag(true)->setTitle("Title");
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setMimeType("image/png");
+      frame->setPicture(ByteVector(5000, 'x'));
+      f.ID3v2Tag()->addFrame(frame);
+      f.ID3v2Tag()->setAlbum("Album");
+      f.save();
+    }
+    unsigned long long eagerBytes = 0;
+    {
+      FileStream stream(newname.c_str(), true);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true);
+      CPPUNIT_ASSERT_EQUAL(0U, f.ID3v2Tag()->pendingFrameCount());
+      eagerBytes = f.ID3v2Tag()->parsedFrameBytes();
+    }
+    {
+      FileStream stream(newname.c_str(), true);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(),
+                   TagLib::File::ReadEverything | TagLib::File::ReadFramesOnDemand,
+                   MPEG::Properties::Average);
+      ID3v2::Tag *tag = f.ID3v2Tag();
+      CPPUNIT_ASSERT_EQUAL(String("Title"), tag->title());
+      CPPUNIT_ASSERT_EQUAL(String("Album"), tag->album());
+      CPPUNIT_ASSERT_EQUAL(1U, tag->pendingFrameCount());
+      CPPUNIT_ASSERT(tag->parsedFrameBytes() < 100);
+      CPPUNIT_ASSERT_EQUAL(1U, tag->frameList("TIT2").size());
+      CPPUNIT_ASSERT_EQUAL(1U, tag->pendingFrameCount());
+
+      const ID3v2::FrameList pictures = tag->frameList("APIC");
+      CPPUNIT_ASSERT_EQUAL(0U, tag->pendingFrameCount());
+      CPPUNIT_ASSERT_EQUAL(eagerBytes, tag->parsedFrameBytes());
+      CPPUNIT_ASSERT_EQUAL(1U, pictures.size());
+      ID3v2::AttachedPictureFrame *frame =
+        dynamic_cast<ID3v2::AttachedPictureFrame *>(pictures.front());
+      CPPUNIT_ASSERT(frame);
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), frame->mimeType());
+      CPPUNIT_ASSERT(frame->picture() == ByteVector(5000, 'x'));
+
+      // The picture keeps its place between the title and the album.
+      CPPUNIT_ASSERT_EQUAL(3U, tag->frameList().size());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("APIC"), tag->frameList()[1]->frameID());
+    }
+    {
+      FileStream stream(newname.c_str());
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(),
+                   TagLib::File::ReadEverything | TagLib::File::ReadFramesOnDemand,
+                   MPEG::Properties::Average);
+      CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->pendingFrameCount());
+      CPPUNIT_ASSERT(!f.ID3v2Tag()->isEmpty());
+      f.ID3v2Tag()->setTitle("A much longer title, which moves the frames");
+      f.save();
+    }
+    {
+      MPEG::File f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("A much longer title, which moves the frames"),
+                           f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->frameList("APIC").size());
+      ID3v2::AttachedPictureFrame *frame = dynamic_cast<ID3v2::AttachedPictureFrame *>(
+        f.ID3v2Tag()->frameList("APIC").front());
+      CPPUNIT_ASSERT(frame);
+      CPPUNIT_ASSERT(frame->picture() == ByteVector(5000, 'x'));
+    }
+  }
+
+  void testFramesOnDemandBeforeWrite()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    string newname = copy.fileName();
+
+    {
+      MPEG::File f(newname.c_str());
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setMimeType("image/png");
+      frame->setPicture(ByteVector(5000, 'x'));
+      f.ID3v2Tag(true)->addFrame(frame);
+      f.save();
+    }
+    {
+      // The pending frames are parsed before the file is changed under them,
+      // whatever changes it.
+
+      FileStream stream(newname.c_str());
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(),
+                   TagLib::File::ReadEverything | TagLib::File::ReadFramesOnDemand,
+                   MPEG::Properties::Average);
+      CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->pendingFrameCount());
+
+      f.insert(ByteVector(100, 'y'), 0, 0);
+      CPPUNIT_ASSERT_EQUAL(0U, f.ID3v2Tag()->pendingFrameCount());
+
+      const ID3v2::FrameList pictures = f.ID3v2Tag()->frameList("APIC");
+      CPPUNIT_ASSERT_EQUAL(1U, pictures.size());
+      ID3v2::AttachedPictureFrame *frame =
+        dynamic_cast<ID3v2::AttachedPictureFrame *>(pictures.front());
+      CPPUNIT_ASSERT(frame);
+      CPPUNIT_ASSERT(frame->picture() == ByteVector(5000, 'x'));
+    }
+  }
+
+  void testChapterIndex()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    string newname = copy.fileName();
+
+    {
+      MPEG::File f(newname.c_str());
+      ID3v2::FrameList embeddedFrames;
+      ID3v2::TextIdentificationFrame *title =
+        new ID3v2::TextIdentificationFrame("TIT2", String::Latin1);
+      title->setText("Second");
+      embeddedFrames.append(title);
+
+      f.ID3v2Tag(true)->setTitle("Title");
+      f.ID3v2Tag()->addFrame(new ID3v2::ChapterFrame("C3", 5000, 9000, 0xFFFFFFFF, 0xFFFFFFFF));
+      f.ID3v2Tag()->addFrame(new ID3v2::ChapterFrame("C1", 0, 1000, 0xFFFFFFFF, 0xFFFFFFFF));
+      f.ID3v2Tag()->addFrame(new ID3v2::ChapterFrame("C2", 1000, 3000, 0xFFFFFFFF, 0xFFFFFFFF,
+                                                     embeddedFrames));
+      f.save();
+    }
+    {
+      ReadCountingStream stream(newname.c_str());
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(),
+                   TagLib::File::ReadEverything | TagLib::File::ReadFramesOnDemand,
+                   MPEG::Properties::Average);
+      ID3v2::Tag *tag = f.ID3v2Tag();
+      CPPUNIT_ASSERT_EQUAL(3U, tag->pendingFrameCount());
+
+      // The index is made from what was read with the tag.
+      const unsigned int readCount = stream.readCount;
+      const ID3v2::ChapterIndex index = tag->chapterIndex();
+      CPPUNIT_ASSERT_EQUAL(readCount, stream.readCount);
+      CPPUNIT_ASSERT_EQUAL(3U, tag->pendingFrameCount());
+      CPPUNIT_ASSERT_EQUAL(3U, index.size());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("C1"), index[0].elementID);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("C2"), index[1].elementID);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("C3"), index[2].elementID);
+      CPPUNIT_ASSERT_EQUAL(1000U, index[1].startTime);
+      CPPUNIT_ASSERT_EQUAL(3000U, index[1].endTime);
+      CPPUNIT_ASSERT_EQUAL(0xFFFFFFFFU, index[1].startOffset);
+
+      CPPUNIT_ASSERT_EQUAL(0, index.chapterAt(0));
+      CPPUNIT_ASSERT_EQUAL(1, index.chapterAt(1000));
+      CPPUNIT_ASSERT_EQUAL(1, index.chapterAt(2999));
+      CPPUNIT_ASSERT_EQUAL(-1, index.chapterAt(4000));
+      CPPUNIT_ASSERT_EQUAL(2, index.chapterAt(8999));
+      CPPUNIT_ASSERT_EQUAL(-1, index.chapterAt(9000));
+      CPPUNIT_ASSERT_EQUAL(2, index.find("C3"));
+      CPPUNIT_ASSERT_EQUAL(-1, index.find("C4"));
+
+      ID3v2::ChapterFrame *chapter = tag->chapterFrame("C2");
+      CPPUNIT_ASSERT(chapter);
+      CPPUNIT_ASSERT_EQUAL(2U, tag->pendingFrameCount());
+      CPPUNIT_ASSERT_EQUAL(1U, chapter->embeddedFrameList("TIT2").size());
+      CPPUNIT_ASSERT_EQUAL(String("Second"), chapter->embeddedFrameList("TIT2").front()->toString());
+      CPPUNIT_ASSERT(!tag->chapterFrame("C4"));
+
+      // The parsed chapter is still in the index.
+      CPPUNIT_ASSERT_EQUAL(3U, tag->chapterIndex().size());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("C2"), tag->chapterIndex()[1].elementID);
+
+      // ...and follows the CHAP frames which are added and removed.
+      tag->addFrame(new ID3v2::ChapterFrame("C4", 3000, 4000, 0xFFFFFFFF, 0xFFFFFFFF));
+      CPPUNIT_ASSERT_EQUAL(4U, tag->chapterIndex().size());
+      CPPUNIT_ASSERT_EQUAL(2, tag->chapterIndex().chapterAt(3500));
+      CPPUNIT_ASSERT(tag->chapterFrame("C4"));
+      tag->removeFrame(tag->chapterFrame("C1"));
+      CPPUNIT_ASSERT_EQUAL(3U, tag->chapterIndex().size());
+      CPPUNIT_ASSERT_EQUAL(-1, tag->chapterIndex().find("C1"));
+      CPPUNIT_ASSERT(!tag->chapterFrame("C1"));
+    }
+    {
+      MPEG::File f(newname.c_str());
+      const ID3v2::ChapterIndex index = f.ID3v2Tag()->chapterIndex();
+      CPPUNIT_ASSERT_EQUAL(3U, index.size());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("C1"), index[0].elementID);
+      CPPUNIT_ASSERT_EQUAL(2, index.chapterAt(5000));
+      CPPUNIT_ASSERT_EQUAL(String("Second"), f.ID3v2Tag()->chapterFrame("C2")->
+                           embeddedFrameList("TIT2").front()->toString());
+    }
+  }
+
   void testCompressedFrameWithBrokenLength()
   {
     MPEG::File f(TEST_FILE_PATH_C("compressed_id3_frame.mp3"), false);
@@ -1269,6 +1590,41 @@ public:
     CPPUNIT_ASSERT(f.isValid());
   }
 
+  void testKeyTranslation()
+  {
+    ID3v2::Tag tag;
+    PropertyMap props;
+    props["title"] = StringList("Title");
+    props["AlbumArtistSort"] = StringList("Sort");
+    props["MovementNumber"] = StringList("2");
+    props["acoustid_id"] = StringList("Id");
+    props["REPLAYGAIN_TRACK_GAIN"] = StringList("-1 dB");
+    tag.setProperties(props);
+
+    CPPUNIT_ASSERT_EQUAL(1U, tag.frameList("TIT2").size());
+    CPPUNIT_ASSERT_EQUAL(1U, tag.frameList("TSO2").size());
+    CPPUNIT_ASSERT_EQUAL(1U, tag.frameList("MVIN").size());
+    CPPUNIT_ASSERT_EQUAL(2U, tag.frameList("TXXX").size());
+
+    ID3v2::TextIdentificationFrame *tyer = new ID3v2::TextIdentificationFrame("TYER");
+    tyer->setText("2026");
+    tag.addFrame(tyer);
+    ID3v2::UserTextIdentificationFrame *txxx = new ID3v2::UserTextIdentificationFrame();
+    txxx->setDescription("MusicBrainz Album Id");
+    txxx->setText("Album");
+    tag.addFrame(txxx);
+
+    const PropertyMap result = tag.properties();
+    CPPUNIT_ASSERT_EQUAL(StringList("Title"), result["TITLE"]);
+    CPPUNIT_ASSERT_EQUAL(StringList("Sort"), result["ALBUMARTISTSORT"]);
+    CPPUNIT_ASSERT_EQUAL(StringList("2"), result["MOVEMENTNUMBER"]);
+    CPPUNIT_ASSERT_EQUAL(StringList("Id"), result["ACOUSTID_ID"]);
+    CPPUNIT_ASSERT_EQUAL(StringList("-1 dB"), result["REPLAYGAIN_TRACK_GAIN"]);
+    CPPUNIT_ASSERT_EQUAL(StringList("2026"), result["DATE"]);
+    CPPUNIT_ASSERT_EQUAL(StringList("Album"), result["MUSICBRAINZ_ALBUMID"]);
+    CPPUNIT_ASSERT(result.unsupportedData().isEmpty());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestID3v2);
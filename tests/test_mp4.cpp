@@ -31,6 +31,7 @@
 #include <tpropertymap.h>
 #include <mp4atom.h>
 #include <mp4file.h>
+#include <tfilestream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -52,6 +53,7 @@ class TestMP4 : public CppUnit::TestFixture
   CPPUNIT_TEST(test64BitAtom);
   CPPUNIT_TEST(testGnre);
   CPPUNIT_TEST(testCovrRead);
+  CPPUNIT_TEST(testCovrHandles);
   CPPUNIT_TEST(testCovrWrite);
   CPPUNIT_TEST(testCovrRead2);
   CPPUNIT_TEST(testProperties);
@@ -284,6 +286,28 @@ public:
     CPPUNIT_ASSERT_EQUAL((unsigned int)287, l[1].data().size());
   }
 
+  void testCovrHandles()
+  {
+    FileStream stream(TEST_FILE_PATH_C("has-tags.m4a"), true);
+    MP4::File f(&stream, TagLib::File::ReadTags | TagLib::File::ReadPictureHandles,
+                MP4::Properties::Average);
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT(!f.tag()->contains("covr"));
+
+    const PictureHandleList handles = f.pictureHandles();
+    CPPUNIT_ASSERT_EQUAL(2U, handles.size());
+    CPPUNIT_ASSERT_EQUAL(String("image/png"), handles[0].mimeType());
+    CPPUNIT_ASSERT_EQUAL(79U, handles[0].size());
+    CPPUNIT_ASSERT_EQUAL(String("image/jpeg"), handles[1].mimeType());
+    CPPUNIT_ASSERT_EQUAL(287U, handles[1].size());
+
+    MP4::File full(TEST_FILE_PATH_C("has-tags.m4a"));
+    const MP4::CoverArtList covr = full.tag()->item("covr").toCoverArtList();
+    CPPUNIT_ASSERT(handles[0].data() == covr[0].data());
+    CPPUNIT_ASSERT(handles[1].data() == covr[1].data());
+    CPPUNIT_ASSERT_EQUAL(2U, full.pictureHandles().size());
+  }
+
   void testCovrWrite()
   {
     ScopedFileCopy copy("has-tags", ".m4a");
@@ -34,6 +34,7 @@
 #include <mpegproperties.h>
 #include <xingheader.h>
 #include <mpegheader.h>
+#include <tbytevectorstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -47,6 +48,13 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testAudioPropertiesXingHeaderVBR);
   CPPUNIT_TEST(testAudioPropertiesVBRIHeader);
   CPPUNIT_TEST(testAudioPropertiesNoVBRHeaders);
+  CPPUNIT_TEST(testAudioPropertiesReadStyles);
+  CPPUNIT_TEST(testAudioPropertiesVBRNoHeaderAccurate);
+  CPPUNIT_TEST(testAudioPropertiesVBRNoHeaderLongStream);
+  CPPUNIT_TEST(testHeaderFromData);
+  CPPUNIT_TEST(testXingSeekPoints);
+  CPPUNIT_TEST(testVBRISeekPoints);
+  CPPUNIT_TEST(testNoSeekPoints);
   CPPUNIT_TEST(testSkipInvalidFrames1);
   CPPUNIT_TEST(testSkipInvalidFrames2);
   CPPUNIT_TEST(testSkipInvalidFrames3);
@@ -127,6 +135,150 @@ public:
     CPPUNIT_ASSERT_EQUAL(209, lastHeader.frameLength());
   }
 
+  void testAudioPropertiesReadStyles()
+  {
+    {
+      MPEG::File f(TEST_FILE_PATH_C("bladeenc.mp3"), true, AudioProperties::Fast);
+      CPPUNIT_ASSERT_EQUAL(3553, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(64, f.audioProperties()->bitrate());
+    }
+    {
+      MPEG::File f(TEST_FILE_PATH_C("bladeenc.mp3"), true, AudioProperties::Accurate);
+      CPPUNIT_ASSERT_EQUAL(3553, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(64, f.audioProperties()->bitrate());
+    }
+    {
+      MPEG::File f(TEST_FILE_PATH_C("ape-id3v1.mp3"), true, AudioProperties::Fast);
+      CPPUNIT_ASSERT_EQUAL(2052, f.audioProperties()->lengthInMilliseconds());
+    }
+    {
+      MPEG::File f(TEST_FILE_PATH_C("ape-id3v1.mp3"), true, AudioProperties::Accurate);
+      CPPUNIT_ASSERT_EQUAL(2064, f.audioProperties()->lengthInMilliseconds());
+    }
+  }
+
+  void testAudioPropertiesVBRNoHeaderAccurate()
+  {
+    // Ten 128 kbit/s frames followed by ten 320 kbit/s frames, mono 44.1 kHz.
+
+    ByteVector data;
+    for(int i = 0; i < 20; ++i) {
+      ByteVector frame(i < 10 ? 417 : 1044, '\0');
+      frame[0] = '\xFF';
+      frame[1] = '\xFB';
+      frame[2] = i < 10 ? '\x90' : '\xE0';
+      frame[3] = '\xC0';
+      data.append(frame);
+    }
+
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, AudioProperties::Average);
+      CPPUNIT_ASSERT_EQUAL(913, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(128, f.audioProperties()->bitrate());
+    }
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, AudioProperties::Accurate);
+      CPPUNIT_ASSERT_EQUAL(522, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(224, f.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(1, f.audioProperties()->channels());
+    }
+  }
+
+  void testAudioPropertiesVBRNoHeaderLongStream()
+  {
+    // 3000 frames alternating between 128 and 320 kbit/s, which span several
+    // of the windows the frames are counted in, followed by an ID3v1 tag.
+
+    ByteVector data;
+    for(int i = 0; i < 3000; ++i) {
+      ByteVector frame(i % 2 ? 1044 : 417, '\0');
+      frame[0] = '\xFF';
+      frame[1] = '\xFB';
+      frame[2] = i % 2 ? '\xE0' : '\x90';
+      frame[3] = '\xC0';
+      data.append(frame);
+    }
+    data.append(ByteVector("TAG"));
+    data.append(ByteVector(125, '\0'));
+
+    ByteVectorStream stream(data);
+    MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, AudioProperties::Accurate);
+    CPPUNIT_ASSERT(f.hasID3v1Tag());
+    CPPUNIT_ASSERT_EQUAL(78367, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(224, f.audioProperties()->bitrate());
+  }
+
+  void testHeaderFromData()
+  {
+    const MPEG::Header header(ByteVector("\xFF\xFB\x92\xC0", 4));
+    CPPUNIT_ASSERT(header.isValid());
+    CPPUNIT_ASSERT_EQUAL(128, header.bitrate());
+    CPPUNIT_ASSERT_EQUAL(44100, header.sampleRate());
+    CPPUNIT_ASSERT(header.isPadded());
+    CPPUNIT_ASSERT_EQUAL(418, header.frameLength());
+
+    CPPUNIT_ASSERT(!MPEG::Header(ByteVector("\xFF\xFB\xF0\xC0", 4)).isValid());
+    CPPUNIT_ASSERT(!MPEG::Header(ByteVector("TAG", 3)).isValid());
+  }
+
+  void testXingSeekPoints()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("lame_vbr.mp3"));
+    const MPEG::Properties *properties = f.audioProperties();
+    const MPEG::XingHeader *xingHeader = properties->xingHeader();
+    CPPUNIT_ASSERT_EQUAL(100U, xingHeader->tableOfContents().size());
+    CPPUNIT_ASSERT(xingHeader->vbriTable().isEmpty());
+
+    CPPUNIT_ASSERT(xingHeader->hasLameHeader());
+    CPPUNIT_ASSERT_EQUAL(String("LAME3.99r"), xingHeader->encoder());
+    CPPUNIT_ASSERT_EQUAL(576, properties->encoderDelay());
+    CPPUNIT_ASSERT_EQUAL(576, properties->encoderPadding());
+
+    const MPEG::Properties::SeekPointList points = properties->seekPoints();
+    CPPUNIT_ASSERT_EQUAL(100U, points.size());
+    CPPUNIT_ASSERT_EQUAL(0, points[0].time);
+    CPPUNIT_ASSERT_EQUAL(1876LL, points[0].offset);
+    CPPUNIT_ASSERT_EQUAL(18872, points[1].time);
+    CPPUNIT_ASSERT_EQUAL(131396LL, points[1].offset);
+
+    CPPUNIT_ASSERT_EQUAL(1876LL, properties->seekOffset(0));
+    CPPUNIT_ASSERT_EQUAL(131396LL, properties->seekOffset(18872));
+    CPPUNIT_ASSERT_EQUAL(1876LL + 16578604LL, properties->seekOffset(1887164));
+    CPPUNIT_ASSERT_EQUAL(-1LL, properties->seekOffset(1887165));
+    CPPUNIT_ASSERT_EQUAL(-1LL, properties->seekOffset(-1));
+  }
+
+  void testVBRISeekPoints()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("rare_frames.mp3"));
+    const MPEG::Properties *properties = f.audioProperties();
+    const MPEG::XingHeader *xingHeader = properties->xingHeader();
+    CPPUNIT_ASSERT(xingHeader->tableOfContents().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(132U, xingHeader->vbriTable().size());
+    CPPUNIT_ASSERT_EQUAL(64U, xingHeader->vbriFramesPerEntry());
+    CPPUNIT_ASSERT(!xingHeader->hasLameHeader());
+    CPPUNIT_ASSERT_EQUAL(0, properties->encoderDelay());
+
+    const MPEG::Properties::SeekPointList points = properties->seekPoints();
+    CPPUNIT_ASSERT_EQUAL(133U, points.size());
+    CPPUNIT_ASSERT_EQUAL(0, points[0].time);
+    CPPUNIT_ASSERT_EQUAL(1529LL, points[0].offset);
+    CPPUNIT_ASSERT_EQUAL(1672, points[1].time);
+    CPPUNIT_ASSERT_EQUAL(40618LL, points[1].offset);
+    CPPUNIT_ASSERT_EQUAL((1529LL + 40618LL) / 2, properties->seekOffset(836));
+  }
+
+  void testNoSeekPoints()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("bladeenc.mp3"));
+    const MPEG::Properties *properties = f.audioProperties();
+    CPPUNIT_ASSERT(properties->seekPoints().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0LL, properties->seekOffset(0));
+    CPPUNIT_ASSERT_EQUAL(28422LL, properties->seekOffset(3553));
+  }
+
   void testSkipInvalidFrames1()
   {
     MPEG::File f(TEST_FILE_PATH_C("invalid-frames1.mp3"));
@@ -31,6 +31,7 @@
 #include <tpropertymap.h>
 #include <oggfile.h>
 #include <vorbisfile.h>
+#include <oggpage.h>
 #include <oggpageheader.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -44,10 +45,13 @@ class TestOGG : public CppUnit::TestFixture
   CPPUNIT_TEST(testSimple);
   CPPUNIT_TEST(testSplitPackets1);
   CPPUNIT_TEST(testSplitPackets2);
+  CPPUNIT_TEST(testPaddedCommentPacket);
   CPPUNIT_TEST(testDictInterface1);
   CPPUNIT_TEST(testDictInterface2);
   CPPUNIT_TEST(testAudioProperties);
   CPPUNIT_TEST(testPageChecksum);
+  CPPUNIT_TEST(testLastPageOfMultiplexedStream);
+  CPPUNIT_TEST(testLastPageOfChainedStream);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -83,10 +87,10 @@ public:
     {
       Vorbis::File f(newname.c_str());
       CPPUNIT_ASSERT(f.isValid());
-      CPPUNIT_ASSERT_EQUAL(136383LL, f.length());
+      CPPUNIT_ASSERT_EQUAL(136897LL, f.length());
       CPPUNIT_ASSERT_EQUAL(19, f.lastPageHeader()->pageSequenceNumber());
       CPPUNIT_ASSERT_EQUAL(30U, f.packet(0).size());
-      CPPUNIT_ASSERT_EQUAL(131127U, f.packet(1).size());
+      CPPUNIT_ASSERT_EQUAL(131639U, f.packet(1).size());
       CPPUNIT_ASSERT_EQUAL(3832U, f.packet(2).size());
       CPPUNIT_ASSERT_EQUAL(text, f.tag()->title());
 
@@ -99,10 +103,10 @@ public:
     {
       Vorbis::File f(newname.c_str());
       CPPUNIT_ASSERT(f.isValid());
-      CPPUNIT_ASSERT_EQUAL(4370LL, f.length());
+      CPPUNIT_ASSERT_EQUAL(5056LL, f.length());
       CPPUNIT_ASSERT_EQUAL(3, f.lastPageHeader()->pageSequenceNumber());
       CPPUNIT_ASSERT_EQUAL(30U, f.packet(0).size());
-      CPPUNIT_ASSERT_EQUAL(60U, f.packet(1).size());
+      CPPUNIT_ASSERT_EQUAL(744U, f.packet(1).size());
       CPPUNIT_ASSERT_EQUAL(3832U, f.packet(2).size());
       CPPUNIT_ASSERT_EQUAL(String("ABCDE"), f.tag()->title());
 
@@ -138,6 +142,48 @@ public:
     }
   }
 
+  void testPaddedCommentPacket()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    string newname = copy.fileName();
+
+    long long length = 0;
+    unsigned int packetSize = 0;
+    int lastPage = 0;
+    {
+      // The file has to be rewritten, and the comment packet is given some
+      // padding.
+
+      Vorbis::File f(newname.c_str());
+      f.tag()->setTitle(longText(600));
+      f.save();
+      length = f.length();
+      packetSize = f.packet(1).size();
+      lastPage = f.lastPageHeader()->pageSequenceNumber();
+      CPPUNIT_ASSERT(packetSize > 600 + 500);
+    }
+    {
+      // The padding takes a longer title, and then a shorter one.
+
+      Vorbis::File f(newname.c_str());
+      f.tag()->setTitle(longText(800));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+      f.tag()->setTitle(longText(400));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+    }
+    {
+      Vorbis::File f(newname.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(longText(400), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(packetSize, f.packet(1).size());
+      CPPUNIT_ASSERT_EQUAL(lastPage, f.lastPageHeader()->pageSequenceNumber());
+      CPPUNIT_ASSERT_EQUAL(3685, f.audioProperties()->lengthInMilliseconds());
+    }
+  }
+
   void testDictInterface1()
   {
     ScopedFileCopy copy("empty", ".ogg");
@@ -210,7 +256,7 @@ public:
       f.save();
 
       f.seek(0x50);
-      CPPUNIT_ASSERT_EQUAL((unsigned int)0x3d3bd92d, f.readBlock(4).toUInt(0, true));
+      CPPUNIT_ASSERT_EQUAL((unsigned int)0xf0d2c23e, f.readBlock(4).toUInt(0, true));
     }
     {
       Vorbis::File f(copy.fileName().c_str());
@@ -218,11 +264,80 @@ public:
       f.save();
 
       f.seek(0x50);
-      CPPUNIT_ASSERT_EQUAL((unsigned int)0xd985291c, f.readBlock(4).toUInt(0, true));
+      CPPUNIT_ASSERT_EQUAL((unsigned int)0x6e8559aa, f.readBlock(4).toUInt(0, true));
     }
 
   }
 
+  void testLastPageOfMultiplexedStream()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    string newname = copy.fileName();
+
+    unsigned int serial = 0;
+    {
+      Vorbis::File f(newname.c_str());
+      serial = f.firstPageHeader()->streamSerialNumber();
+
+      // A page of another stream, and one of this stream with a wrong
+      // checksum, both with no granule position.
+
+      f.seek(0, File::End);
+      f.writeBlock(renderPages(ByteVector(100, 'x'), serial + 1, Ogg::Page::SinglePagePerGroup));
+
+      ByteVector broken = renderPages(ByteVector(100, 'x'), serial, Ogg::Page::SinglePagePerGroup);
+      broken[broken.size() - 1] = 'y';
+      f.writeBlock(broken);
+    }
+    {
+      Vorbis::File f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(serial, f.lastPageHeader()->streamSerialNumber());
+      CPPUNIT_ASSERT_EQUAL(2, f.lastPageHeader()->pageSequenceNumber());
+      CPPUNIT_ASSERT_EQUAL(3685, f.audioProperties()->lengthInMilliseconds());
+    }
+  }
+
+  void testLastPageOfChainedStream()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    string newname = copy.fileName();
+
+    unsigned int serial = 0;
+    {
+      Vorbis::File f(newname.c_str());
+      serial = f.firstPageHeader()->streamSerialNumber();
+
+      // A chained stream much longer than the tail which is searched.
+
+      f.seek(0, File::End);
+      f.writeBlock(renderPages(ByteVector(1024 * 1024, 'x'), serial + 1, Ogg::Page::Repaginate));
+      CPPUNIT_ASSERT(f.length() > 1024 * 1024);
+    }
+    {
+      Vorbis::File f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(serial, f.lastPageHeader()->streamSerialNumber());
+      CPPUNIT_ASSERT_EQUAL(2, f.lastPageHeader()->pageSequenceNumber());
+      CPPUNIT_ASSERT_EQUAL(3685, f.audioProperties()->lengthInMilliseconds());
+    }
+  }
+
+private:
+  static ByteVector renderPages(const ByteVector &packet, unsigned int serial,
+                                Ogg::Page::PaginationStrategy strategy)
+  {
+    ByteVectorList packets;
+    packets.append(packet);
+
+    List<Ogg::Page *> pages
+      = Ogg::Page::paginate(packets, strategy, serial, 0, false, true, true);
+    pages.setAutoDelete(true);
+
+    ByteVector data;
+    for(List<Ogg::Page *>::ConstIterator it = pages.begin(); it != pages.end(); ++it)
+      data.append((*it)->render());
+    return data;
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOGG);
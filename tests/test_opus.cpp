@@ -42,6 +42,7 @@ class TestOpus : public CppUnit::TestFixture
   CPPUNIT_TEST(testReadComments);
   CPPUNIT_TEST(testWriteComments);
   CPPUNIT_TEST(testSplitPackets);
+  CPPUNIT_TEST(testPaddedCommentPacket);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -103,10 +104,10 @@ public:
     {
       Ogg::Opus::File f(newname.c_str());
       CPPUNIT_ASSERT(f.isValid());
-      CPPUNIT_ASSERT_EQUAL(167534LL, f.length());
+      CPPUNIT_ASSERT_EQUAL(168048LL, f.length());
       CPPUNIT_ASSERT_EQUAL(27, f.lastPageHeader()->pageSequenceNumber());
       CPPUNIT_ASSERT_EQUAL(19U, f.packet(0).size());
-      CPPUNIT_ASSERT_EQUAL(131380U, f.packet(1).size());
+      CPPUNIT_ASSERT_EQUAL(131892U, f.packet(1).size());
       CPPUNIT_ASSERT_EQUAL(5U, f.packet(2).size());
       CPPUNIT_ASSERT_EQUAL(5U, f.packet(3).size());
       CPPUNIT_ASSERT_EQUAL(text, f.tag()->title());
@@ -120,10 +121,10 @@ public:
     {
       Ogg::Opus::File f(newname.c_str());
       CPPUNIT_ASSERT(f.isValid());
-      CPPUNIT_ASSERT_EQUAL(35521LL, f.length());
+      CPPUNIT_ASSERT_EQUAL(36364LL, f.length());
       CPPUNIT_ASSERT_EQUAL(11, f.lastPageHeader()->pageSequenceNumber());
       CPPUNIT_ASSERT_EQUAL(19U, f.packet(0).size());
-      CPPUNIT_ASSERT_EQUAL(313U, f.packet(1).size());
+      CPPUNIT_ASSERT_EQUAL(1153U, f.packet(1).size());
       CPPUNIT_ASSERT_EQUAL(5U, f.packet(2).size());
       CPPUNIT_ASSERT_EQUAL(5U, f.packet(3).size());
       CPPUNIT_ASSERT_EQUAL(String("ABCDE"), f.tag()->title());
@@ -133,6 +134,31 @@ public:
     }
   }
 
+
+  void testPaddedCommentPacket()
+  {
+    ScopedFileCopy copy("correctness_gain_silent_output", ".opus");
+    string newname = copy.fileName();
+
+    long long length = 0;
+    {
+      Ogg::Opus::File f(newname.c_str());
+      length = f.length();
+      f.tag()->removeFields("TESTDESCRIPTION");
+      f.tag()->setTitle("ABCDE");
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+    }
+    {
+      Ogg::Opus::File f(newname.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("ABCDE"), f.tag()->title());
+      CPPUNIT_ASSERT(!f.tag()->contains("TESTDESCRIPTION"));
+      CPPUNIT_ASSERT_EQUAL(298U, f.packet(1).size());
+      CPPUNIT_ASSERT_EQUAL(7737, f.audioProperties()->lengthInMilliseconds());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOpus);
@@ -0,0 +1,197 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <tfilestream.h>
+#include <tprefetchedfilestream.h>
+#include <tpropertymap.h>
+#include <fileref.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  StringList testFiles()
+  {
+    StringList paths;
+    paths.append(TEST_FILE_PATH_C("silence-44-s.flac"));
+    paths.append(TEST_FILE_PATH_C("no-such-file.mp3"));
+    paths.append(TEST_FILE_PATH_C("has-tags.m4a"));
+    paths.append(TEST_FILE_PATH_C("lame_cbr.mp3"));
+    return paths;
+  }
+
+  // Reads the whole stream in blocks of blockSize.
+
+  ByteVector readAll(IOStream &stream, unsigned long blockSize)
+  {
+    ByteVector data;
+    stream.seek(0);
+    for(;;) {
+      const ByteVector block = stream.readBlock(blockSize);
+      if(block.isEmpty())
+        break;
+      data.append(block);
+    }
+    return data;
+  }
+}
+
+class TestPrefetchedFileStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestPrefetchedFileStream);
+  CPPUNIT_TEST(testDefaults);
+  CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testThreadPool);
+  CPPUNIT_TEST(testIOUring);
+  CPPUNIT_TEST(testReadOnly);
+  CPPUNIT_TEST(testFileRef);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testDefaults()
+  {
+    FilePrefetcher prefetcher;
+    CPPUNIT_ASSERT_EQUAL(65536U, prefetcher.headSize());
+    CPPUNIT_ASSERT_EQUAL(16384U, prefetcher.tailSize());
+    CPPUNIT_ASSERT_EQUAL(64U, prefetcher.queueDepth());
+    CPPUNIT_ASSERT_EQUAL(FilePrefetcher::Automatic, prefetcher.backend());
+
+    prefetcher.setQueueDepth(0);
+    CPPUNIT_ASSERT_EQUAL(1U, prefetcher.queueDepth());
+
+    CPPUNIT_ASSERT(prefetcher.open(StringList()).isEmpty());
+  }
+
+  void testReadBlock()
+  {
+    FilePrefetcher prefetcher;
+    prefetcher.setHeadSize(1024);
+    prefetcher.setTailSize(512);
+
+    List<PrefetchedFileStream *> streams =
+      prefetcher.open(StringList(TEST_FILE_PATH_C("lame_cbr.mp3")));
+    streams.setAutoDelete(true);
+    CPPUNIT_ASSERT_EQUAL(1U, streams.size());
+
+    PrefetchedFileStream *stream = streams.front();
+    FileStream file(TEST_FILE_PATH_C("lame_cbr.mp3"), true);
+    CPPUNIT_ASSERT(stream->isOpen());
+    CPPUNIT_ASSERT_EQUAL(file.length(), stream->length());
+
+    // The head and the tail are read from memory.
+
+    stream->seek(100);
+    file.seek(100);
+    CPPUNIT_ASSERT_EQUAL(file.readBlock(900), stream->readBlock(900));
+    stream->seek(-128, IOStream::End);
+    file.seek(-128, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(file.readBlock(128), stream->readBlock(128));
+    CPPUNIT_ASSERT_EQUAL(file.length(), stream->tell());
+    CPPUNIT_ASSERT(stream->readBlock(16).isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0U, stream->missedReads());
+
+    // The rest is read from the file.
+
+    CPPUNIT_ASSERT_EQUAL(readAll(file, 1000), readAll(*stream, 1000));
+    CPPUNIT_ASSERT(stream->missedReads() > 0);
+  }
+
+  void testThreadPool()
+  {
+    checkBackend(FilePrefetcher::ThreadPool);
+  }
+
+  void testIOUring()
+  {
+    // Falls back to the thread pool where io_uring is not available.
+    checkBackend(FilePrefetcher::IOUring);
+  }
+
+  void testReadOnly()
+  {
+    List<PrefetchedFileStream *> streams =
+      FilePrefetcher().open(StringList(TEST_FILE_PATH_C("empty.ogg")));
+    streams.setAutoDelete(true);
+
+    PrefetchedFileStream *stream = streams.front();
+    CPPUNIT_ASSERT(stream->readOnly());
+
+    const ByteVector data = readAll(*stream, 4096);
+    stream->seek(0);
+    stream->writeBlock("xxxx");
+    stream->insert("yyyy", 8, 0);
+    stream->removeBlock(0, 4);
+    stream->truncate(4);
+    CPPUNIT_ASSERT_EQUAL(data, readAll(*stream, 4096));
+  }
+
+  void testFileRef()
+  {
+    List<PrefetchedFileStream *> streams =
+      FilePrefetcher().open(StringList(TEST_FILE_PATH_C("has-tags.m4a")));
+    streams.setAutoDelete(true);
+
+    FileStream file(TEST_FILE_PATH_C("has-tags.m4a"), true);
+    FileRef prefetched(streams.front());
+    FileRef opened(&file);
+    CPPUNIT_ASSERT(!prefetched.isNull());
+    CPPUNIT_ASSERT(prefetched.file()->readOnly());
+    CPPUNIT_ASSERT_EQUAL(opened.tag()->title(), prefetched.tag()->title());
+    CPPUNIT_ASSERT(opened.file()->properties() == prefetched.file()->properties());
+    CPPUNIT_ASSERT_EQUAL(opened.audioProperties()->lengthInMilliseconds(),
+                         prefetched.audioProperties()->lengthInMilliseconds());
+  }
+
+private:
+
+  void checkBackend(FilePrefetcher::Backend backend)
+  {
+    const StringList paths = testFiles();
+
+    FilePrefetcher prefetcher;
+    prefetcher.setBackend(backend);
+    prefetcher.setQueueDepth(2);
+
+    List<PrefetchedFileStream *> streams = prefetcher.open(paths);
+    streams.setAutoDelete(true);
+    CPPUNIT_ASSERT_EQUAL(paths.size(), streams.size());
+
+    StringList::ConstIterator path = paths.begin();
+    for(List<PrefetchedFileStream *>::ConstIterator it = streams.begin();
+        it != streams.end(); ++it, ++path) {
+      CPPUNIT_ASSERT_EQUAL(string(path->toCString()), string((*it)->name()));
+
+      FileStream file(path->toCString(), true);
+      CPPUNIT_ASSERT_EQUAL(file.isOpen(), (*it)->isOpen());
+      if(file.isOpen())
+        CPPUNIT_ASSERT_EQUAL(readAll(file, 4096), readAll(**it, 4096));
+    }
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestPrefetchedFileStream);
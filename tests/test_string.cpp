@@ -25,11 +25,21 @@
 
 #include <tstring.h>
 #include <string.h>
+#include <thread>
+#include <vector>
 #include <cppunit/extensions/HelperMacros.h>
 
 using namespace std;
 using namespace TagLib;
 
+namespace
+{
+  void convertToUTF8(const String *s, ByteVector *result)
+  {
+    *result = s->data(String::UTF8);
+  }
+}
+
 class TestString : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestString);
@@ -52,6 +62,8 @@ class TestString : public CppUnit::TestFixture
   CPPUNIT_TEST(testEncodeNonBMP);
   CPPUNIT_TEST(testIterator);
   CPPUNIT_TEST(testInvalidUTF8);
+  CPPUNIT_TEST(testUTF8AfterChange);
+  CPPUNIT_TEST(testUTF8Cache);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -366,6 +378,69 @@ public:
     CPPUNIT_ASSERT(String(ByteVector("\xED\xB0\x80\xED\xA0\x80"), String::UTF8).isEmpty());
   }
 
+  void testUTF8AfterChange()
+  {
+    String s("Jos\xC3\xA9", String::UTF8);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("Jos\xC3\xA9"), s.data(String::UTF8));
+    CPPUNIT_ASSERT_EQUAL(std::string("Jos\xC3\xA9"), s.to8Bit(true));
+
+    // Modifying the string or a copy of it must not return stale data.
+
+    String copy = s;
+    copy += " Carlos";
+    CPPUNIT_ASSERT_EQUAL(ByteVector("Jos\xC3\xA9 Carlos"), copy.data(String::UTF8));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("Jos\xC3\xA9"), s.data(String::UTF8));
+
+    s[0] = L'j';
+    CPPUNIT_ASSERT_EQUAL(std::string("jos\xC3\xA9"), s.to8Bit(true));
+    CPPUNIT_ASSERT(strcmp(s.toCString(true), "jos\xC3\xA9") == 0);
+
+    s.append(String(L"\u3042"));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("jos\xC3\xA9\xE3\x81\x82"), s.data(String::UTF8));
+
+    // Modifying the returned data does not affect the string.
+
+    ByteVector v = s.data(String::UTF8);
+    v[0] = 'J';
+    CPPUNIT_ASSERT_EQUAL(ByteVector("jos\xC3\xA9\xE3\x81\x82"), s.data(String::UTF8));
+
+    // Nor does writing through an iterator taken before.
+
+    String::Iterator it = s.begin();
+    CPPUNIT_ASSERT_EQUAL(ByteVector("jos\xC3\xA9\xE3\x81\x82"), s.data(String::UTF8));
+    *it = L'J';
+    CPPUNIT_ASSERT_EQUAL(ByteVector("Jos\xC3\xA9\xE3\x81\x82"), s.data(String::UTF8));
+  }
+
+  void testUTF8Cache()
+  {
+    const String s("Jos\xC3\xA9 Carlos", String::UTF8);
+    const String copy = s;
+
+    // The copies share the converted data.
+
+    const ByteVector v1 = s.data(String::UTF8);
+    const ByteVector v2 = copy.data(String::UTF8);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("Jos\xC3\xA9 Carlos"), v1);
+    CPPUNIT_ASSERT(v1.data() == v2.data());
+
+    // Copies of one string may be converted in several threads at once.
+
+    std::vector<String> strings(4, String("Jos\xC3\xA9 Carlos", String::UTF8));
+    std::vector<ByteVector> results(strings.size());
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < strings.size(); ++i)
+      threads.push_back(std::thread(convertToUTF8, &strings[i], &results[i]));
+    for(size_t i = 0; i < threads.size(); ++i)
+      threads[i].join();
+
+    const std::vector<ByteVector> &converted = results;
+    for(size_t i = 0; i < converted.size(); ++i) {
+      CPPUNIT_ASSERT_EQUAL(ByteVector("Jos\xC3\xA9 Carlos"), converted[i]);
+      CPPUNIT_ASSERT(converted[i].data() == converted[0].data());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestString);
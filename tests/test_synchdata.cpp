@@ -42,6 +42,7 @@ class TestID3v2SynchData : public CppUnit::TestFixture
   CPPUNIT_TEST(testDecode2);
   CPPUNIT_TEST(testDecode3);
   CPPUNIT_TEST(testDecode4);
+  CPPUNIT_TEST(testDecodeLong);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -122,6 +123,39 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector("\xff\xff\xff", 3), a);
   }
 
+  void testDecodeLong()
+  {
+    // Pairs at the ends of and across the blocks which are searched at once.
+
+    const unsigned int positions[] = { 0, 14, 16, 31, 33, 47, 60, 98 };
+
+    ByteVector a(100, 'x');
+    ByteVector expected;
+    unsigned int next = 0;
+    for(unsigned int i = 0; i < a.size(); ++i) {
+      if(next < sizeof(positions) / sizeof(positions[0]) && i == positions[next]) {
+        a[i] = '\xff';
+        a[i + 1] = '\x00';
+        expected.append('\xff');
+        ++i;
+        ++next;
+      }
+      else {
+        expected.append('x');
+      }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(expected, ID3v2::SynchData::decode(a));
+    CPPUNIT_ASSERT_EQUAL(expected, ID3v2::SynchData::decode(expected));
+
+    CPPUNIT_ASSERT_EQUAL(92U, expected.size());
+    a[99] = '\xff';
+    expected.append('\xff');
+    CPPUNIT_ASSERT_EQUAL(expected, ID3v2::SynchData::decode(a));
+
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), ID3v2::SynchData::decode(ByteVector()));
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestID3v2SynchData);
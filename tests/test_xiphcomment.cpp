@@ -28,6 +28,7 @@
 #include <xiphcomment.h>
 #include <vorbisfile.h>
 #include <tpropertymap.h>
+#include <tbytevectorlist.h>
 #include <tdebug.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -48,6 +49,8 @@ class TestXiphComment : public CppUnit::TestFixture
   CPPUNIT_TEST(testRemoveFields);
   CPPUNIT_TEST(testPicture);
   CPPUNIT_TEST(testLowercaseFields);
+  CPPUNIT_TEST(testDeferredPictures);
+  CPPUNIT_TEST(testDeferredPictureOrder);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -210,6 +213,89 @@ public:
     }
   }
 
+  void testDeferredPictures()
+  {
+    ByteVector data;
+    {
+      Ogg::XiphComment cmt;
+      cmt.setTitle("Title");
+      for(int i = 0; i < 2; ++i) {
+        FLAC::Picture *picture = new FLAC::Picture();
+        picture->setType(i == 0 ? FLAC::Picture::FrontCover : FLAC::Picture::BackCover);
+        picture->setMimeType("image/png");
+        picture->setData(ByteVector(1000, static_cast<char>('a' + i)));
+        cmt.addPicture(picture);
+      }
+      data = cmt.render();
+    }
+
+    Ogg::XiphComment cmt(data);
+    CPPUNIT_ASSERT_EQUAL(String("Title"), cmt.title());
+    CPPUNIT_ASSERT_EQUAL(3U, cmt.fieldCount());
+    CPPUNIT_ASSERT_EQUAL(data, cmt.render());
+
+    FLAC::Picture *picture = new FLAC::Picture();
+    picture->setType(FLAC::Picture::Artist);
+    cmt.addPicture(picture);
+    CPPUNIT_ASSERT_EQUAL(4U, cmt.fieldCount());
+
+    const List<FLAC::Picture *> pictures = cmt.pictureList();
+    CPPUNIT_ASSERT_EQUAL(3U, pictures.size());
+    CPPUNIT_ASSERT_EQUAL(FLAC::Picture::FrontCover, pictures[0]->type());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(1000, 'a'), pictures[0]->data());
+    CPPUNIT_ASSERT_EQUAL(FLAC::Picture::BackCover, pictures[1]->type());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(1000, 'b'), pictures[1]->data());
+    CPPUNIT_ASSERT_EQUAL(FLAC::Picture::Artist, pictures[2]->type());
+    CPPUNIT_ASSERT_EQUAL(4U, cmt.fieldCount());
+
+    cmt.removeAllPictures();
+    CPPUNIT_ASSERT_EQUAL(1U, cmt.fieldCount());
+  }
+
+  void testDeferredPictureOrder()
+  {
+    FLAC::Picture front;
+    front.setType(FLAC::Picture::FrontCover);
+    front.setMimeType("image/png");
+    front.setData(ByteVector(100, 'a'));
+
+    FLAC::Picture back;
+    back.setType(FLAC::Picture::BackCover);
+    back.setMimeType("image/png");
+    back.setData(ByteVector(100, 'b'));
+
+    ByteVectorList fields;
+    fields.append(ByteVector("METADATA_BLOCK_PICTURE=") + front.render().toBase64());
+    fields.append(ByteVector("COVERART=") + ByteVector(100, 'c').toBase64());
+    fields.append(ByteVector("METADATA_BLOCK_PICTURE=") + back.render().toBase64());
+    fields.append("METADATA_BLOCK_PICTURE=@@@@");
+    fields.append("COVERART=YWJj=");
+
+    ByteVector data = ByteVector::fromUInt(6U, false);
+    data.append("vendor");
+    data.append(ByteVector::fromUInt(fields.size(), false));
+    for(ByteVectorList::ConstIterator it = fields.begin(); it != fields.end(); ++it) {
+      data.append(ByteVector::fromUInt(it->size(), false));
+      data.append(*it);
+    }
+    data.append('\x01');
+
+    Ogg::XiphComment cmt(data);
+    CPPUNIT_ASSERT_EQUAL(3U, cmt.fieldCount());
+
+    const ByteVector rendered = cmt.render();
+    CPPUNIT_ASSERT_EQUAL(3U, rendered.toUInt(10U, false));
+    CPPUNIT_ASSERT(rendered.find("@@@@") == -1);
+
+    const List<FLAC::Picture *> pictures = cmt.pictureList();
+    CPPUNIT_ASSERT_EQUAL(3U, pictures.size());
+    CPPUNIT_ASSERT_EQUAL(FLAC::Picture::FrontCover, pictures[0]->type());
+    CPPUNIT_ASSERT_EQUAL(FLAC::Picture::Other, pictures[1]->type());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(100, 'c'), pictures[1]->data());
+    CPPUNIT_ASSERT_EQUAL(FLAC::Picture::BackCover, pictures[2]->type());
+    CPPUNIT_ASSERT_EQUAL(rendered, cmt.render());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestXiphComment);